@@ -52,9 +52,9 @@ uint64_t RngSeedManager::GetRun ()
 uint64_t RngSeedManager::GetNextStreamIndex (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  uint64_t next = g_nextStreamIndex;
-  g_nextStreamIndex++;
-  return next;
+  // stream indexes can be requested by events that are executed in parallel
+  // (see MultithreadedSimulatorImpl)
+  return __sync_fetch_and_add (&g_nextStreamIndex, 1);
 }
 
 } // namespace ns3
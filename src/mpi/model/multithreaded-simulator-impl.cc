@@ -0,0 +1,874 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/make-event.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/nstime.h"
+#include "ns3/uinteger.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+
+#include <algorithm>
+#include <queue>
+#include <sched.h>
+#include <unistd.h>
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+const uint64_t INFINITE_TS = ~static_cast<uint64_t> (0);
+
+/**
+ * Simulator that has been partitioned (IsRemoteContext is always false when 0)
+ */
+MultithreadedSimulatorImpl *g_partitioned = 0;
+
+/**
+ * Delay of the point-to-point channel, or 0 if events of nodes attached to the channel
+ * can affect each other without delay
+ */
+uint64_t
+GetChannelLookAhead (Ptr<Channel> channel)
+{
+  if (channel->GetNDevices () != 2)
+    {
+      return 0;
+    }
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<NetDevice> device = channel->GetDevice (i);
+      if (device == 0 || !device->IsPointToPoint () || device->GetNode () == 0)
+        {
+          return 0;
+        }
+    }
+
+  TimeValue delay;
+  if (!channel->GetAttributeFailSafe ("Delay", delay) || !delay.Get ().IsStrictlyPositive ())
+    {
+      return 0;
+    }
+  return delay.Get ().GetTimeStep ();
+}
+
+uint32_t
+FindGroup (std::vector<uint32_t> &groups, uint32_t node)
+{
+  while (groups[node] != node)
+    {
+      groups[node] = groups[groups[node]];
+      node = groups[node];
+    }
+  return node;
+}
+
+} // namespace
+
+__thread MultithreadedSimulatorImpl::Partition *MultithreadedSimulatorImpl::m_current = 0;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("ThreadCount",
+                   "Number of threads (0 to use all online processors)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_threadCount),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::Partition::Partition (uint32_t index)
+  : m_index (index),
+    // uids are allocated from 4.
+    // uid 0 is "invalid" events
+    // uid 1 is "now" events
+    // uid 2 is "destroy" events
+    m_uid (4),
+    // before ::Run is entered, the m_currentUid will be zero
+    m_currentUid (0),
+    m_currentTs (0),
+    m_currentContext (0xffffffff),
+    m_unscheduledEvents (0),
+    m_next (INFINITE_TS),
+    m_bound (0)
+{
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+{
+#ifndef HAVE_PTHREAD_H
+  NS_FATAL_ERROR ("Can't use multithreaded simulator without threading support compiled in");
+#endif
+
+  m_stop = false;
+  m_threadCount = 0;
+  m_global = new Partition (0);
+  m_globalNext = INFINITE_TS;
+  m_barrierCount = 0;
+  m_barrierSense = false;
+  m_current = m_global;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      delete m_partitions[i];
+    }
+  delete m_global;
+  if (m_current == m_global)
+    {
+      m_current = 0;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  std::vector<Partition *> partitions = m_partitions;
+  partitions.push_back (m_global);
+  for (uint32_t i = 0; i < partitions.size (); i++)
+    {
+      Partition *partition = partitions[i];
+      while (!partition->m_events->IsEmpty ())
+        {
+          Scheduler::Event next = partition->m_events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      partition->m_events = 0;
+      for (uint32_t j = 0; j < partition->m_inbox.size (); j++)
+        {
+          for (uint32_t k = 0; k < partition->m_inbox[j].size (); k++)
+            {
+              partition->m_inbox[j][k].m_impl->Unref ();
+            }
+          partition->m_inbox[j].clear ();
+        }
+    }
+  if (g_partitioned == this)
+    {
+      g_partitioned = 0;
+    }
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  std::vector<Partition *> partitions;
+  partitions.push_back (m_global);
+  partitions.insert (partitions.end (), m_partitions.begin (), m_partitions.end ());
+  for (uint32_t i = 0; i < partitions.size (); i++)
+    {
+      DestroyEvents &destroyEvents = partitions[i]->m_destroyEvents;
+      while (!destroyEvents.empty ())
+        {
+          Ptr<EventImpl> ev = destroyEvents.front ().PeekEventImpl ();
+          destroyEvents.pop_front ();
+          NS_LOG_LOGIC ("handle destroy " << ev);
+          if (!ev->IsCancelled ())
+            {
+              ev->Invoke ();
+            }
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  m_schedulerFactory = schedulerFactory;
+
+  std::vector<Partition *> partitions = m_partitions;
+  partitions.push_back (m_global);
+  for (uint32_t i = 0; i < partitions.size (); i++)
+    {
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if (partitions[i]->m_events != 0)
+        {
+          while (!partitions[i]->m_events->IsEmpty ())
+            {
+              Scheduler::Event next = partitions[i]->m_events->RemoveNext ();
+              scheduler->Insert (next);
+            }
+        }
+      partitions[i]->m_events = scheduler;
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetThreadCount (void) const
+{
+  if (m_threadCount > 0)
+    {
+      return m_threadCount;
+    }
+
+  long processors = sysconf (_SC_NPROCESSORS_ONLN);
+  return processors > 0 ? processors : 1;
+}
+
+void
+MultithreadedSimulatorImpl::CreatePartitions (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // nodes that can affect each other without delay should be in the same partition
+  uint32_t nNodes = NodeList::GetNNodes ();
+  std::vector<uint32_t> groups (nNodes);
+  for (uint32_t node = 0; node < nNodes; node++)
+    {
+      groups[node] = node;
+    }
+
+  std::vector< std::pair<uint32_t, uint32_t> > links;
+  for (ChannelList::Iterator channel = ChannelList::Begin (); channel != ChannelList::End (); channel++)
+    {
+      std::vector<uint32_t> nodes;
+      for (uint32_t i = 0; i < (*channel)->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> device = (*channel)->GetDevice (i);
+          if (device != 0 && device->GetNode () != 0)
+            {
+              nodes.push_back (device->GetNode ()->GetId ());
+            }
+        }
+
+      if (GetChannelLookAhead (*channel) > 0)
+        {
+          links.push_back (std::make_pair (nodes[0], nodes[1]));
+          continue;
+        }
+      for (uint32_t i = 1; i < nodes.size (); i++)
+        {
+          groups[FindGroup (groups, nodes[i])] = FindGroup (groups, nodes[0]);
+        }
+    }
+
+  // order groups by breadth-first search, so neighbouring groups tend to get to the same partition
+  std::vector<uint32_t> groupSize (nNodes, 0);
+  std::vector< std::vector<uint32_t> > neighbours (nNodes);
+  for (uint32_t node = 0; node < nNodes; node++)
+    {
+      groupSize[FindGroup (groups, node)]++;
+    }
+  for (uint32_t i = 0; i < links.size (); i++)
+    {
+      uint32_t first = FindGroup (groups, links[i].first);
+      uint32_t second = FindGroup (groups, links[i].second);
+      neighbours[first].push_back (second);
+      neighbours[second].push_back (first);
+    }
+
+  std::vector<uint32_t> order;
+  std::vector<bool> visited (nNodes, false);
+  for (uint32_t node = 0; node < nNodes; node++)
+    {
+      uint32_t group = FindGroup (groups, node);
+      if (visited[group])
+        {
+          continue;
+        }
+      std::queue<uint32_t> queue;
+      queue.push (group);
+      visited[group] = true;
+      while (!queue.empty ())
+        {
+          group = queue.front ();
+          queue.pop ();
+          order.push_back (group);
+          for (uint32_t i = 0; i < neighbours[group].size (); i++)
+            {
+              if (!visited[neighbours[group][i]])
+                {
+                  visited[neighbours[group][i]] = true;
+                  queue.push (neighbours[group][i]);
+                }
+            }
+        }
+    }
+
+  // split the order into contiguous chunks with (roughly) the same number of nodes
+  uint32_t nThreads = std::max<uint32_t> (1, std::min<uint32_t> (GetThreadCount (), order.size ()));
+  std::vector<uint32_t> groupPartition (nNodes, 0);
+  uint32_t partition = 0;
+  uint64_t assigned = 0;
+  for (uint32_t i = 0; i < order.size (); i++)
+    {
+      if (partition + 1 < nThreads && assigned * nThreads >= static_cast<uint64_t> (partition + 1) * nNodes)
+        {
+          partition++;
+        }
+      groupPartition[order[i]] = partition;
+      assigned += groupSize[order[i]];
+    }
+
+  uint32_t nPartitions = partition + 1;
+  for (uint32_t i = 0; i < nPartitions; i++)
+    {
+      Partition *p = new Partition (i);
+      p->m_events = m_schedulerFactory.Create<Scheduler> ();
+      p->m_uid = m_global->m_uid;
+      p->m_currentTs = m_global->m_currentTs;
+      p->m_bound = m_global->m_currentTs;
+      p->m_inbox.resize (nPartitions);
+      m_partitions.push_back (p);
+    }
+  m_global->m_inbox.resize (nPartitions);
+  m_partitionOf.resize (nNodes);
+  for (uint32_t node = 0; node < nNodes; node++)
+    {
+      m_partitionOf[node] = groupPartition[FindGroup (groups, node)];
+    }
+  NS_LOG_INFO (nNodes << " nodes in " << nPartitions << " partitions");
+
+  // move events of nodes to their partitions (uids are kept, so event IDs remain valid)
+  std::vector<Scheduler::Event> events;
+  while (!m_global->m_events->IsEmpty ())
+    {
+      events.push_back (m_global->m_events->RemoveNext ());
+    }
+  for (std::vector<Scheduler::Event>::iterator event = events.begin (); event != events.end (); event++)
+    {
+      Partition *target = GetPartition (event->key.m_context);
+      target->m_events->Insert (*event);
+      target->m_unscheduledEvents++;
+      m_global->m_unscheduledEvents--;
+    }
+
+  g_partitioned = this;
+}
+
+void
+MultithreadedSimulatorImpl::CalculateLookAhead (void)
+{
+  uint32_t nPartitions = m_partitions.size ();
+  m_lookAhead.assign (nPartitions * nPartitions, INFINITE_TS);
+  for (ChannelList::Iterator channel = ChannelList::Begin (); channel != ChannelList::End (); channel++)
+    {
+      uint64_t lookAhead = GetChannelLookAhead (*channel);
+      if (lookAhead == 0)
+        {
+          continue;
+        }
+      uint32_t first = (*channel)->GetDevice (0)->GetNode ()->GetId ();
+      uint32_t second = (*channel)->GetDevice (1)->GetNode ()->GetId ();
+      if (first >= m_partitionOf.size () || second >= m_partitionOf.size ()
+          || m_partitionOf[first] == m_partitionOf[second])
+        {
+          continue;
+        }
+
+      uint64_t &forward = m_lookAhead[m_partitionOf[first] * nPartitions + m_partitionOf[second]];
+      uint64_t &backward = m_lookAhead[m_partitionOf[second] * nPartitions + m_partitionOf[first]];
+      forward = std::min (forward, lookAhead);
+      backward = std::min (backward, lookAhead);
+    }
+
+  // an event can reach another partition through any chain of events of other partitions
+  // (e.g., a packet echoed by an idle partition), so lookahead is the shortest path
+  // (Floyd-Warshall); the lookahead of a partition to itself is the shortest cycle
+  for (uint32_t k = 0; k < nPartitions; k++)
+    {
+      for (uint32_t i = 0; i < nPartitions; i++)
+        {
+          uint64_t toK = m_lookAhead[i * nPartitions + k];
+          if (toK == INFINITE_TS)
+            {
+              continue;
+            }
+          for (uint32_t j = 0; j < nPartitions; j++)
+            {
+              uint64_t fromK = m_lookAhead[k * nPartitions + j];
+              if (fromK != INFINITE_TS)
+                {
+                  m_lookAhead[i * nPartitions + j] = std::min (m_lookAhead[i * nPartitions + j], toK + fromK);
+                }
+            }
+        }
+    }
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context < m_partitionOf.size ())
+    {
+      return m_partitions[m_partitionOf[context]];
+    }
+  return m_global;
+}
+
+bool
+MultithreadedSimulatorImpl::IsRemoteContext (uint32_t context)
+{
+  return g_partitioned != 0 && g_partitioned->GetPartition (context) != m_current;
+}
+
+void
+MultithreadedSimulatorImpl::Insert (Partition *partition, uint64_t ts, uint32_t context, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = partition->m_uid;
+  partition->m_uid++;
+  partition->m_unscheduledEvents++;
+  partition->m_events->Insert (ev);
+}
+
+void
+MultithreadedSimulatorImpl::ReceiveMessages (Partition *partition)
+{
+  for (uint32_t sender = 0; sender < partition->m_inbox.size (); sender++)
+    {
+      std::vector<Message> &messages = partition->m_inbox[sender];
+      for (std::vector<Message>::iterator message = messages.begin (); message != messages.end (); message++)
+        {
+          if (message->m_ts < partition->m_bound)
+            {
+              NS_FATAL_ERROR ("Event for node " << message->m_context << " is scheduled at "
+                              << TimeStep (message->m_ts) << ", but the partition of the node has already reached "
+                              << TimeStep (partition->m_bound) << " (nodes should interact only over point-to-point "
+                              "channels, whose delays should not decrease during the simulation)");
+            }
+          Insert (partition, message->m_ts, message->m_context, message->m_impl);
+        }
+      messages.clear ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (Partition *partition)
+{
+  Scheduler::Event next = partition->m_events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= partition->m_currentTs);
+  partition->m_unscheduledEvents--;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  partition->m_currentTs = next.key.m_ts;
+  partition->m_currentContext = next.key.m_context;
+  partition->m_currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessEvents (Partition *partition, uint64_t window)
+{
+  m_current = partition;
+  while (!partition->m_events->IsEmpty ()
+         && partition->m_events->PeekNext ().key.m_ts < window)
+    {
+      ProcessOneEvent (partition);
+    }
+  partition->m_bound = window;
+  m_current = partition->m_index == 0 ? m_global : partition;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessGlobalEvents (uint64_t ts)
+{
+  // other threads are waiting, so these events can schedule events for any node directly
+  while (!m_global->m_events->IsEmpty ()
+         && m_global->m_events->PeekNext ().key.m_ts == ts
+         && !m_stop)
+    {
+      ProcessOneEvent (m_global);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Barrier (bool &sense)
+{
+  sense = !sense;
+  if (__sync_add_and_fetch (&m_barrierCount, 1) == m_partitions.size ())
+    {
+      m_barrierCount = 0;
+      __sync_synchronize ();
+      m_barrierSense = sense;
+      return;
+    }
+
+  uint32_t spins = 0;
+  while (m_barrierSense != sense)
+    {
+      if (++spins > 1000)
+        {
+          sched_yield ();
+        }
+    }
+  __sync_synchronize ();
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (uint32_t index)
+{
+  Partition *partition = m_partitions[index];
+  uint32_t nPartitions = m_partitions.size ();
+  m_current = index == 0 ? m_global : partition;
+
+  bool sense = false;
+  while (true)
+    {
+      // events from the previous round are scheduled, and the next timestamps are published
+      ReceiveMessages (partition);
+      partition->m_next = partition->m_events->IsEmpty () ? INFINITE_TS : partition->m_events->PeekNext ().key.m_ts;
+      if (index == 0)
+        {
+          ReceiveMessages (m_global);
+          m_globalNext = m_global->m_events->IsEmpty () ? INFINITE_TS : m_global->m_events->PeekNext ().key.m_ts;
+        }
+      // m_stop can be changed only by events without context, which are executed while
+      // other threads wait, so all threads make the same decision
+      bool stop = m_stop;
+      Barrier (sense);
+
+      uint64_t next = INFINITE_TS;
+      for (uint32_t i = 0; i < nPartitions; i++)
+        {
+          next = std::min (next, m_partitions[i]->m_next);
+        }
+      if (stop || (next == INFINITE_TS && m_globalNext == INFINITE_TS))
+        {
+          break;
+        }
+
+      if (m_globalNext <= next)
+        {
+          if (index == 0)
+            {
+              ProcessGlobalEvents (m_globalNext);
+            }
+        }
+      else
+        {
+          uint64_t window = m_globalNext;
+          for (uint32_t i = 0; i < nPartitions; i++)
+            {
+              uint64_t lookAhead = m_lookAhead[i * nPartitions + index];
+              if (m_partitions[i]->m_next != INFINITE_TS && lookAhead != INFINITE_TS)
+                {
+                  window = std::min (window, m_partitions[i]->m_next + lookAhead);
+                }
+            }
+          ProcessEvents (partition, window);
+        }
+      Barrier (sense);
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  if (!m_global->m_events->IsEmpty ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      if (!m_partitions[i]->m_events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+#ifdef HAVE_PTHREAD_H
+  if (m_partitions.empty ())
+    {
+      CreatePartitions ();
+    }
+  CalculateLookAhead ();
+  m_stop = false;
+  m_barrierCount = 0;
+  m_barrierSense = false;
+
+  std::vector< Ptr<SystemThread> > threads;
+  for (uint32_t i = 1; i < m_partitions.size (); i++)
+    {
+      Callback<void, uint32_t> run = MakeCallback (&MultithreadedSimulatorImpl::RunPartition, this);
+      threads.push_back (Create<SystemThread> (run.Bind (i)));
+      threads.back ()->Start ();
+    }
+  RunPartition (0);
+  for (uint32_t i = 0; i < threads.size (); i++)
+    {
+      threads[i]->Join ();
+    }
+  m_current = m_global;
+
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      m_global->m_currentTs = std::max (m_global->m_currentTs, m_partitions[i]->m_currentTs);
+    }
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      NS_ASSERT (!m_partitions[i]->m_events->IsEmpty () || m_partitions[i]->m_unscheduledEvents == 0);
+    }
+#else
+  NS_FATAL_ERROR ("Can't use multithreaded simulator without threading support compiled in");
+#endif
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId () const
+{
+  return 0;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  if (m_current == m_global)
+    {
+      m_stop = true;
+    }
+  else
+    {
+      ScheduleStop (m_current->m_currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &time)
+{
+  ScheduleStop (m_current->m_currentTs + time.GetTimeStep ());
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleStop (uint64_t ts)
+{
+  Partition *partition = m_current;
+  EventImpl *event = MakeEvent (&Simulator::Stop);
+  if (partition == m_global)
+    {
+      Insert (m_global, ts, 0xffffffff, event);
+    }
+  else
+    {
+      // node events run in parallel, so they stop the simulation with an event without context
+      m_global->m_inbox[partition->m_index].push_back (Message (ts, 0xffffffff, event));
+    }
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+  Partition *partition = m_current;
+  Time tAbsolute = time + TimeStep (partition->m_currentTs);
+
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (partition->m_currentTs));
+  uint32_t uid = partition->m_uid;
+  Insert (partition, static_cast<uint64_t> (tAbsolute.GetTimeStep ()), partition->m_currentContext, event);
+  return EventId (event, tAbsolute.GetTimeStep (), partition->m_currentContext, uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << time.GetTimeStep () << event);
+
+  Partition *partition = m_current;
+  Partition *target = GetPartition (context);
+  uint64_t ts = partition->m_currentTs + time.GetTimeStep ();
+  if (target == partition || partition == m_global)
+    {
+      // events without context are executed while other threads wait
+      Insert (target, ts, context, event);
+    }
+  else if (target == m_global)
+    {
+      NS_FATAL_ERROR ("Node " << partition->m_currentContext << " can't schedule event for context " << context
+                      << " (nodes should be created before Simulator::Run)");
+    }
+  else
+    {
+      target->m_inbox[partition->m_index].push_back (Message (ts, context, event));
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  Partition *partition = m_current;
+  uint32_t uid = partition->m_uid;
+  Insert (partition, partition->m_currentTs, partition->m_currentContext, event);
+  return EventId (event, partition->m_currentTs, partition->m_currentContext, uid);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  // destroy events are kept by the partition of the scheduling event, so no locking is needed
+  Partition *partition = m_current;
+  EventId id (Ptr<EventImpl> (event, false), partition->m_currentTs, partition->m_currentContext, 2);
+  partition->m_destroyEvents.push_back (id);
+  partition->m_uid++;
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  return TimeStep (m_current->m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetPartition (id.GetContext ())->m_currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  Partition *partition = GetPartition (id.GetContext ());
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      for (DestroyEvents::iterator i = partition->m_destroyEvents.begin (); i != partition->m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              partition->m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition->m_events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  partition->m_unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &ev) const
+{
+  Partition *partition = GetPartition (ev.GetContext ());
+  if (ev.GetUid () == 2)
+    {
+      if (ev.PeekEventImpl () == 0
+          || ev.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      for (DestroyEvents::const_iterator i = partition->m_destroyEvents.begin (); i != partition->m_destroyEvents.end (); i++)
+        {
+          if (*i == ev)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  if (ev.PeekEventImpl () == 0
+      || ev.GetTs () < partition->m_currentTs
+      || (ev.GetTs () == partition->m_currentTs
+          && ev.GetUid () <= partition->m_currentUid)
+      || ev.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  /// \todo I am fairly certain other compilers use other non-standard
+  /// post-fixes to indicate 64 bit constants.
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return m_current->m_currentContext;
+}
+
+} // namespace ns3
@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/ptr.h"
+
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \ingroup mpi
+ *
+ * \brief Conservative parallel simulator implementation for shared-memory machines
+ *
+ * Nodes are partitioned between threads when Simulator::Run is called for the first
+ * time, and events are assigned to partitions by their context (node ID).  Nodes that
+ * are connected by channels other than point-to-point channels with a positive delay
+ * always belong to the same partition.  Events without context (e.g., events
+ * scheduled before Simulator::Run with Simulator::Schedule) are executed by the main
+ * thread, while all other threads wait.
+ *
+ * Threads advance in rounds.  In every round a partition executes events that cannot
+ * be affected by events of other partitions, i.e., events that are earlier than the
+ * next event of every partition plus the lookahead from it (the shortest path over the
+ * smallest delays of point-to-point channels between partitions, or the shortest cycle
+ * for the partition itself), and earlier than the next event without context.  Events
+ * that are scheduled for nodes of other partitions are put to per-sender inboxes of the
+ * receiving partition (no locks are needed, as rounds are separated by barriers) and are
+ * scheduled by the receiver at the beginning of the next round in the order of senders,
+ * so simulation results do not depend on thread timing, unless random variables are
+ * created during the simulation.  Simulator::Stop
+ * called by a node event schedules a stop event without context at the same time, so
+ * the simulation stops at the round barrier after all partitions have reached it.
+ *
+ * Models should not share mutable state (including reference-counted objects) between
+ * nodes of different partitions, except through events scheduled with
+ * Simulator::ScheduleWithContext.  PointToPointChannel hands over a full copy of the
+ * packet when the receiver belongs to another partition (see IsRemoteContext).  Byte
+ * tags are not supported, and nodes should be created before the first call to
+ * Simulator::Run.
+ *
+ * Number of threads is controlled by the ThreadCount attribute:
+ *
+ * \code
+ *   GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+ *   Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (16));
+ * \endcode
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  static TypeId GetTypeId (void);
+
+  MultithreadedSimulatorImpl ();
+  ~MultithreadedSimulatorImpl ();
+
+  // virtual from SimulatorImpl
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &time);
+  virtual EventId Schedule (Time const &time, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &ev);
+  virtual void Cancel (const EventId &ev);
+  virtual bool IsExpired (const EventId &ev) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * \brief Check if events of the context can be executed by another thread than the current event
+   *
+   * Objects that are passed to such events should not share reference-counted data with
+   * objects of the current node.
+   *
+   * \param context context (node ID) of the event
+   * \return false if the multithreaded simulator is not in use
+   */
+  static bool IsRemoteContext (uint32_t context);
+
+private:
+  /**
+   * \brief Event that is scheduled for a node of another partition
+   */
+  struct Message
+  {
+    Message (uint64_t ts, uint32_t context, EventImpl *impl)
+      : m_ts (ts),
+        m_context (context),
+        m_impl (impl)
+    {
+    }
+
+    uint64_t m_ts;
+    uint32_t m_context;
+    EventImpl *m_impl;
+  };
+
+  typedef std::list<EventId> DestroyEvents;
+
+  /**
+   * \brief Group of nodes whose events are executed by the same thread
+   */
+  struct Partition
+  {
+    Partition (uint32_t index);
+
+    uint32_t m_index;
+    Ptr<Scheduler> m_events;
+    DestroyEvents m_destroyEvents;
+    uint32_t m_uid;
+    uint32_t m_currentUid;
+    uint64_t m_currentTs;
+    uint32_t m_currentContext;
+    // number of events that have been inserted but not yet scheduled,
+    // not counting the "destroy" events; this is used for validation
+    int m_unscheduledEvents;
+    // timestamp of the next event, published at the beginning of every round
+    uint64_t m_next;
+    // all events earlier than this timestamp have been executed
+    uint64_t m_bound;
+    // events scheduled by other partitions during the round, by sender
+    std::vector< std::vector<Message> > m_inbox;
+  };
+
+  virtual void DoDispose (void);
+
+  void CreatePartitions (void);
+  void CalculateLookAhead (void);
+  Partition *GetPartition (uint32_t context) const;
+  void Insert (Partition *partition, uint64_t ts, uint32_t context, EventImpl *event);
+  void ReceiveMessages (Partition *partition);
+  void ProcessOneEvent (Partition *partition);
+  void ProcessEvents (Partition *partition, uint64_t window);
+  void ProcessGlobalEvents (uint64_t ts);
+  void ScheduleStop (uint64_t ts);
+  void RunPartition (uint32_t index);
+  void Barrier (bool &sense);
+  uint32_t GetThreadCount (void) const;
+
+  ObjectFactory m_schedulerFactory;
+  bool m_stop;
+  uint32_t m_threadCount;
+
+  Partition *m_global;                     // events without context, executed by the main thread
+                                           // (its inbox holds stop events of node partitions)
+  std::vector<Partition *> m_partitions;   // empty until the first Run
+  std::vector<uint32_t> m_partitionOf;     // partition of every node
+  std::vector<uint64_t> m_lookAhead;       // shortest lookahead path from partition i to partition j at [i * n + j]
+  uint64_t m_globalNext;                   // timestamp of the next event without context
+
+  volatile uint32_t m_barrierCount;
+  volatile bool m_barrierSense;
+
+  static __thread Partition *m_current;    // partition of the event executed by the thread
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -21,7 +21,6 @@
 #include "ns3/ndn-interest.h"
 #include "ns3/log.h"
 
-#include <boost/lexical_cast.hpp>
 
 NS_LOG_COMPONENT_DEFINE ("ndn.ConsumerWindowAIMD");
 
@@ -86,9 +85,8 @@ ConsumerWindowAIMD::AdjustWindowOnContentObject (const Ptr<const ContentObject>
 void
 ConsumerWindowAIMD::AdjustWindowOnNack (const Ptr<const Interest> &interest, Ptr<Packet> payload)
 {
-  uint32_t seq = boost::lexical_cast<uint32_t> (interest->GetName ().GetComponents ().back ());
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find (seq);
-  if (entry != m_seqLastDelay.end () && entry->time > m_last_decrease)
+  const SeqInfo *info = FindSeqInfo (GetSeqNum (interest->GetName ()));
+  if (info != 0 && info->retxCount > 0 && info->lastSent > m_last_decrease)
     {
       m_ssthresh = std::max<uint32_t> (2, m_inFlight / 2);
       m_window = m_ssthresh;
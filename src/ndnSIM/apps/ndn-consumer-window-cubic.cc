@@ -21,7 +21,6 @@
 #include "ns3/ndn-interest.h"
 #include "ns3/ndn-content-object.h"
 #include "ns3/simulator.h"
-#include <boost/lexical_cast.hpp>
 
 NS_LOG_COMPONENT_DEFINE ("ndn.ConsumerWindowCUBIC");
 
@@ -80,11 +79,10 @@ ConsumerWindowCUBIC::AdjustWindowOnContentObject (const Ptr<const ContentObject>
                                                        Ptr<Packet> payload)
 {
   // record minimum RTT in m_dMin
-  uint32_t seq = boost::lexical_cast<uint32_t> (contentObject->GetName ().GetComponents ().back ());
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find (seq);
-  if (entry != m_seqLastDelay.end ())
+  const SeqInfo *info = FindSeqInfo (GetSeqNum (contentObject->GetName ()));
+  if (info != 0 && info->retxCount > 0)
     {
-      Time rtt = Simulator::Now () - entry->time;
+      Time rtt = Simulator::Now () - info->lastSent;
       if (m_dMin == Seconds(0.0))
         m_dMin = rtt;
       else
@@ -132,9 +130,8 @@ ConsumerWindowCUBIC::AdjustWindowOnContentObject (const Ptr<const ContentObject>
 void
 ConsumerWindowCUBIC::AdjustWindowOnNack (const Ptr<const Interest> &interest, Ptr<Packet> payload)
 {
-  uint32_t seq = boost::lexical_cast<uint32_t> (interest->GetName ().GetComponents ().back ());
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find (seq);
-  if (entry != m_seqLastDelay.end () && entry->time > m_last_decrease)
+  const SeqInfo *info = FindSeqInfo (GetSeqNum (interest->GetName ()));
+  if (info != 0 && info->retxCount > 0 && info->lastSent > m_last_decrease)
     {
       m_epoch_start = Seconds(0.0);
 
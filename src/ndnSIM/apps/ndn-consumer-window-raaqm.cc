@@ -22,7 +22,6 @@
 #include "ns3/ndn-content-object.h"
 #include "ns3/simulator.h"
 #include "ns3/random-variable.h"
-#include <boost/lexical_cast.hpp>
 #include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("ndn.ConsumerWindowRAAQM");
@@ -101,32 +100,28 @@ ConsumerWindowRAAQM::AdjustWindowOnContentObject (const Ptr<const ContentObject>
     }
 
   // RTT
-  uint32_t seq = boost::lexical_cast<uint32_t> (contentObject->GetName ().GetComponents ().back ());
-  if (m_seqRetxCounts[seq] == 1) // ignore retransmitted interest/data pairs
+  const SeqInfo *info = FindSeqInfo (GetSeqNum (contentObject->GetName ()));
+  if (info != 0 && info->retxCount == 1) // ignore retransmitted interest/data pairs
     {
-      SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find (seq);
-      if (entry != m_seqLastDelay.end ())
+      Time cur_rtt = Simulator::Now () - info->lastSent;
+      m_rtt_samples.push_back(cur_rtt);
+      if (m_rtt_samples.size() >= m_rtt_sample_size)
         {
-          Time cur_rtt = Simulator::Now () - entry->time;
-          m_rtt_samples.push_back(cur_rtt);
-          if (m_rtt_samples.size() >= m_rtt_sample_size)
+          while (m_rtt_samples.size() > m_rtt_sample_size)
+            m_rtt_samples.pop_front();
+
+          Time min_rtt = *std::min_element(m_rtt_samples.begin(), m_rtt_samples.end());
+          Time max_rtt = *std::max_element(m_rtt_samples.begin(), m_rtt_samples.end());
+          NS_LOG_DEBUG ("cur_rtt: " << cur_rtt << ", min_rtt: " << min_rtt << ", max_rtt: " << max_rtt);
+
+          double p = m_p_min + (m_p_max - m_p_min) * ((cur_rtt - min_rtt).GetSeconds() / (max_rtt - min_rtt).GetSeconds());
+          NS_LOG_DEBUG ("window decrease probability: " << p);
+
+          UniformVariable r (0.0, 1.0);
+          if (r.GetValue () < p)
             {
-              while (m_rtt_samples.size() > m_rtt_sample_size)
-                m_rtt_samples.pop_front();
-
-              Time min_rtt = *std::min_element(m_rtt_samples.begin(), m_rtt_samples.end());
-              Time max_rtt = *std::max_element(m_rtt_samples.begin(), m_rtt_samples.end());
-              NS_LOG_DEBUG ("cur_rtt: " << cur_rtt << ", min_rtt: " << min_rtt << ", max_rtt: " << max_rtt);
-
-              double p = m_p_min + (m_p_max - m_p_min) * ((cur_rtt - min_rtt).GetSeconds() / (max_rtt - min_rtt).GetSeconds());
-              NS_LOG_DEBUG ("window decrease probability: " << p);
-
-              UniformVariable r (0.0, 1.0);
-              if (r.GetValue () < p)
-                {
-                  m_window = m_window * (1.0 - m_beta);
-                  m_ssthresh = m_window;
-                }
+              m_window = m_window * (1.0 - m_beta);
+              m_ssthresh = m_window;
             }
         }
     }
@@ -204,8 +204,8 @@ ConsumerWindow::OnTimeout (uint32_t sequenceNumber)
 {
   if (m_inFlight > static_cast<uint32_t> (0)) m_inFlight--;
 
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find (sequenceNumber);
-  if (entry != m_seqLastDelay.end () && entry->time > m_last_decrease)
+  const SeqInfo *info = FindSeqInfo (sequenceNumber);
+  if (info != 0 && info->retxCount > 0 && info->lastSent > m_last_decrease)
     {
       AdjustWindowOnTimeout (sequenceNumber);
       m_last_decrease = Simulator::Now();
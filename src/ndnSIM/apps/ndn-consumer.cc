@@ -36,7 +36,6 @@
 #include "ns3/ndnSIM/utils/ndn-rtt-mean-deviation.h"
 
 #include <boost/ref.hpp>
-#include <boost/lexical_cast.hpp>
 #include <boost/lambda/lambda.hpp>
 #include <boost/lambda/bind.hpp>
 
@@ -76,6 +75,12 @@ Consumer::GetTypeId (void)
                    MakeTimeAccessor (&Consumer::m_interestLifeTime),
                    MakeTimeChecker ())
 
+    .AddAttribute ("BinarySeqNum",
+                   "Append sequence number to the Interest name as a binary component (otherwise, as a decimal string)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Consumer::m_binarySeqNum),
+                   MakeBooleanChecker ())
+
     .AddAttribute ("RetxTimer",
                    "Timeout defining how frequent retransmission timeouts should be checked",
                    StringValue ("50ms"),
@@ -123,6 +128,9 @@ Consumer::Consumer ()
   , m_s (0.75)
   , m_randCompLenMax (0) // no random components to be added
   , m_randCompName () // No random components
+  , m_binarySeqNum (false)
+  , m_priority (Interest::PRIORITY0)
+  , m_pendingTimeouts (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
@@ -150,22 +158,9 @@ Consumer::SetNumberOfContents (uint32_t numOfContents)
     return;
 
   m_N = numOfContents;
+  m_zipf = 0; // distribution will be rebuilt on the next request
 
   NS_LOG_DEBUG (m_q << " and " << m_s << " and " << m_N);
-
-  m_Pcum = std::vector<double> (m_N + 1);
-
-  m_Pcum[0] = 0.0;
-  for (uint32_t i=1; i<=m_N; i++)
-    {
-      m_Pcum[i] = m_Pcum[i-1] + 1.0 / std::pow(i+m_q, m_s);
-    }
-
-  for (uint32_t i=1; i<=m_N; i++)
-    {
-      m_Pcum[i] = m_Pcum[i] / m_Pcum[m_N];
-      NS_LOG_LOGIC ("Cumulative probability [" << i << "]=" << m_Pcum[i]);
-  }
 }
 
 uint32_t
@@ -237,13 +232,20 @@ Consumer::CheckRetxTimeout ()
 
   while (!m_seqTimeouts.empty ())
     {
-      SeqTimeoutsContainer::index<i_timestamp>::type::iterator entry =
-        m_seqTimeouts.get<i_timestamp> ().begin ();
-      if (entry->time + rto <= now) // timeout expired?
+      SeqTimeout entry = m_seqTimeouts.front ();
+
+      SeqInfo *info = LookupSeqInfo (entry.seq);
+      if (info == 0 || !info->timeoutPending || info->timeoutStart != entry.time)
+        {
+          m_seqTimeouts.pop_front (); // stale record
+          continue;
+        }
+
+      if (entry.time + rto <= now) // timeout expired?
         {
-          uint32_t seqNo = entry->seq;
-          m_seqTimeouts.get<i_timestamp> ().erase (entry);
-          OnTimeout (seqNo);
+          m_seqTimeouts.pop_front ();
+          CancelTimeout (*info);
+          OnTimeout (entry.seq);
         }
       else
         break; // nothing else to do. All later packets need not be retransmitted
@@ -291,11 +293,18 @@ Consumer::SendPacket ()
 
   uint32_t seq=std::numeric_limits<uint32_t>::max (); //invalid
 
-  while (m_retxSeqs.size ())
+  while (!m_retxSeqs.empty ())
     {
-      seq = *m_retxSeqs.begin ();
-      m_retxSeqs.erase (m_retxSeqs.begin ());
-      break;
+      uint32_t retxSeq = m_retxSeqs.top ();
+      m_retxSeqs.pop ();
+
+      SeqInfo *info = LookupSeqInfo (retxSeq);
+      if (info != 0 && info->retxPending)
+        {
+          info->retxPending = false;
+          seq = retxSeq;
+          break;
+        }
     }
 
   if (seq == std::numeric_limits<uint32_t>::max ())
@@ -314,8 +323,14 @@ Consumer::SendPacket ()
         }
       else
         {
-          NS_ASSERT_MSG (m_seqTimeouts.size () < GetNumberOfContents (), "Content catelog exhausted!!!");
-          while (m_seqTimeouts.count (seq = GetNextSeq ())); // do not send duplicate interest
+          NS_ASSERT_MSG (m_pendingTimeouts < GetNumberOfContents (), "Content catelog exhausted!!!");
+          for (;;) // do not send duplicate interest
+            {
+              seq = GetNextSeq ();
+              const SeqInfo *info = FindSeqInfo (seq);
+              if (info == 0 || !info->timeoutPending)
+                break;
+            }
         }
 
       m_seq ++;
@@ -336,7 +351,10 @@ Consumer::SendPacket ()
     nameWithSequence->Add(m_randCompName.substr(0, m_rand.GetInteger(1, m_randCompLenMax)));
   }
 
-  (*nameWithSequence) (seq);
+  if (m_binarySeqNum)
+    nameWithSequence->AddSeqNum (seq);
+  else
+    nameWithSequence->Add (seq);
 
   Interest interestHeader;
   interestHeader.SetNonce               (m_rand.GetValue ());
@@ -368,8 +386,10 @@ Consumer::SendPacket ()
 uint32_t
 Consumer::GetNextSeq()
 {
-  uint32_t content_index = 1; //[1, m_N]
-  double p_sum = 0;
+  if (m_zipf == 0)
+    {
+      m_zipf = ZipfMandelbrot::Get (m_N, m_q, m_s);
+    }
 
   double p_random = m_rand.GetValue(0.0, 1.0);
   while (p_random == 0)
@@ -377,17 +397,7 @@ Consumer::GetNextSeq()
       p_random = m_rand.GetValue(0.0, 1.0);
     }
 
-  for (uint32_t i=1; i<=m_N; i++)
-    {
-      p_sum = m_Pcum[i];   //m_Pcum[i] = m_Pcum[i-1] + p[i], p[0] = 0;   e.g.: p_cum[1] = p[1], p_cum[2] = p[1] + p[2]
-      if (p_random <= p_sum)
-        {
-          content_index = i;
-          break;
-        } //if
-    } //for
-
-  return content_index;
+  return m_zipf->GetRank (p_random); //[1, m_N]
 }
 
 ///////////////////////////////////////////////////
@@ -407,7 +417,7 @@ Consumer::OnContentObject (const Ptr<const ContentObject> &contentObject,
 
   // NS_LOG_INFO ("Received content object: " << boost::cref(*contentObject));
 
-  uint32_t seq = boost::lexical_cast<uint32_t> (contentObject->GetName ().GetComponents ().back ());
+  uint32_t seq = GetSeqNum (contentObject->GetName ());
   NS_LOG_INFO ("< DATA for " << seq << " is " << payload->GetSize() << " bytes");
 
   int hopCount = -1;
@@ -417,25 +427,19 @@ Consumer::OnContentObject (const Ptr<const ContentObject> &contentObject,
       hopCount = hopCountTag.Get ();
     }
 
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find (seq);
-  if (entry != m_seqLastDelay.end ())
+  SeqInfo *info = LookupSeqInfo (seq);
+  if (info != 0)
     {
-      m_lastRetransmittedInterestDataDelay (this, seq, Simulator::Now () - entry->time, hopCount);
-    }
+      if (info->retxCount > 0)
+        {
+          m_lastRetransmittedInterestDataDelay (this, seq, Simulator::Now () - info->lastSent, hopCount);
+          m_firstInterestDataDelay (this, seq, Simulator::Now () - info->firstSent, info->retxCount, hopCount);
+        }
 
-  entry = m_seqFullDelay.find (seq);
-  if (entry != m_seqFullDelay.end ())
-    {
-      m_firstInterestDataDelay (this, seq, Simulator::Now () - entry->time, m_seqRetxCounts[seq], hopCount);
+      CancelTimeout (*info);
+      EraseSeqInfo (seq);
     }
 
-  m_seqRetxCounts.erase (seq);
-  m_seqFullDelay.erase (seq);
-  m_seqLastDelay.erase (seq);
-
-  m_seqTimeouts.erase (seq);
-  m_retxSeqs.erase (seq);
-
   m_rtt->AckSeq (SequenceNumber32 (seq));
 }
 
@@ -451,16 +455,14 @@ Consumer::OnNack (const Ptr<const Interest> &interest, Ptr<Packet> origPacket)
   // NS_LOG_FUNCTION (interest->GetName ());
 
   // NS_LOG_INFO ("Received NACK: " << boost::cref(*interest));
-  uint32_t seq = boost::lexical_cast<uint32_t> (interest->GetName ().GetComponents ().back ());
+  uint32_t seq = GetSeqNum (interest->GetName ());
   NS_LOG_INFO ("< NACK for " << seq);
   // std::cout << Simulator::Now ().ToDouble (Time::S) << "s -> " << "NACK for " << seq << "\n";
 
   // put in the queue of interests to be retransmitted
-  // NS_LOG_INFO ("Before: " << m_retxSeqs.size ());
-  m_retxSeqs.insert (seq);
-  // NS_LOG_INFO ("After: " << m_retxSeqs.size ());
-
-  m_seqTimeouts.erase (seq);
+  SeqInfo &info = GetSeqInfo (seq);
+  ScheduleRetx (seq, info);
+  CancelTimeout (info);
 
 //  m_rtt->IncreaseMultiplier ();             // Double the next RTO ??
   ScheduleNextPacket ();
@@ -474,25 +476,94 @@ Consumer::OnTimeout (uint32_t sequenceNumber)
 
 //  m_rtt->IncreaseMultiplier ();             // Double the next RTO
   m_rtt->SentSeq (SequenceNumber32 (sequenceNumber), 1); // make sure to disable RTT calculation for this sample
-  m_retxSeqs.insert (sequenceNumber);
+  ScheduleRetx (sequenceNumber, GetSeqInfo (sequenceNumber));
   ScheduleNextPacket ();
 }
 
 void
 Consumer::WillSendOutInterest (uint32_t sequenceNumber)
 {
-  NS_LOG_DEBUG ("Trying to add " << sequenceNumber << " with " << Simulator::Now () << ". already " << m_seqTimeouts.size () << " items");
-
-  m_seqTimeouts.insert (SeqTimeout (sequenceNumber, Simulator::Now ()));
-  m_seqFullDelay.insert (SeqTimeout (sequenceNumber, Simulator::Now ()));
+  NS_LOG_DEBUG ("Trying to add " << sequenceNumber << " with " << Simulator::Now () << ". already " << m_pendingTimeouts << " items");
 
-  m_seqLastDelay.erase (sequenceNumber);
-  m_seqLastDelay.insert (SeqTimeout (sequenceNumber, Simulator::Now ()));
+  SeqInfo &info = GetSeqInfo (sequenceNumber);
+  if (!info.timeoutPending)
+    {
+      info.timeoutPending = true;
+      info.timeoutStart = Simulator::Now ();
+      m_seqTimeouts.push_back (SeqTimeout (sequenceNumber, info.timeoutStart));
+      m_pendingTimeouts ++;
+    }
 
-  m_seqRetxCounts[sequenceNumber] ++;
+  if (info.retxCount == 0)
+    info.firstSent = Simulator::Now ();
+  info.lastSent = Simulator::Now ();
+  info.retxCount ++;
 
   m_rtt->SentSeq (SequenceNumber32 (sequenceNumber), 1);
 }
 
+const Consumer::SeqInfo *
+Consumer::FindSeqInfo (uint32_t seq) const
+{
+  return const_cast<Consumer *> (this)->LookupSeqInfo (seq);
+}
+
+uint32_t
+Consumer::GetSeqNum (const Name &name)
+{
+  NS_ASSERT_MSG (name.size () > 0, "Name does not contain sequence number");
+  return name.GetComponent (name.size () - 1).toSeqNum ();
+}
+
+Consumer::SeqInfo *
+Consumer::LookupSeqInfo (uint32_t seq)
+{
+  if (m_requestMode == SEQUENTIAL)
+    return m_seqWindow.find (seq);
+
+  boost::unordered_map<uint32_t, SeqInfo>::iterator info = m_seqInfos.find (seq);
+  return info != m_seqInfos.end () ? &info->second : 0;
+}
+
+Consumer::SeqInfo &
+Consumer::GetSeqInfo (uint32_t seq)
+{
+  // requested sequence numbers are close to each other only in sequential mode
+  if (m_requestMode == SEQUENTIAL)
+    return m_seqWindow[seq];
+  else
+    return m_seqInfos[seq];
+}
+
+void
+Consumer::EraseSeqInfo (uint32_t seq)
+{
+  if (m_requestMode == SEQUENTIAL)
+    m_seqWindow.erase (seq);
+  else
+    m_seqInfos.erase (seq);
+}
+
+void
+Consumer::ScheduleRetx (uint32_t seq, SeqInfo &info)
+{
+  if (info.retxPending)
+    return;
+
+  info.retxPending = true;
+  m_retxSeqs.push (seq);
+}
+
+void
+Consumer::CancelTimeout (SeqInfo &info)
+{
+  if (!info.timeoutPending)
+    return;
+
+  // record in m_seqTimeouts becomes stale and will be skipped
+  info.timeoutPending = false;
+  m_pendingTimeouts --;
+}
+
 } // namespace ndn
 } // namespace ns3
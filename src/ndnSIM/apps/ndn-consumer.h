@@ -29,13 +29,15 @@
 #include "ns3/data-rate.h"
 #include "ns3/ndn-rtt-estimator.h"
 
-#include <set>
-#include <map>
+#include "ns3/ndnSIM/utils/seq-window.h"
+#include "ns3/ndnSIM/utils/ndn-zipf-mandelbrot.h"
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/tag.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/member.hpp>
+#include <deque>
+#include <queue>
+#include <vector>
+#include <functional>
+
+#include <boost/unordered_map.hpp>
 
 namespace ns3 {
 namespace ndn {
@@ -147,7 +149,7 @@ protected:
   uint32_t        m_N;  ///< @brief total number of contents, Zipf-Mandelbrot only
   double          m_q;  ///< @brief q in (k+q)^s, Zipf-Mandelbrot only
   double          m_s;  ///< @brief s in (k+q)^s, Zipf-Mandelbrot only
-  std::vector<double> m_Pcum;  ///< @brief cumulative probability, Zipf-Mandelbrot only
+  Ptr<const ZipfMandelbrot> m_zipf; ///< @brief distribution of content ranks (shared, created on first use), Zipf-Mandelbrot only
 
   void
   SetNumberOfContents (uint32_t numOfContents);
@@ -183,67 +185,90 @@ protected:
   uint32_t        m_randCompLenMax;   ///< @brief maximum length of randomly added component
   std::string     m_randCompName;     ///< @brief string from which random component names will be built
 
-/// @cond include_hidden
-  /**
-   * \struct This struct contains sequence numbers of packets to be retransmitted
-   */
-  struct RetxSeqsContainer :
-    public std::set<uint32_t> { };
-
-  RetxSeqsContainer m_retxSeqs;             ///< \brief ordered set of sequence numbers to be retransmitted
-
   /**
-   * \struct This struct contains a pair of packet sequence number and its timeout
+   * @brief Per-sequence state of the requested data
    */
-  struct SeqTimeout
+  struct SeqInfo
   {
-    SeqTimeout (uint32_t _seq, Time _time) : seq (_seq), time (_time) { }
-
-    uint32_t seq;
-    Time time;
+    SeqInfo ()
+      : retxCount (0)
+      , timeoutPending (false)
+      , retxPending (false)
+    {
+    }
+
+    Time firstSent;       ///< @brief time when Interest was sent out for the first time
+    Time lastSent;        ///< @brief time when Interest was sent out for the last time
+    Time timeoutStart;    ///< @brief time since which retransmission timeout is counted
+    uint32_t retxCount;   ///< @brief number of times Interest was sent out
+    bool timeoutPending;  ///< @brief whether retransmission timeout is being checked for the sequence number
+    bool retxPending;     ///< @brief whether sequence number is scheduled for retransmission
   };
-/// @endcond
 
-/// @cond include_hidden
-  class i_seq { };
-  class i_timestamp { };
-/// @endcond
+  /**
+   * @brief Find state of the sequence number
+   * @returns 0 if the sequence number is not requested or data has been already received
+   */
+  const SeqInfo *
+  FindSeqInfo (uint32_t seq) const;
 
-/// @cond include_hidden
   /**
-   * \struct This struct contains a multi-index for the set of SeqTimeout structs
+   * @brief Extract sequence number from the last component of the name
    */
-  struct SeqTimeoutsContainer :
-    public boost::multi_index::multi_index_container<
-    SeqTimeout,
-    boost::multi_index::indexed_by<
-      boost::multi_index::ordered_unique<
-        boost::multi_index::tag<i_seq>,
-        boost::multi_index::member<SeqTimeout, uint32_t, &SeqTimeout::seq>
-        >,
-      boost::multi_index::ordered_non_unique<
-        boost::multi_index::tag<i_timestamp>,
-        boost::multi_index::member<SeqTimeout, Time, &SeqTimeout::time>
-        >
-      >
-    > { } ;
-
-  SeqTimeoutsContainer m_seqTimeouts;       ///< \brief multi-index for the set of SeqTimeout structs
-
-  SeqTimeoutsContainer m_seqLastDelay;
-  SeqTimeoutsContainer m_seqFullDelay;
-  std::map<uint32_t, uint32_t> m_seqRetxCounts;
+  static uint32_t
+  GetSeqNum (const Name &name);
+
+  bool m_binarySeqNum; ///< @brief whether sequence number is appended to Interest name as a binary component
 
   // JRO
   uint8_t m_priority;
 
+/// @cond include_hidden
   TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */,
                  Time /* delay */, int32_t /*hop count*/> m_lastRetransmittedInterestDataDelay;
   TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */,
                  Time /* delay */, uint32_t /*retx count*/,
                  int32_t /*hop count*/> m_firstInterestDataDelay;
+/// @endcond
+
+private:
+  SeqInfo *
+  LookupSeqInfo (uint32_t seq);
 
+  SeqInfo &
+  GetSeqInfo (uint32_t seq);
+
+  void
+  EraseSeqInfo (uint32_t seq);
+
+  void
+  ScheduleRetx (uint32_t seq, SeqInfo &info);
+
+  void
+  CancelTimeout (SeqInfo &info);
+
+private:
+/// @cond include_hidden
+  /**
+   * \struct This struct contains a pair of packet sequence number and the time since which its timeout is counted
+   */
+  struct SeqTimeout
+  {
+    SeqTimeout (uint32_t _seq, Time _time) : seq (_seq), time (_time) { }
+
+    uint32_t seq;
+    Time time;
+  };
 /// @endcond
+
+  ndnSIM::seq_window<SeqInfo> m_seqWindow;             ///< \brief state of requested sequence numbers (sequential mode)
+  boost::unordered_map<uint32_t, SeqInfo> m_seqInfos;  ///< \brief state of requested sequence numbers (Zipf-Mandelbrot mode)
+
+  std::deque<SeqTimeout> m_seqTimeouts; ///< \brief retransmission timeouts in order of their start (may contain stale records)
+  uint32_t m_pendingTimeouts;           ///< \brief number of sequence numbers with retransmission timeout being checked
+
+  /// \brief sequence numbers to be retransmitted, smallest first (may contain stale records)
+  std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t> > m_retxSeqs;
 };
 
 } // namespace ndn
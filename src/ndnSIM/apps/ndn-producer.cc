@@ -126,11 +126,8 @@ Producer::OnInterest (const Ptr<const Interest> &interest, Ptr<Packet> origPacke
   if (!m_active) return;
     
   static ContentObjectTail tail;
-  Ptr<ContentObject> header = Create<ContentObject> ();
-  header->SetName (Create<Name> (interest->GetName ()));
-  header->SetFreshness (m_freshness);
 
-  NS_LOG_INFO ("node("<< GetNode()->GetId() <<") respodning with ContentObject:\n" << boost::cref(*header));
+  NS_LOG_INFO ("node("<< GetNode()->GetId() <<") respodning with ContentObject: " << interest->GetName ());
 
   if (m_virtualRandPayloadSizeMax) {
     packet_size = m_rand.GetInteger(m_virtualRandPayloadSizeMin, m_virtualRandPayloadSizeMax);
@@ -139,10 +136,37 @@ Producer::OnInterest (const Ptr<const Interest> &interest, Ptr<Packet> origPacke
   }
   
   Ptr<Packet> packet = Create<Packet> (packet_size);
-
-  packet->AddHeader (*header);
   packet->AddTrailer (tail);
 
+  // full header (with a copy of the name) is built only for traces and for packet metadata,
+  // which has to record a ContentObject header
+  bool withMetadata = packet->BeginItem ().HasNext ();
+  Ptr<ContentObject> header;
+  if (withMetadata || !m_transmittedContentObjects.IsEmpty ())
+    {
+      header = Create<ContentObject> ();
+      header->SetName (Create<Name> (interest->GetName ()));
+      header->SetFreshness (m_freshness);
+    }
+
+  if (withMetadata)
+    {
+      packet->AddHeader (*header);
+    }
+  else
+    {
+      if (m_dataTemplate.GetFreshness () != m_freshness)
+        {
+          ContentObject dataHeader;
+          dataHeader.SetFreshness (m_freshness);
+          m_dataTemplate = ContentObjectTemplate (dataHeader);
+        }
+
+      m_dataTemplate.SetName (interest->GetNamePtr ());
+      packet->AddHeader (m_dataTemplate);
+      m_dataTemplate.SetName (0);
+    }
+
   // Echo back FwHopCountTag if exists
   FwHopCountTag hopCountTag;
   if (origPacket->RemovePacketTag (hopCountTag))
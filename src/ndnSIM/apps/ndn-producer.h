@@ -69,6 +69,8 @@ private:
   uint32_t m_virtualRandPayloadSizeMax;
 
   UniformVariable m_rand; ///< @brief random payload size
+
+  ContentObjectTemplate m_dataTemplate; ///< @brief pre-serialized Data header, only the name is serialized per response
 };
 
 } // namespace ndn
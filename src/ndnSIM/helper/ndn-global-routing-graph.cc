@@ -0,0 +1,589 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ndn-global-routing-graph.h"
+
+#include "../model/ndn-global-router.h"
+#include "ns3/ndn-face.h"
+#include "ns3/ndn-limits.h"
+
+#include "ns3/node.h"
+#include "ns3/channel.h"
+#include "ns3/node-list.h"
+#include "ns3/channel-list.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/callback.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unistd.h>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.GlobalRoutingGraph");
+
+namespace ns3 {
+namespace ndn {
+
+static GlobalValue g_globalRoutingThreads ("NdnGlobalRoutingThreads",
+                                           "Number of threads to calculate routes in ndn::GlobalRoutingHelper "
+                                           "(0 to use all online processors)",
+                                           UintegerValue (0),
+                                           MakeUintegerChecker<uint32_t> ());
+
+const uint32_t GlobalRoutingGraph::DISABLED_METRIC;
+const uint32_t GlobalRoutingGraph::UNREACHABLE_METRIC;
+
+namespace {
+
+typedef GlobalRoutingGraph::Distance Distance;
+
+struct DistanceCompare
+{
+  bool
+  operator () (const Distance &a, const Distance &b) const
+  {
+    return a.m_metric < b.m_metric;
+  }
+};
+
+struct DistanceCombine
+{
+  Distance
+  operator () (const Distance &a, const Distance &b) const
+  {
+    // the first face on the path is the first-hop face
+    return Distance (a.m_face == GlobalRoutingGraph::NO_FACE ? b.m_face : a.m_face,
+                     a.m_metric + b.m_metric,
+                     a.m_delay + b.m_delay);
+  }
+};
+
+/**
+ * @brief Weight of the edge in the run: all faces of the source, except the enabled one, are disabled
+ */
+Distance
+GetRunWeight (const GlobalRoutingGraph::Run &run, uint32_t source, const Distance &weight)
+{
+  if (run.m_enabledFace != GlobalRoutingGraph::ALL_FACES &&
+      weight.m_face != GlobalRoutingGraph::NO_FACE &&
+      weight.m_face != run.m_enabledFace &&
+      source == run.m_source)
+    {
+      return Distance (weight.m_face, GlobalRoutingGraph::DISABLED_METRIC, weight.m_delay);
+    }
+  return weight;
+}
+
+/**
+ * @brief Edge weights of the run (see GetRunWeight)
+ */
+template<class Graph>
+class RunWeightMap
+{
+public:
+  typedef typename boost::graph_traits<Graph>::edge_descriptor key_type;
+  typedef Distance value_type;
+  typedef Distance reference;
+  typedef boost::readable_property_map_tag category;
+
+  RunWeightMap (const Graph &graph, const GlobalRoutingGraph::Run &run)
+    : m_graph (graph)
+    , m_run (run)
+  {
+  }
+
+  friend Distance
+  get (const RunWeightMap &map, const key_type &edge)
+  {
+    return GetRunWeight (map.m_run, boost::source (edge, map.m_graph), map.m_graph[edge]);
+  }
+
+private:
+  const Graph &m_graph;
+  const GlobalRoutingGraph::Run &m_run;
+};
+
+/**
+ * @brief Incremental update of a shortest path tree (see GlobalRoutingGraph::UpdateShortestPaths)
+ */
+class TreeUpdate
+{
+public:
+  TreeUpdate (const GlobalRoutingGraph::Run &run, GlobalRoutingGraph::Tree &tree)
+    : m_run (run)
+    , m_tree (tree)
+  {
+  }
+
+  /**
+   * @brief Remove path to the vertex
+   */
+  void
+  Detach (uint32_t vertex)
+  {
+    m_previous.insert (std::make_pair (vertex, m_tree.m_distances[vertex]));
+    m_tree.m_distances[vertex] = Distance (GlobalRoutingGraph::NO_FACE, GlobalRoutingGraph::UNREACHABLE_METRIC, 0.0);
+    m_tree.m_parents[vertex] = vertex;
+  }
+
+  /**
+   * @brief Use the edge if it gives a shorter path to the target
+   */
+  void
+  Relax (uint32_t source, uint32_t target, const Distance &weight)
+  {
+    Distance candidate = DistanceCombine () (m_tree.m_distances[source], GetRunWeight (m_run, source, weight));
+    if (!DistanceCompare () (candidate, m_tree.m_distances[target]))
+      return;
+
+    m_previous.insert (std::make_pair (target, m_tree.m_distances[target]));
+    m_tree.m_distances[target] = candidate;
+    m_tree.m_parents[target] = source;
+    m_queue.push (QueueItem (candidate.m_metric, target));
+  }
+
+  /**
+   * @brief Get the closest vertex, whose out-edges have not been relaxed since its path has changed
+   * @returns false if there are no such vertices
+   */
+  bool
+  Pop (uint32_t &vertex)
+  {
+    while (!m_queue.empty ())
+      {
+        QueueItem item = m_queue.top ();
+        m_queue.pop ();
+        if (item.first == m_tree.m_distances[item.second].m_metric) // otherwise the item is outdated
+          {
+            vertex = item.second;
+            return true;
+          }
+      }
+    return false;
+  }
+
+  /**
+   * @brief Get vertices whose distance or first-hop face has changed
+   */
+  void
+  GetChanged (std::vector<uint32_t> &changed) const
+  {
+    changed.clear ();
+    for (std::map<uint32_t, Distance>::const_iterator vertex = m_previous.begin (); vertex != m_previous.end (); vertex++)
+      {
+        if (vertex->second != m_tree.m_distances[vertex->first])
+          changed.push_back (vertex->first);
+      }
+  }
+
+private:
+  typedef std::pair<uint32_t, uint32_t> QueueItem; ///< @brief metric and vertex
+
+  const GlobalRoutingGraph::Run &m_run;
+  GlobalRoutingGraph::Tree &m_tree;
+  std::map<uint32_t, Distance> m_previous; ///< @brief distances of updated vertices before the update
+  std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > m_queue;
+};
+
+/**
+ * @brief Calculates (or updates, if changes are given) every n-th run of the list, starting from the given one
+ */
+class Worker
+{
+public:
+  Worker (const GlobalRoutingGraph &graph,
+          const std::vector<GlobalRoutingGraph::Run> &runs,
+          std::vector<GlobalRoutingGraph::Tree> &trees,
+          uint32_t first, uint32_t step)
+    : m_graph (graph)
+    , m_runs (runs)
+    , m_trees (trees)
+    , m_changes (0)
+    , m_changed (0)
+    , m_first (first)
+    , m_step (step)
+  {
+  }
+
+  void
+  SetChanges (const std::vector<GlobalRoutingGraph::Change> &changes, std::vector< std::vector<uint32_t> > &changed)
+  {
+    m_changes = &changes;
+    m_changed = &changed;
+  }
+
+  void
+  Run ()
+  {
+    for (uint32_t i = m_first; i < m_runs.size (); i += m_step)
+      {
+        if (m_changes != 0)
+          m_graph.UpdateShortestPaths (m_runs[i], *m_changes, m_trees[i], (*m_changed)[i]);
+        else
+          m_graph.ShortestPaths (m_runs[i], m_trees[i]);
+      }
+  }
+
+private:
+  const GlobalRoutingGraph &m_graph;
+  const std::vector<GlobalRoutingGraph::Run> &m_runs;
+  std::vector<GlobalRoutingGraph::Tree> &m_trees;
+  const std::vector<GlobalRoutingGraph::Change> *m_changes;
+  std::vector< std::vector<uint32_t> > *m_changed;
+  uint32_t m_first;
+  uint32_t m_step;
+};
+
+/**
+ * @brief Run workers in parallel (sequentially if threads are not supported)
+ */
+void
+RunWorkers (std::vector<Worker> &workers)
+{
+#ifdef HAVE_PTHREAD_H
+  if (workers.size () > 1)
+    {
+      std::vector< Ptr<SystemThread> > threads;
+      for (uint32_t i = 0; i < workers.size (); i++)
+        {
+          threads.push_back (Create<SystemThread> (MakeCallback (&Worker::Run, &workers[i])));
+          threads.back ()->Start ();
+        }
+
+      for (uint32_t i = 0; i < threads.size (); i++)
+        {
+          threads[i]->Join ();
+        }
+      return;
+    }
+#endif
+
+  for (uint32_t i = 0; i < workers.size (); i++)
+    {
+      workers[i].Run ();
+    }
+}
+
+} // namespace
+
+GlobalRoutingGraph::GlobalRoutingGraph ()
+{
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      Ptr<GlobalRouter> gr = (*node)->GetObject<GlobalRouter> ();
+      if (gr != 0)
+        {
+          m_vertices[gr] = m_routers.size ();
+          m_routers.push_back (gr);
+        }
+    }
+
+  for (ChannelList::Iterator channel = ChannelList::Begin (); channel != ChannelList::End (); channel++)
+    {
+      Ptr<GlobalRouter> gr = (*channel)->GetObject<GlobalRouter> ();
+      if (gr != 0)
+        {
+          m_vertices[gr] = m_routers.size ();
+          m_routers.push_back (gr);
+        }
+    }
+
+  std::vector< std::pair<uint32_t, uint32_t> > edges;
+  std::vector<Distance> weights;
+  for (uint32_t vertex = 0; vertex < m_routers.size (); vertex++)
+    {
+      const GlobalRouter::IncidencyList &incidencies = m_routers[vertex]->GetIncidencies ();
+      for (GlobalRouter::IncidencyList::const_iterator incidency = incidencies.begin ();
+           incidency != incidencies.end ();
+           incidency++)
+        {
+          edges.push_back (std::make_pair (vertex, GetVertex (incidency->get<2> ())));
+
+          Ptr<Face> face = incidency->get<1> ();
+          if (face == 0)
+            {
+              weights.push_back (Distance (NO_FACE, 0, 0.0));
+              continue;
+            }
+
+          std::map<const Face *, int32_t>::iterator index = m_faceIndexes.find (PeekPointer (face));
+          if (index == m_faceIndexes.end ())
+            {
+              index = m_faceIndexes.insert (std::make_pair (PeekPointer (face), static_cast<int32_t> (m_faces.size ()))).first;
+              m_faces.push_back (face);
+            }
+
+          double delay = 0.0;
+          Ptr<Limits> limits = face->GetObject<Limits> ();
+          if (limits != 0) // valid limits object
+            {
+              delay = limits->GetLinkDelay ();
+            }
+
+          weights.push_back (Distance (index->second, face->IsUp () ? face->GetMetric () : UNREACHABLE_METRIC, delay));
+        }
+    }
+
+  // edges are already grouped by source, their order is preserved
+  m_graph = Graph (boost::edges_are_sorted, edges.begin (), edges.end (), weights.begin (), m_routers.size ());
+
+  // incoming edges, needed only to update shortest paths
+  m_inEdgeOffsets.assign (m_routers.size () + 1, 0);
+  for (uint32_t i = 0; i < edges.size (); i++)
+    {
+      m_inEdgeOffsets[edges[i].second + 1] ++;
+    }
+  for (uint32_t vertex = 0; vertex < m_routers.size (); vertex++)
+    {
+      m_inEdgeOffsets[vertex + 1] += m_inEdgeOffsets[vertex];
+    }
+  m_inEdges.resize (edges.size ());
+  std::vector<uint32_t> next (m_inEdgeOffsets.begin (), m_inEdgeOffsets.end () - 1);
+  for (uint32_t i = 0; i < edges.size (); i++)
+    {
+      m_inEdges[next[edges[i].second] ++] = InEdge (edges[i].first, weights[i]);
+    }
+
+  NS_LOG_DEBUG ("Snapshot with " << m_routers.size () << " vertices and " << edges.size () << " edges");
+}
+
+uint32_t
+GlobalRoutingGraph::GetNVertices () const
+{
+  return m_routers.size ();
+}
+
+uint32_t
+GlobalRoutingGraph::GetVertex (Ptr<GlobalRouter> router) const
+{
+  std::map< Ptr<GlobalRouter>, uint32_t >::const_iterator vertex = m_vertices.find (router);
+  NS_ASSERT_MSG (vertex != m_vertices.end (), "GlobalRouter is not installed on any node or channel");
+  return vertex->second;
+}
+
+Ptr<GlobalRouter>
+GlobalRoutingGraph::GetRouter (uint32_t vertex) const
+{
+  return m_routers[vertex];
+}
+
+Ptr<Face>
+GlobalRoutingGraph::GetFace (int32_t face) const
+{
+  if (face == NO_FACE)
+    return 0;
+
+  return m_faces[face];
+}
+
+int32_t
+GlobalRoutingGraph::GetFaceIndex (Ptr<Face> face) const
+{
+  std::map<const Face *, int32_t>::const_iterator index = m_faceIndexes.find (PeekPointer (face));
+  if (index == m_faceIndexes.end ())
+    return NO_FACE;
+
+  return index->second;
+}
+
+bool
+GlobalRoutingGraph::HasSameStructure (const GlobalRoutingGraph &other) const
+{
+  if (m_routers != other.m_routers || m_faces != other.m_faces ||
+      boost::num_edges (m_graph) != boost::num_edges (other.m_graph))
+    return false;
+
+  Graph::edge_iterator edge, end, otherEdge, otherEnd;
+  boost::tie (edge, end) = boost::edges (m_graph);
+  boost::tie (otherEdge, otherEnd) = boost::edges (other.m_graph);
+  for (; edge != end; edge++, otherEdge++)
+    {
+      if (boost::source (*edge, m_graph) != boost::source (*otherEdge, other.m_graph) ||
+          boost::target (*edge, m_graph) != boost::target (*otherEdge, other.m_graph) ||
+          m_graph[*edge].m_face != other.m_graph[*otherEdge].m_face)
+        return false;
+    }
+  return true;
+}
+
+void
+GlobalRoutingGraph::GetChanges (const GlobalRoutingGraph &previous, std::vector<Change> &changes) const
+{
+  NS_ASSERT (HasSameStructure (previous));
+  changes.clear ();
+
+  Graph::edge_iterator edge, end, previousEdge, previousEnd;
+  boost::tie (edge, end) = boost::edges (m_graph);
+  boost::tie (previousEdge, previousEnd) = boost::edges (previous.m_graph);
+  for (; edge != end; edge++, previousEdge++)
+    {
+      if (m_graph[*edge] != previous.m_graph[*previousEdge])
+        {
+          changes.push_back (Change (boost::source (*edge, m_graph), boost::target (*edge, m_graph),
+                                     previous.m_graph[*previousEdge], m_graph[*edge]));
+        }
+    }
+}
+
+void
+GlobalRoutingGraph::ShortestPaths (const Run &run, Tree &tree) const
+{
+  tree.m_distances.assign (m_routers.size (), Distance ());
+  tree.m_parents.resize (m_routers.size ());
+
+  boost::dijkstra_shortest_paths (m_graph, run.m_source,
+                                  boost::weight_map (RunWeightMap<Graph> (m_graph, run))
+                                  .
+                                  predecessor_map (&tree.m_parents[0])
+                                  .
+                                  distance_map (boost::make_iterator_property_map (tree.m_distances.begin (),
+                                                                                   boost::get (boost::vertex_index, m_graph)))
+                                  .
+                                  distance_inf (Distance (NO_FACE, UNREACHABLE_METRIC, 0.0))
+                                  .
+                                  distance_zero (Distance (NO_FACE, 0, 0.0))
+                                  .
+                                  distance_compare (DistanceCompare ())
+                                  .
+                                  distance_combine (DistanceCombine ())
+                                  );
+}
+
+void
+GlobalRoutingGraph::ShortestPaths (const std::vector<Run> &runs, std::vector<Tree> &trees) const
+{
+  trees.resize (runs.size ());
+
+  uint32_t nThreads = std::max<uint32_t> (std::min<uint32_t> (GetNThreads (), runs.size ()), 1);
+  std::vector<Worker> workers;
+  for (uint32_t i = 0; i < nThreads; i++)
+    {
+      workers.push_back (Worker (*this, runs, trees, i, nThreads));
+    }
+  RunWorkers (workers);
+}
+
+void
+GlobalRoutingGraph::UpdateShortestPaths (const Run &run, const std::vector<Change> &changes,
+                                         Tree &tree, std::vector<uint32_t> &changed) const
+{
+  TreeUpdate update (run, tree);
+
+  // vertices whose paths go through changed edges lose their paths
+  std::vector<uint32_t> detached;
+  for (std::vector<Change>::const_iterator change = changes.begin (); change != changes.end (); change++)
+    {
+      if (tree.m_parents[change->m_target] == change->m_source && change->m_target != run.m_source &&
+          GetRunWeight (run, change->m_source, change->m_previous) != GetRunWeight (run, change->m_source, change->m_current))
+        {
+          detached.push_back (change->m_target);
+        }
+    }
+
+  std::vector<bool> isDetached;
+  if (!detached.empty ())
+    {
+      std::vector< std::vector<uint32_t> > children (m_routers.size ());
+      for (uint32_t vertex = 0; vertex < m_routers.size (); vertex++)
+        {
+          if (tree.m_parents[vertex] != vertex)
+            children[tree.m_parents[vertex]].push_back (vertex);
+        }
+
+      isDetached.assign (m_routers.size (), false);
+      for (uint32_t i = 0; i < detached.size (); i++) // subtrees are appended to the list
+        {
+          uint32_t vertex = detached[i];
+          if (isDetached[vertex])
+            continue;
+
+          isDetached[vertex] = true;
+          update.Detach (vertex);
+          detached.insert (detached.end (), children[vertex].begin (), children[vertex].end ());
+        }
+    }
+
+  // detached vertices are attached back via the best incoming edges from the rest of the tree
+  for (uint32_t i = 0; i < detached.size (); i++)
+    {
+      uint32_t target = detached[i];
+      for (uint32_t edge = m_inEdgeOffsets[target]; edge < m_inEdgeOffsets[target + 1]; edge++)
+        {
+          if (!isDetached[m_inEdges[edge].first])
+            update.Relax (m_inEdges[edge].first, target, m_inEdges[edge].second);
+        }
+    }
+
+  // changed edges can make paths shorter
+  for (std::vector<Change>::const_iterator change = changes.begin (); change != changes.end (); change++)
+    {
+      update.Relax (change->m_source, change->m_target, change->m_current);
+    }
+
+  // new paths are propagated as in Dijkstra
+  uint32_t source;
+  while (update.Pop (source))
+    {
+      Graph::out_edge_iterator edge, end;
+      for (boost::tie (edge, end) = boost::out_edges (static_cast<Graph::vertex_descriptor> (source), m_graph); edge != end; edge++)
+        {
+          update.Relax (source, boost::target (*edge, m_graph), m_graph[*edge]);
+        }
+    }
+
+  update.GetChanged (changed);
+}
+
+void
+GlobalRoutingGraph::UpdateShortestPaths (const std::vector<Run> &runs, const std::vector<Change> &changes,
+                                         std::vector<Tree> &trees, std::vector< std::vector<uint32_t> > &changed) const
+{
+  changed.resize (runs.size ());
+
+  uint32_t nThreads = std::max<uint32_t> (std::min<uint32_t> (GetNThreads (), runs.size ()), 1);
+  std::vector<Worker> workers;
+  for (uint32_t i = 0; i < nThreads; i++)
+    {
+      workers.push_back (Worker (*this, runs, trees, i, nThreads));
+      workers.back ().SetChanges (changes, changed);
+    }
+  RunWorkers (workers);
+}
+
+uint32_t
+GlobalRoutingGraph::GetNThreads ()
+{
+  UintegerValue threads;
+  g_globalRoutingThreads.GetValue (threads);
+  if (threads.Get () > 0)
+    return threads.Get ();
+
+  long processors = sysconf (_SC_NPROCESSORS_ONLN);
+  return processors > 0 ? processors : 1;
+}
+
+} // namespace ndn
+} // namespace ns3
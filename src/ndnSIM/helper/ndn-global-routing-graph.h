@@ -0,0 +1,264 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NDN_GLOBAL_ROUTING_GRAPH_H
+#define NDN_GLOBAL_ROUTING_GRAPH_H
+
+#include "ns3/ptr.h"
+
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+class GlobalRouter;
+class Face;
+
+/**
+ * @ingroup ndn
+ * @brief Snapshot of the topology of GlobalRouter interfaces in compressed sparse row form
+ *
+ * Vertices get dense IDs (nodes first, then channels, in the order of NodeList and ChannelList) and
+ * faces are replaced with dense indexes, so shortest paths from different sources can be calculated in
+ * parallel without touching ns-3 objects (reference counters of ns-3 objects are not thread-safe).
+ *
+ * Out-edges of every vertex keep the order of GlobalRouter::GetIncidencies, so the calculated paths
+ * (including the choice between equal-cost paths) are the same as with the implicit graph of
+ * GlobalRouter interfaces (boost-graph-ndn-global-routing-helper.h).
+ */
+class GlobalRoutingGraph
+{
+public:
+  enum
+    {
+      NO_FACE = -1,   ///< @brief face index of edges without face and of unreachable vertices
+      ALL_FACES = -2  ///< @brief Run::m_enabledFace value that enables all faces of the source
+    };
+
+  /**
+   * @brief Weight of an edge, or distance to a vertex along the shortest path
+   */
+  struct Distance
+  {
+    Distance (int32_t face = NO_FACE, uint32_t metric = 0, double delay = 0.0)
+      : m_face (face)
+      , m_metric (metric)
+      , m_delay (delay)
+    {
+    }
+
+    bool
+    operator == (const Distance &other) const
+    {
+      return m_face == other.m_face && m_metric == other.m_metric && m_delay == other.m_delay;
+    }
+
+    bool
+    operator != (const Distance &other) const
+    {
+      return !(*this == other);
+    }
+
+    int32_t m_face;     ///< @brief index of the face of the edge, or of the first-hop face for distances
+    uint32_t m_metric;  ///< @brief routing metric (sum of face metrics)
+    double m_delay;     ///< @brief link delay (sum of link delays)
+  };
+
+  /**
+   * @brief Request for the shortest path calculation
+   */
+  struct Run
+  {
+    Run (uint32_t source = 0, int32_t enabledFace = ALL_FACES)
+      : m_source (source)
+      , m_enabledFace (enabledFace)
+    {
+    }
+
+    uint32_t m_source;      ///< @brief source vertex
+    int32_t m_enabledFace;  ///< @brief the only face of the source that can be used (ALL_FACES to use all, NO_FACE to use none)
+  };
+
+  /**
+   * @brief Shortest path tree of a run
+   */
+  struct Tree
+  {
+    std::vector<Distance> m_distances; ///< @brief distance and first-hop face (NO_FACE if unreachable) of every vertex
+    std::vector<uint32_t> m_parents;   ///< @brief parent of every vertex (the vertex itself for the source and unreachable vertices)
+  };
+
+  /**
+   * @brief Edge whose weight is different in two snapshots
+   */
+  struct Change
+  {
+    Change (uint32_t source, uint32_t target, const Distance &previous, const Distance &current)
+      : m_source (source)
+      , m_target (target)
+      , m_previous (previous)
+      , m_current (current)
+    {
+    }
+
+    uint32_t m_source;    ///< @brief source vertex of the edge
+    uint32_t m_target;    ///< @brief target vertex of the edge
+    Distance m_previous;  ///< @brief weight in the previous snapshot
+    Distance m_current;   ///< @brief weight in the current snapshot
+  };
+
+  /**
+   * @brief Take snapshot of GlobalRouter interfaces installed on all nodes and channels
+   *
+   * Metrics, states, and link delays of faces are recorded at the time of the snapshot.  Edges of faces
+   * that are down get UNREACHABLE_METRIC and are never used.
+   */
+  GlobalRoutingGraph ();
+
+  /**
+   * @brief Number of vertices in the graph
+   */
+  uint32_t
+  GetNVertices () const;
+
+  /**
+   * @brief Get vertex ID of the GlobalRouter
+   */
+  uint32_t
+  GetVertex (Ptr<GlobalRouter> router) const;
+
+  /**
+   * @brief Get GlobalRouter of the vertex
+   */
+  Ptr<GlobalRouter>
+  GetRouter (uint32_t vertex) const;
+
+  /**
+   * @brief Get face by its index
+   */
+  Ptr<Face>
+  GetFace (int32_t face) const;
+
+  /**
+   * @brief Get face index (NO_FACE if the face does not belong to any edge of the graph)
+   */
+  int32_t
+  GetFaceIndex (Ptr<Face> face) const;
+
+  /**
+   * @brief Check if both snapshots have the same vertices, edges, and faces (weights may differ)
+   *
+   * Face indexes of snapshots with the same structure are the same, so runs and trees can be reused
+   */
+  bool
+  HasSameStructure (const GlobalRoutingGraph &other) const;
+
+  /**
+   * @brief Get edges whose weights differ from the previous snapshot with the same structure
+   */
+  void
+  GetChanges (const GlobalRoutingGraph &previous, std::vector<Change> &changes) const;
+
+  /**
+   * @brief Calculate shortest paths for the run (can be called from any thread)
+   *
+   * @param run  source vertex and enabled faces
+   * @param tree shortest path tree of the run
+   */
+  void
+  ShortestPaths (const Run &run, Tree &tree) const;
+
+  /**
+   * @brief Calculate shortest paths for all runs in parallel
+   *
+   * Number of threads is controlled by the NdnGlobalRoutingThreads global value
+   *
+   * @param runs  requests for the shortest path calculation
+   * @param trees shortest path tree for every run
+   */
+  void
+  ShortestPaths (const std::vector<Run> &runs, std::vector<Tree> &trees) const;
+
+  /**
+   * @brief Update shortest paths of the run after edge weights have changed (can be called from any thread)
+   *
+   * Only vertices whose paths go through changed edges, and vertices to which the changed edges
+   * give shorter paths, are processed (incremental Dijkstra).  When there are several equal-cost paths,
+   * the existing one is kept.
+   *
+   * @param run     source vertex and enabled faces
+   * @param changes changed edges (see GetChanges)
+   * @param tree    shortest path tree of the run calculated before the changes, updated in place
+   * @param changed vertices whose distance or first-hop face has changed
+   */
+  void
+  UpdateShortestPaths (const Run &run, const std::vector<Change> &changes,
+                       Tree &tree, std::vector<uint32_t> &changed) const;
+
+  /**
+   * @brief Update shortest paths of all runs in parallel
+   *
+   * @param runs    source vertices and enabled faces
+   * @param changes changed edges (see GetChanges)
+   * @param trees   shortest path tree for every run, updated in place
+   * @param changed vertices whose distance or first-hop face has changed, for every run
+   */
+  void
+  UpdateShortestPaths (const std::vector<Run> &runs, const std::vector<Change> &changes,
+                       std::vector<Tree> &trees, std::vector< std::vector<uint32_t> > &changed) const;
+
+  /**
+   * @brief Get number of threads used by ShortestPaths
+   *
+   * Value of the NdnGlobalRoutingThreads global value, or the number of online processors if it is 0
+   */
+  static uint32_t
+  GetNThreads ();
+
+  /**
+   * @brief Metric that is assigned to the disabled faces of the source
+   */
+  static const uint32_t DISABLED_METRIC = 65534;
+
+  /**
+   * @brief Distance to unreachable vertices and metric of faces that are down
+   */
+  static const uint32_t UNREACHABLE_METRIC = 65535;
+
+private:
+  typedef boost::compressed_sparse_row_graph<boost::directedS, boost::no_property, Distance> Graph;
+
+  /**
+   * @brief Incoming edge (source vertex and weight)
+   */
+  typedef std::pair<uint32_t, Distance> InEdge;
+
+  Graph m_graph;
+  std::vector<uint32_t> m_inEdgeOffsets;             ///< @brief incoming edges of vertex v are [offsets[v], offsets[v+1])
+  std::vector<InEdge> m_inEdges;                     ///< @brief incoming edges grouped by target
+  std::vector< Ptr<GlobalRouter> > m_routers;        ///< @brief router of every vertex
+  std::map< Ptr<GlobalRouter>, uint32_t > m_vertices; ///< @brief vertex ID of every router
+  std::vector< Ptr<Face> > m_faces;                  ///< @brief face of every face index
+  std::map<const Face *, int32_t> m_faceIndexes;     ///< @brief face index of every face (faces of different nodes are not comparable)
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_GLOBAL_ROUTING_GRAPH_H
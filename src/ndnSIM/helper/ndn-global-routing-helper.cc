@@ -36,16 +36,17 @@
 #include "ns3/node-list.h"
 #include "ns3/channel-list.h"
 #include "ns3/object-factory.h"
+#include "ns3/simulator.h"
 
 #include <boost/lexical_cast.hpp>
 #include <boost/foreach.hpp>
-#include <boost/concept/assert.hpp>
-// #include <boost/graph/graph_concepts.hpp>
-// #include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/make_shared.hpp>
 
-#include "boost-graph-ndn-global-routing-helper.h"
+#include "ndn-global-routing-graph.h"
 
+#include <algorithm>
+#include <map>
+#include <set>
 #include <math.h>
 
 NS_LOG_COMPONENT_DEFINE ("ndn.GlobalRoutingHelper");
@@ -56,6 +57,53 @@ using namespace boost;
 namespace ns3 {
 namespace ndn {
 
+namespace {
+
+/// @brief Number of shortest path trees calculated by a thread in one batch (without incremental updates)
+const uint32_t RUNS_PER_THREAD = 16;
+
+/**
+ * @brief Snapshot and shortest path trees of the last route calculation, kept for GlobalRoutingHelper::UpdateRoutes
+ */
+struct RoutingState
+{
+  RoutingState ()
+    : m_allPossible (false)
+    , m_incremental (false)
+    , m_treesKept (false)
+    , m_resetScheduled (false)
+  {
+  }
+
+  boost::shared_ptr<GlobalRoutingGraph> m_graph;
+  std::vector<GlobalRoutingGraph::Run> m_runs;
+  std::vector<GlobalRoutingGraph::Tree> m_trees;
+  bool m_allPossible;    ///< @brief routes were calculated by CalculateAllPossibleRoutes
+  bool m_incremental;    ///< @brief shortest path trees should be kept (see EnableIncrementalUpdates)
+  bool m_treesKept;      ///< @brief m_trees are the trees of m_runs on m_graph
+  bool m_resetScheduled; ///< @brief state will be reset by Simulator::Destroy
+};
+
+RoutingState g_routingState;
+
+void
+ResetRoutingState ()
+{
+  g_routingState = RoutingState ();
+}
+
+void
+ScheduleResetRoutingState ()
+{
+  if (!g_routingState.m_resetScheduled)
+    {
+      Simulator::ScheduleDestroy (&ResetRoutingState);
+      g_routingState.m_resetScheduled = true;
+    }
+}
+
+} // namespace
+
 void
 GlobalRoutingHelper::Install (Ptr<Node> node)
 {
@@ -231,19 +279,13 @@ void
 GlobalRoutingHelper::CalculateRoutes ()
 {
   /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
+   * Topology is frozen into a compressed sparse row graph and shortest path trees for all nodes are
+   * calculated in parallel (see GlobalRoutingGraph).  FIBs are updated afterwards on the main thread.
    */
-
-  BOOST_CONCEPT_ASSERT(( VertexListGraphConcept< NdnGlobalRouterGraph > ));
-  BOOST_CONCEPT_ASSERT(( IncidenceGraphConcept< NdnGlobalRouterGraph > ));
-
-  NdnGlobalRouterGraph graph;
-  // typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+  boost::shared_ptr<GlobalRoutingGraph> graph = boost::make_shared<GlobalRoutingGraph> ();
+  std::vector<GlobalRoutingGraph::Run> runs;
 
   // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by the graph, which
-  // is not obviously how implement in an efficient manner
   for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
     {
       Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter> ();
@@ -253,87 +295,27 @@ GlobalRoutingHelper::CalculateRoutes ()
 	  continue;
 	}
 
-      DistancesMap    distances;
-
-      dijkstra_shortest_paths (graph, source,
-			       // predecessor_map (boost::ref(predecessors))
-			       // .
-			       distance_map (boost::ref(distances))
-			       .
-			       distance_inf (WeightInf)
-			       .
-			       distance_zero (WeightZero)
-			       .
-			       distance_compare (boost::WeightCompare ())
-			       .
-			       distance_combine (boost::WeightCombine ())
-			       );
-
-      // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
-
       Ptr<Fib>  fib  = source->GetObject<Fib> ();
-      fib->InvalidateAll ();
       NS_ASSERT (fib != 0);
+      fib->InvalidateAll ();
 
-      NS_LOG_DEBUG ("Reachability from Node: " << source->GetObject<Node> ()->GetId ());
-      for (DistancesMap::iterator i = distances.begin ();
-	   i != distances.end ();
-	   i++)
-	{
-	  if (i->first == source)
-	    continue;
-	  else
-	    {
-	      // cout << "  Node " << i->first->GetObject<Node> ()->GetId ();
-	      if (i->second.get<0> () == 0)
-		{
-		  // cout << " is unreachable" << endl;
-		}
-	      else
-		{
-                  BOOST_FOREACH (const Ptr<const Name> &prefix, i->first->GetLocalPrefixes ())
-                    {
-                      NS_LOG_DEBUG (" prefix " << prefix << " reachable via face " << *i->second.get<0> ()
-                                    << " with distance " << i->second.get<1> ()
-                                    << " with delay " << i->second.get<2> ());
-
-                      Ptr<fib::Entry> entry = fib->Add (prefix, i->second.get<0> (), i->second.get<1> ());
-                      entry->SetRealDelayToProducer (i->second.get<0> (), Seconds (i->second.get<2> ()));
-
-                      Ptr<Limits> faceLimits = i->second.get<0> ()->GetObject<Limits> ();
-
-                      Ptr<Limits> fibLimits = entry->GetObject<Limits> ();
-                      if (fibLimits != 0)
-                        {
-                          // if it was created by the forwarding strategy via DidAddFibEntry event
-                          fibLimits->SetLimits (faceLimits->GetMaxRate (), 2 * i->second.get<2> () /*exact RTT*/);
-                          NS_LOG_DEBUG ("Set limit for prefix " << *prefix << " " << faceLimits->GetMaxRate () << " / " <<
-                                        2*i->second.get<2> () << "s (" << faceLimits->GetMaxRate () * 2 * i->second.get<2> () << ")");
-                        }
-                    }
-		}
-	    }
-	}
+      runs.push_back (GlobalRoutingGraph::Run (graph->GetVertex (source)));
     }
+
+  CalculateRoutes (graph, runs, false);
 }
 
 void
 GlobalRoutingHelper::CalculateAllPossibleRoutes ()
 {
   /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
+   * For every face of every node, shortest path trees are calculated as if all other faces of the node
+   * were disabled (i.e., had metric std::numeric_limits<uint16_t>::max ()-1), and routes via
+   * the enabled face are installed
    */
+  boost::shared_ptr<GlobalRoutingGraph> graph = boost::make_shared<GlobalRoutingGraph> ();
+  std::vector<GlobalRoutingGraph::Run> runs;
 
-  BOOST_CONCEPT_ASSERT(( VertexListGraphConcept< NdnGlobalRouterGraph > ));
-  BOOST_CONCEPT_ASSERT(( IncidenceGraphConcept< NdnGlobalRouterGraph > ));
-
-  NdnGlobalRouterGraph graph;
-//  typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
-
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by the graph, which
-  // is not obviously how implement in an efficient manner
   for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
     {
       Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter> ();
@@ -344,101 +326,192 @@ GlobalRoutingHelper::CalculateAllPossibleRoutes ()
 	}
 
       Ptr<Fib>  fib  = source->GetObject<Fib> ();
-      fib->InvalidateAll ();
       NS_ASSERT (fib != 0);
-
-      NS_LOG_DEBUG ("===========");
-      NS_LOG_DEBUG ("Reachability from Node: " << source->GetObject<Node> ()->GetId () << " (" << Names::FindName (source->GetObject<Node> ()) << ")");
+      fib->InvalidateAll ();
 
       Ptr<L3Protocol> l3 = source->GetObject<L3Protocol> ();
       NS_ASSERT (l3 != 0);
 
-      // remember interface statuses
-      std::vector<uint16_t> originalMetric (l3->GetNFaces ());
-      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
-        {
-          originalMetric[faceId] = l3->GetFace (faceId)->GetMetric ();
-          l3->GetFace (faceId)->SetMetric (std::numeric_limits<uint16_t>::max ()-1); // value std::numeric_limits<uint16_t>::max () MUST NOT be used (reserved)
-        }
-
       for (uint32_t enabledFaceId = 0; enabledFaceId < l3->GetNFaces (); enabledFaceId++)
         {
-          if (DynamicCast<ndn::NetDeviceFace> (l3->GetFace (enabledFaceId)) == 0)
+          Ptr<Face> enabledFace = l3->GetFace (enabledFaceId);
+          if (DynamicCast<ndn::NetDeviceFace> (enabledFace) == 0)
             continue;
 
-          // enabling only faceId
-          l3->GetFace (enabledFaceId)->SetMetric (originalMetric[enabledFaceId]);
+          // NO_FACE (all faces are disabled) if the face is not part of the topology
+          runs.push_back (GlobalRoutingGraph::Run (graph->GetVertex (source), graph->GetFaceIndex (enabledFace)));
+        }
+    }
 
-          DistancesMap    distances;
+  CalculateRoutes (graph, runs, true);
+}
 
-          NS_LOG_DEBUG ("-----------");
+void
+GlobalRoutingHelper::EnableIncrementalUpdates ()
+{
+  ScheduleResetRoutingState ();
+  g_routingState.m_incremental = true;
+}
 
-          dijkstra_shortest_paths (graph, source,
-                                   // predecessor_map (boost::ref(predecessors))
-                                   // .
-                                   distance_map (boost::ref(distances))
-                                   .
-                                   distance_inf (WeightInf)
-                                   .
-                                   distance_zero (WeightZero)
-                                   .
-                                   distance_compare (boost::WeightCompare ())
-                                   .
-                                   distance_combine (boost::WeightCombine ())
-                                   );
+void
+GlobalRoutingHelper::UpdateRoutes ()
+{
+  if (g_routingState.m_graph == 0)
+    {
+      NS_LOG_DEBUG ("Routes have not been calculated yet");
+      CalculateRoutes ();
+      return;
+    }
 
-          // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
+  boost::shared_ptr<GlobalRoutingGraph> graph = boost::make_shared<GlobalRoutingGraph> ();
+  if (!g_routingState.m_treesKept || !graph->HasSameStructure (*g_routingState.m_graph))
+    {
+      NS_LOG_DEBUG ("Shortest path trees have not been kept or GlobalRouter interfaces have changed, "
+                    "recalculating all routes");
+      if (g_routingState.m_allPossible)
+        CalculateAllPossibleRoutes ();
+      else
+        CalculateRoutes ();
+      return;
+    }
+
+  std::vector<GlobalRoutingGraph::Change> changes;
+  graph->GetChanges (*g_routingState.m_graph, changes);
+  g_routingState.m_graph = graph;
+  if (changes.empty ())
+    return;
+
+  std::vector< std::vector<uint32_t> > changed;
+  graph->UpdateShortestPaths (g_routingState.m_runs, changes, g_routingState.m_trees, changed);
+
+  // prefixes, routes to which have changed, for every source
+  std::map< uint32_t, std::set<Name> > changedPrefixes;
+  uint32_t nChangedRuns = 0;
+  for (uint32_t i = 0; i < changed.size (); i++)
+    {
+      if (!changed[i].empty ())
+        nChangedRuns ++;
 
-          for (DistancesMap::iterator i = distances.begin ();
-               i != distances.end ();
-               i++)
+      BOOST_FOREACH (uint32_t vertex, changed[i])
+        {
+          BOOST_FOREACH (const Ptr<const Name> &prefix, graph->GetRouter (vertex)->GetLocalPrefixes ())
             {
-              if (i->first == source)
-                continue;
-              else
-                {
-                  // cout << "  Node " << i->first->GetObject<Node> ()->GetId ();
-                  if (i->second.get<0> () == 0)
-                    {
-                      // cout << " is unreachable" << endl;
-                    }
-                  else
-                    {
-                      BOOST_FOREACH (const Ptr<const Name> &prefix, i->first->GetLocalPrefixes ())
-                        {
-                          NS_LOG_DEBUG (" prefix " << *prefix << " reachable via face " << *i->second.get<0> ()
-                                        << " with distance " << i->second.get<1> ()
-                                        << " with delay " << i->second.get<2> ());
-
-                          if (i->second.get<0> ()->GetMetric () == std::numeric_limits<uint16_t>::max ()-1)
-                            continue;
-
-                          Ptr<fib::Entry> entry = fib->Add (prefix, i->second.get<0> (), i->second.get<1> ());
-                          entry->SetRealDelayToProducer (i->second.get<0> (), Seconds (i->second.get<2> ()));
-
-                          Ptr<Limits> faceLimits = i->second.get<0> ()->GetObject<Limits> ();
-
-                          Ptr<Limits> fibLimits = entry->GetObject<Limits> ();
-                          if (fibLimits != 0)
-                            {
-                              // if it was created by the forwarding strategy via DidAddFibEntry event
-                              fibLimits->SetLimits (faceLimits->GetMaxRate (), 2 * i->second.get<2> () /*exact RTT*/);
-                              NS_LOG_DEBUG ("Set limit for prefix " << *prefix << " " << faceLimits->GetMaxRate () << " / " <<
-                                            2*i->second.get<2> () << "s (" << faceLimits->GetMaxRate () * 2 * i->second.get<2> () << ")");
-                            }
-                        }
-                    }
-                }
+              changedPrefixes[g_routingState.m_runs[i].m_source].insert (*prefix);
             }
+        }
+    }
+  NS_LOG_DEBUG (changes.size () << " edges have changed, " << nChangedRuns << " out of "
+                << g_routingState.m_runs.size () << " shortest path trees have changed");
+
+  // FIB entries are rebuilt from all runs of the source, the same way as CalculateRoutes would do
+  for (std::map< uint32_t, std::set<Name> >::iterator source = changedPrefixes.begin ();
+       source != changedPrefixes.end ();
+       source++)
+    {
+      Ptr<Fib> fib = graph->GetRouter (source->first)->GetObject<Fib> ();
+      BOOST_FOREACH (const Name &prefix, source->second)
+        {
+          fib->Invalidate (Create<Name> (prefix));
+        }
+    }
 
-          // disabling the face again
-          l3->GetFace (enabledFaceId)->SetMetric (std::numeric_limits<uint16_t>::max ()-1);
+  for (uint32_t i = 0; i < g_routingState.m_runs.size (); i++)
+    {
+      std::map< uint32_t, std::set<Name> >::iterator source = changedPrefixes.find (g_routingState.m_runs[i].m_source);
+      if (source != changedPrefixes.end ())
+        {
+          InstallRoutes (*graph, g_routingState.m_runs[i], g_routingState.m_trees[i].m_distances, &source->second);
         }
+    }
+}
 
-      // recover original interface statuses
-      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
+void
+GlobalRoutingHelper::CalculateRoutes (boost::shared_ptr<GlobalRoutingGraph> graph,
+                                      const std::vector<GlobalRoutingGraph::Run> &runs,
+                                      bool allPossible)
+{
+  ScheduleResetRoutingState ();
+
+  g_routingState.m_graph = graph;
+  g_routingState.m_allPossible = allPossible;
+  g_routingState.m_treesKept = g_routingState.m_incremental;
+  if (g_routingState.m_incremental)
+    {
+      g_routingState.m_runs = runs;
+      graph->ShortestPaths (runs, g_routingState.m_trees);
+
+      for (uint32_t i = 0; i < runs.size (); i++)
         {
-          l3->GetFace (faceId)->SetMetric (originalMetric[faceId]);
+          InstallRoutes (*graph, runs[i], g_routingState.m_trees[i].m_distances);
+        }
+      return;
+    }
+
+  g_routingState.m_runs.clear ();
+  g_routingState.m_trees.clear ();
+
+  // runs are calculated in batches, so memory is needed only for trees of one batch
+  uint32_t batchSize = GlobalRoutingGraph::GetNThreads () * RUNS_PER_THREAD;
+  for (uint32_t begin = 0; begin < runs.size (); begin += batchSize)
+    {
+      std::vector<GlobalRoutingGraph::Run> batch (runs.begin () + begin,
+                                                  runs.begin () + std::min<uint32_t> (begin + batchSize, runs.size ()));
+      std::vector<GlobalRoutingGraph::Tree> trees;
+      graph->ShortestPaths (batch, trees);
+
+      for (uint32_t i = 0; i < batch.size (); i++)
+        {
+          InstallRoutes (*graph, batch[i], trees[i].m_distances);
+        }
+    }
+}
+
+void
+GlobalRoutingHelper::InstallRoutes (const GlobalRoutingGraph &graph, const GlobalRoutingGraph::Run &run,
+                                    const std::vector<GlobalRoutingGraph::Distance> &distances,
+                                    const std::set<Name> *prefixes/* = 0*/)
+{
+  Ptr<GlobalRouter> source = graph.GetRouter (run.m_source);
+  Ptr<Fib> fib = source->GetObject<Fib> ();
+
+  NS_LOG_DEBUG ("Reachability from Node: " << source->GetObject<Node> ()->GetId ());
+  for (uint32_t vertex = 0; vertex < distances.size (); vertex++)
+    {
+      if (vertex == run.m_source)
+        continue;
+
+      const GlobalRoutingGraph::Distance &distance = distances[vertex];
+      if (distance.m_face == GlobalRoutingGraph::NO_FACE)
+        continue; // unreachable
+
+      Ptr<Face> face = graph.GetFace (distance.m_face);
+      BOOST_FOREACH (const Ptr<const Name> &prefix, graph.GetRouter (vertex)->GetLocalPrefixes ())
+        {
+          if (prefixes != 0 && prefixes->count (*prefix) == 0)
+            continue;
+
+          NS_LOG_DEBUG (" prefix " << *prefix << " reachable via face " << *face
+                        << " with distance " << distance.m_metric
+                        << " with delay " << distance.m_delay);
+
+          // all faces of the source, except the enabled one, are considered disabled
+          if (run.m_enabledFace != GlobalRoutingGraph::ALL_FACES &&
+              (distance.m_face != run.m_enabledFace || face->GetMetric () == GlobalRoutingGraph::DISABLED_METRIC))
+            continue;
+
+          Ptr<fib::Entry> entry = fib->Add (prefix, face, distance.m_metric);
+          entry->SetRealDelayToProducer (face, Seconds (distance.m_delay));
+
+          Ptr<Limits> faceLimits = face->GetObject<Limits> ();
+
+          Ptr<Limits> fibLimits = entry->GetObject<Limits> ();
+          if (fibLimits != 0)
+            {
+              // if it was created by the forwarding strategy via DidAddFibEntry event
+              fibLimits->SetLimits (faceLimits->GetMaxRate (), 2 * distance.m_delay /*exact RTT*/);
+              NS_LOG_DEBUG ("Set limit for prefix " << *prefix << " " << faceLimits->GetMaxRate () << " / " <<
+                            2*distance.m_delay << "s (" << faceLimits->GetMaxRate () * 2 * distance.m_delay << ")");
+            }
         }
     }
 }
@@ -22,6 +22,11 @@
 #define NDN_GLOBAL_ROUTING_HELPER_H
 
 #include "ns3/ptr.h"
+#include "ns3/ndn-global-routing-graph.h"
+
+#include <boost/shared_ptr.hpp>
+#include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -31,6 +36,8 @@ class Channel;
 
 namespace ndn {
 
+class Name;
+
 /**
  * @ingroup ndn
  * @brief Helper for GlobalRouter interface
@@ -97,6 +104,8 @@ public:
 
   /**
    * @brief Calculate for every node shortest path trees and install routes to all prefix origins
+   *
+   * Shortest path trees are kept for UpdateRoutes only if EnableIncrementalUpdates has been called
    */
   static void
   CalculateRoutes ();
@@ -111,9 +120,55 @@ public:
   static void
   CalculateAllPossibleRoutes ();
 
+  /**
+   * @brief Keep shortest path trees of route calculations, so UpdateRoutes can update routes incrementally
+   *
+   * Should be called before CalculateRoutes or CalculateAllPossibleRoutes.  Trees need memory for
+   * a distance and a parent of every vertex for every node (for every face of every node in case of
+   * CalculateAllPossibleRoutes), so they are not kept by default.  The setting is reset by Simulator::Destroy.
+   */
+  static void
+  EnableIncrementalUpdates ();
+
+  /**
+   * @brief Update routes after face metrics or face states have changed (e.g., link failure or recovery)
+   *
+   * Only shortest path trees that can be affected by the changed faces are recalculated, and only FIB
+   * entries of prefixes whose routes have changed are updated (both are done the same way as by the last
+   * call of CalculateRoutes or CalculateAllPossibleRoutes).  When there are several equal-cost paths, the
+   * existing routes are kept.  All routes are recalculated if GlobalRouter interfaces have been
+   * installed after the last calculation, or if shortest path trees have not been kept (see
+   * EnableIncrementalUpdates).
+   *
+   * Can be scheduled during the simulation, e.g., right after Face::SetUp (false) on both faces of
+   * a failed link.
+   */
+  static void
+  UpdateRoutes ();
+
 private:
   void
   Install (Ptr<Channel> channel);
+
+  /**
+   * @brief Calculate shortest path trees for all runs (in parallel) and install the routes
+   *
+   * Trees are kept for UpdateRoutes if incremental updates are enabled, otherwise runs are calculated
+   * in batches to bound the memory needed for the trees
+   */
+  static void
+  CalculateRoutes (boost::shared_ptr<GlobalRoutingGraph> graph, const std::vector<GlobalRoutingGraph::Run> &runs,
+                   bool allPossible);
+
+  /**
+   * @brief Install routes from the source of the run to all reachable prefix origins
+   *
+   * @param prefixes if not 0, only routes to these prefixes are installed
+   */
+  static void
+  InstallRoutes (const GlobalRoutingGraph &graph, const GlobalRoutingGraph::Run &run,
+                 const std::vector<GlobalRoutingGraph::Distance> &distances,
+                 const std::set<Name> *prefixes = 0);
 };
 
 } // namespace ndn
@@ -115,6 +115,22 @@ HeaderHelper::GetName (Ptr<const Packet> p)
   return 0;
 }
 
+bool
+HeaderHelper::GetInterestClass (Ptr<const Packet> packet, uint8_t &priority, uint8_t &nackType)
+{
+  uint8_t prefix[Interest::RESERVED_FIELD_OFFSET + 1];
+  uint32_t read = packet->CopyData (prefix, sizeof (prefix));
+
+  if (read != sizeof (prefix) ||
+      prefix[0] != INTEREST_NDNSIM_BYTES[0] || prefix[1] != INTEREST_NDNSIM_BYTES[1])
+    return false;
+
+  uint8_t reserved = prefix[Interest::RESERVED_FIELD_OFFSET];
+  priority = Interest::GetPriorityFromReservedField (reserved);
+  nackType = Interest::GetNackFromReservedField (reserved);
+  return true;
+}
+
 
 } // namespace ndn
 } // namespace ns3
@@ -99,6 +99,22 @@ public:
    */
   static Ptr<const Name>
   GetName (Ptr<const Packet> packet);
+
+  /**
+   * @brief A light-weight operation to get priority and NACK type of the ndnSIM Interest packet
+   *
+   * This function peeks the reserved byte at the fixed offset of the Interest (see
+   * Interest::CreateReservedField) directly from the packet buffer, without copying the
+   * packet or deserializing the Interest
+   *
+   * @param packet   packet to classify
+   * @param priority [out] priority type of the Interest
+   * @param nackType [out] NACK type of the Interest (Interest::NORMAL_INTEREST for normal Interests)
+   *
+   * @returns false if packet is not an ndnSIM Interest (output parameters are not modified)
+   */
+  static bool
+  GetInterestClass (Ptr<const Packet> packet, uint8_t &priority, uint8_t &nackType);
 };
 
   /**
@@ -24,6 +24,9 @@
 #include "../../utils/trie/lru-policy.h"
 #include "../../utils/trie/fifo-policy.h"
 #include "../../utils/trie/lfu-policy.h"
+#include "../../utils/trie/tinylfu-policy.h"
+#include "../../utils/trie/two-queue-policy.h"
+#include "../../utils/trie/arc-policy.h"
 
 #define NS_OBJECT_ENSURE_REGISTERED_TEMPL(type, templ)  \
   static struct X ## type ## templ ## RegistrationClass \
@@ -62,11 +65,35 @@ template class ContentStoreImpl<fifo_policy_traits>;
  **/
 template class ContentStoreImpl<lfu_policy_traits>;
 
+/**
+ * @brief ContentStore with LFU with dynamic aging cache replacement policy
+ **/
+template class ContentStoreImpl<lfu_aging_policy_traits>;
+
+/**
+ * @brief ContentStore with LRU with TinyLFU admission cache replacement policy
+ **/
+template class ContentStoreImpl<tinylfu_policy_traits>;
+
+/**
+ * @brief ContentStore with 2Q cache replacement policy
+ **/
+template class ContentStoreImpl<two_queue_policy_traits>;
+
+/**
+ * @brief ContentStore with Adaptive Replacement Cache (ARC) policy
+ **/
+template class ContentStoreImpl<arc_policy_traits>;
+
 NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreImpl, lru_policy_traits);
 NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreImpl, random_policy_traits);
 NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreImpl, fifo_policy_traits);
 
 NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreImpl, lfu_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreImpl, lfu_aging_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreImpl, tinylfu_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreImpl, two_queue_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreImpl, arc_policy_traits);
 
 #ifdef DOXYGEN
 // /**
@@ -88,6 +115,26 @@ class Random : public ContentStoreImpl<random_policy_traits> { };
  * \brief Content Store implementing Least Frequently Used cache replacement policy
  */
 class Lfu : public ContentStoreImpl<lfu_policy_traits> { };
+
+/**
+ * \brief Content Store implementing LFU with dynamic aging cache replacement policy
+ */
+class LfuAging : public ContentStoreImpl<lfu_aging_policy_traits> { };
+
+/**
+ * \brief Content Store implementing LRU with TinyLFU admission cache replacement policy
+ */
+class TinyLfu : public ContentStoreImpl<tinylfu_policy_traits> { };
+
+/**
+ * \brief Content Store implementing 2Q cache replacement policy
+ */
+class TwoQueue : public ContentStoreImpl<two_queue_policy_traits> { };
+
+/**
+ * \brief Content Store implementing Adaptive Replacement Cache (ARC) policy
+ */
+class Arc : public ContentStoreImpl<arc_policy_traits> { };
 #endif
 
 
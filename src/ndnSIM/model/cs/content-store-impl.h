@@ -110,6 +110,15 @@ public:
   virtual Ptr<Entry>
   Next (Ptr<Entry>);
 
+protected:
+  /**
+   * @brief Check if the cache entry can no longer be returned by Lookup
+   *
+   * Lookup removes such entries from the cache when it finds them.  By default, entries never become stale.
+   */
+  virtual inline bool
+  IsStale (typename super::iterator item) const;
+
 private:
   void
   SetMaxSize (uint32_t maxSize);
@@ -162,7 +171,14 @@ ContentStoreImpl<Policy>::Lookup (Ptr<const Interest> interest)
   NS_LOG_FUNCTION (this << interest->GetName ());
 
   /// @todo Change to search with predicate
-  typename super::const_iterator node = this->deepest_prefix_match (interest->GetName ());
+  typename super::iterator node = this->deepest_prefix_match (interest->GetName ());
+
+  while (node != this->end () && IsStale (node))
+    {
+      NS_LOG_DEBUG (node->payload ()->GetName () << " is stale");
+      super::erase (node);
+      node = this->deepest_prefix_match (interest->GetName ());
+    }
 
   if (node != this->end ())
     {
@@ -181,6 +197,13 @@ ContentStoreImpl<Policy>::Lookup (Ptr<const Interest> interest)
     }
 }
 
+template<class Policy>
+bool
+ContentStoreImpl<Policy>::IsStale (typename super::iterator item) const
+{
+  return false;
+}
+
 template<class Policy>
 bool
 ContentStoreImpl<Policy>::Add (Ptr<const ContentObject> header, Ptr<const Packet> packet)
@@ -26,6 +26,10 @@
 #include "../../utils/trie/multi-policy.h"
 #include "custom-policies/freshness-policy.h"
 
+#include "ns3/string.h"
+
+#include <boost/bind.hpp>
+
 namespace ns3 {
 namespace ndn {
 namespace cs {
@@ -42,6 +46,8 @@ public:
   static TypeId
   GetTypeId ();
 
+  ContentStoreWithFreshness ();
+
   virtual inline void
   Print (std::ostream &os) const;
 
@@ -55,11 +61,24 @@ private:
   inline void
   RescheduleCleaning ();
 
+  inline void
+  EraseExpired (typename super::parent_trie &item);
+
+  // stale entries that have not yet been drained by the expiration wheel are removed lazily by Lookup
+  virtual inline bool
+  IsStale (typename super::iterator item) const;
+
+  inline Time
+  GetExpirationTick () const;
+
+  inline void
+  SetExpirationTick (const Time &tick);
+
 private:
   static LogComponent g_log; ///< @brief Logging variable
 
   EventId m_cleanEvent;
-  Time m_scheduledCleaningTime;
+  uint64_t m_cleanTick; ///< @brief Tick of the expiration wheel at which m_cleanEvent is scheduled
 };
 
 //////////////////////////////////////////
@@ -81,13 +100,25 @@ ContentStoreWithFreshness< Policy >::GetTypeId ()
     .SetParent<super> ()
     .template AddConstructor< ContentStoreWithFreshness< Policy > > ()
 
-    // trace stuff here
+    .AddAttribute ("ExpirationTick",
+                   "Granularity of freshness expiration. Stale entries are never returned by lookups, "
+                   "but are removed from the store in batches at the first tick not earlier than their expiration time",
+                   StringValue ("10ms"),
+                   MakeTimeAccessor (&ContentStoreWithFreshness< Policy >::GetExpirationTick,
+                                     &ContentStoreWithFreshness< Policy >::SetExpirationTick),
+                   MakeTimeChecker ())
     ;
 
   return tid;
 }
 
 
+template<class Policy>
+ContentStoreWithFreshness< Policy >::ContentStoreWithFreshness ()
+  : m_cleanTick (0)
+{
+}
+
 template<class Policy>
 inline bool
 ContentStoreWithFreshness< Policy >::Add (Ptr<const ContentObject> header, Ptr<const Packet> packet)
@@ -96,7 +127,15 @@ ContentStoreWithFreshness< Policy >::Add (Ptr<const ContentObject> header, Ptr<c
   if (!ok) return false;
 
   NS_LOG_DEBUG (header->GetName () << " added to cache");
-  RescheduleCleaning ();
+
+  // the cleaning event is moved only if the new entry expires earlier than the currently scheduled tick
+  if (!header->GetFreshness ().IsZero ())
+    {
+      int64_t tick = GetExpirationTick ().GetTimeStep ();
+      uint64_t expireTick = ((Simulator::Now () + header->GetFreshness ()).GetTimeStep () + tick - 1) / tick;
+      if (!m_cleanEvent.IsRunning () || expireTick < m_cleanTick)
+        RescheduleCleaning ();
+    }
   return true;
 }
 
@@ -106,32 +145,20 @@ ContentStoreWithFreshness< Policy >::RescheduleCleaning ()
 {
   const freshness_policy_container &freshness = this->getPolicy ().template get<freshness_policy_container> ();
 
-  if (freshness.size () > 0)
-    {
-      Time nextStateTime = freshness_policy_container::policy_base::get_freshness (&(*freshness.begin ()));
-
-      if (m_scheduledCleaningTime.IsZero () || // if not yet scheduled
-          m_scheduledCleaningTime > nextStateTime) // if new item expire sooner than already scheduled
-        {
-          if (m_cleanEvent.IsRunning ())
-            {
-              Simulator::Remove (m_cleanEvent); // just canceling would not clean up list of events
-            }
-
-          // NS_LOG_DEBUG ("Next event in: " << (nextStateTime - Now ()).ToDouble (Time::S) << "s");
-          m_cleanEvent = Simulator::Schedule (nextStateTime - Now (), &ContentStoreWithFreshness< Policy >::CleanExpired, this);
-          m_scheduledCleaningTime = nextStateTime;
-        }
-    }
-  else
-    {
-      if (m_cleanEvent.IsRunning ())
-        {
-          Simulator::Remove (m_cleanEvent); // just canceling would not clean up list of events
-        }
-    }
-}
+  Simulator::Remove (m_cleanEvent); // just canceling would not clean up list of events
+
+  uint64_t nextTick = freshness.next_tick ();
+  if (nextTick == freshness_policy_container::NONE)
+    return;
+
+  Time nextTime = TimeStep (nextTick * freshness.get_tick ().GetTimeStep ());
+  Time nextEvent = nextTime - Simulator::Now ();
+  if (nextEvent <= 0) nextEvent = Seconds (0);
 
+  // NS_LOG_DEBUG ("Next event in: " << nextEvent.ToDouble (Time::S) << "s");
+  m_cleanTick = nextTick;
+  m_cleanEvent = Simulator::Schedule (nextEvent, &ContentStoreWithFreshness< Policy >::CleanExpired, this);
+}
 
 template<class Policy>
 inline void
@@ -140,25 +167,46 @@ ContentStoreWithFreshness< Policy >::CleanExpired ()
   freshness_policy_container &freshness = this->getPolicy ().template get<freshness_policy_container> ();
 
   // NS_LOG_LOGIC (">> Cleaning: Total number of items:" << this->getPolicy ().size () << ", items with freshness: " << freshness.size ());
-  Time now = Simulator::Now ();
-
-  while (!freshness.empty ())
-    {
-      typename freshness_policy_container::iterator entry = freshness.begin ();
-
-      if (freshness_policy_container::policy_base::get_freshness (&(*entry)) <= now) // is the record stale?
-        {
-          super::erase (&(*entry));
-        }
-      else
-        break; // nothing else to do. All later records will not be stale
-    }
+  freshness.advance (freshness.get_current_tick (),
+                     boost::bind (&ContentStoreWithFreshness< Policy >::EraseExpired, this, _1));
   // NS_LOG_LOGIC ("<< Cleaning: Total number of items:" << this->getPolicy ().size () << ", items with freshness: " << freshness.size ());
 
-  m_scheduledCleaningTime = Time ();
   RescheduleCleaning ();
 }
 
+template<class Policy>
+inline void
+ContentStoreWithFreshness< Policy >::EraseExpired (typename super::parent_trie &item)
+{
+  super::erase (&item);
+}
+
+template<class Policy>
+inline bool
+ContentStoreWithFreshness< Policy >::IsStale (typename super::iterator item) const
+{
+  return !item->payload ()->GetHeader ()->GetFreshness ().IsZero () &&
+    freshness_policy_container::policy_base::get_freshness (item) <= Simulator::Now ();
+}
+
+template<class Policy>
+inline Time
+ContentStoreWithFreshness< Policy >::GetExpirationTick () const
+{
+  return this->getPolicy ().template get<freshness_policy_container> ().get_tick ();
+}
+
+template<class Policy>
+inline void
+ContentStoreWithFreshness< Policy >::SetExpirationTick (const Time &tick)
+{
+  freshness_policy_container &freshness = this->getPolicy ().template get<freshness_policy_container> ();
+  NS_ASSERT_MSG (freshness.empty (), "Expiration tick can be changed only when content store is empty");
+  NS_ASSERT_MSG (tick.IsStrictlyPositive (), "Expiration tick should be positive");
+
+  freshness.set_tick (tick);
+}
+
 template<class Policy>
 void
 ContentStoreWithFreshness< Policy >::Print (std::ostream &os) const
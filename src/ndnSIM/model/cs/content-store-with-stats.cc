@@ -24,6 +24,9 @@
 #include "../../utils/trie/lru-policy.h"
 #include "../../utils/trie/fifo-policy.h"
 #include "../../utils/trie/lfu-policy.h"
+#include "../../utils/trie/tinylfu-policy.h"
+#include "../../utils/trie/two-queue-policy.h"
+#include "../../utils/trie/arc-policy.h"
 
 #define NS_OBJECT_ENSURE_REGISTERED_TEMPL(type, templ)  \
   static struct X ## type ## templ ## RegistrationClass \
@@ -62,11 +65,35 @@ template class ContentStoreWithStats<fifo_policy_traits>;
  **/
 template class ContentStoreWithStats<lfu_policy_traits>;
 
+/**
+ * @brief ContentStore with stats and LFU with dynamic aging cache replacement policy
+ **/
+template class ContentStoreWithStats<lfu_aging_policy_traits>;
+
+/**
+ * @brief ContentStore with stats and LRU with TinyLFU admission cache replacement policy
+ **/
+template class ContentStoreWithStats<tinylfu_policy_traits>;
+
+/**
+ * @brief ContentStore with stats and 2Q cache replacement policy
+ **/
+template class ContentStoreWithStats<two_queue_policy_traits>;
+
+/**
+ * @brief ContentStore with stats and Adaptive Replacement Cache (ARC) policy
+ **/
+template class ContentStoreWithStats<arc_policy_traits>;
+
 NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreWithStats, lru_policy_traits);
 NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreWithStats, random_policy_traits);
 NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreWithStats, fifo_policy_traits);
 
 NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreWithStats, lfu_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreWithStats, lfu_aging_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreWithStats, tinylfu_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreWithStats, two_queue_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreWithStats, arc_policy_traits);
 
 
 #ifdef DOXYGEN
@@ -90,6 +117,26 @@ class Stats::Random : public ContentStoreWithStats<random_policy_traits> { };
  */
 class Stats::Lfu : public ContentStoreWithStats<lfu_policy_traits> { };
 
+/**
+ * \brief Content Store with stats implementing LFU with dynamic aging cache replacement policy
+ */
+class Stats::LfuAging : public ContentStoreWithStats<lfu_aging_policy_traits> { };
+
+/**
+ * \brief Content Store with stats implementing LRU with TinyLFU admission cache replacement policy
+ */
+class Stats::TinyLfu : public ContentStoreWithStats<tinylfu_policy_traits> { };
+
+/**
+ * \brief Content Store with stats implementing 2Q cache replacement policy
+ */
+class Stats::TwoQueue : public ContentStoreWithStats<two_queue_policy_traits> { };
+
+/**
+ * \brief Content Store with stats implementing Adaptive Replacement Cache (ARC) policy
+ */
+class Stats::Arc : public ContentStoreWithStats<arc_policy_traits> { };
+
 #endif
 
 
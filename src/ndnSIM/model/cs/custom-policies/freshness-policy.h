@@ -28,19 +28,25 @@
 #include <ns3/simulator.h>
 #include <ns3/traced-callback.h>
 
+#include "ns3/ndnSIM/utils/timer-wheel.h"
+
 namespace ns3 {
 namespace ndn {
 namespace ndnSIM {
 
 /**
  * @brief Traits for freshness policy
+ *
+ * Items with non-zero freshness are kept in a timing wheel with configurable tick, so
+ * insertion and removal are O(1) and expired items are drained in batches, one batch per
+ * tick (see ContentStoreWithFreshness).
  */
 struct freshness_policy_traits
 {
   /// @brief Name that can be used to identify the policy (for NS-3 object model and logging)
   static std::string GetName () { return "Freshness"; }
 
-  struct policy_hook_type : public boost::intrusive::set_member_hook<> { Time timeWhenShouldExpire; };
+  struct policy_hook_type : public boost::intrusive::list_member_hook<> { Time timeWhenShouldExpire; };
 
   template<class Container>
   struct container_hook
@@ -55,31 +61,38 @@ struct freshness_policy_traits
            class Hook>
   struct policy
   {
+    typedef boost::intrusive::list< Container, Hook > policy_list;
+
     static Time& get_freshness (typename Container::iterator item)
     {
-      return static_cast<typename policy_container::value_traits::hook_type*>
-        (policy_container::value_traits::to_node_ptr(*item))->timeWhenShouldExpire;
+      return static_cast<typename policy_list::value_traits::hook_type*>
+        (policy_list::value_traits::to_node_ptr(*item))->timeWhenShouldExpire;
     }
 
     static const Time& get_freshness (typename Container::const_iterator item)
     {
-      return static_cast<const typename policy_container::value_traits::hook_type*>
-        (policy_container::value_traits::to_node_ptr(*item))->timeWhenShouldExpire;
+      return static_cast<const typename policy_list::value_traits::hook_type*>
+        (policy_list::value_traits::to_node_ptr(*item))->timeWhenShouldExpire;
     }
 
-    template<class Key>
-    struct MemberHookLess
+    /**
+     * @brief Tick of the timing wheel at which the item becomes stale (rounded up)
+     */
+    struct expire_tick
     {
-      bool operator () (const Key &a, const Key &b) const
+      expire_tick (int64_t tick = 1) : m_tick (tick) { }
+
+      uint64_t
+      operator () (const Container &item) const
       {
-        return get_freshness (&a) < get_freshness (&b);
+        int64_t expire = get_freshness (&item).GetTimeStep ();
+        return static_cast<uint64_t> ((expire + m_tick - 1) / m_tick);
       }
-    };
 
-    typedef boost::intrusive::multiset< Container,
-                                   boost::intrusive::compare< MemberHookLess< Container > >,
-                                   Hook > policy_container;
+      int64_t m_tick;
+    };
 
+    typedef basic_timer_wheel< Container, Hook, expire_tick > policy_container;
 
     class type : public policy_container
     {
@@ -110,7 +123,7 @@ struct freshness_policy_traits
 
             // push item only if freshness is non zero. otherwise, this payload is not controlled by the policy
             // note that .size() on this policy would return only number of items with non-infinite freshness policy
-            policy_container::push_back (*item);
+            policy_container::insert (*item, get_current_tick ());
           }
 
         return true;
@@ -125,11 +138,8 @@ struct freshness_policy_traits
       inline void
       erase (typename parent_trie::iterator item)
       {
-        if (!item->payload ()->GetHeader ()->GetFreshness ().IsZero ())
-          {
-            // erase only if freshness is non zero (otherwise an item is not in the policy
-            policy_container::erase (policy_container::s_iterator_to (*item));
-          }
+        // no-op for items with zero freshness, they are not in the wheel
+        policy_container::erase (*item);
       }
 
       inline void
@@ -150,6 +160,27 @@ struct freshness_policy_traits
         return max_size_;
       }
 
+      /**
+       * @brief Set granularity of the expiration (only allowed when there are no items)
+       */
+      inline void
+      set_tick (const Time &tick)
+      {
+        policy_container::set_tick_of (expire_tick (tick.GetTimeStep ()));
+      }
+
+      inline Time
+      get_tick () const
+      {
+        return TimeStep (policy_container::tick_of ().m_tick);
+      }
+
+      inline uint64_t
+      get_current_tick () const
+      {
+        return Simulator::Now ().GetTimeStep () / policy_container::tick_of ().m_tick;
+      }
+
     private:
       type () : base_(*((Base*)0)) { };
 
@@ -23,6 +23,7 @@
 #include "ndn-content-store.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
+#include "ns3/boolean.h"
 #include "ns3/ndn-name.h"
 #include "ns3/ndn-interest.h"
 #include "ns3/ndn-content-object.h"
@@ -41,6 +42,12 @@ ContentStore::GetTypeId (void)
     .SetGroupName ("Ndn")
     .SetParent<Object> ()
 
+    .AddAttribute ("CacheWireFormat",
+                   "Keep fully formed packet in content store entries, so cache hits do not re-encode ContentObject",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&ContentStore::m_cacheWireFormat),
+                   MakeBooleanChecker ())
+
     .AddTraceSource ("CacheHits", "Trace called every time there is a cache hit",
                      MakeTraceSourceAccessor (&ContentStore::m_cacheHitsTrace))
 
@@ -51,6 +58,10 @@ ContentStore::GetTypeId (void)
   return tid;
 }
 
+ContentStore::ContentStore ()
+  : m_cacheWireFormat (true)
+{
+}
 
 ContentStore::~ContentStore () 
 {
@@ -72,9 +83,18 @@ Entry::GetFullyFormedNdnPacket () const
 {
   static ContentObjectTail tail; ///< \internal for optimization purposes
 
+  if (m_wire != 0)
+    return m_wire->Copy ();
+
   Ptr<Packet> packet = m_packet->Copy ();
   packet->AddHeader (*m_header);
   packet->AddTrailer (tail);
+
+  if (m_cs != 0 && m_cs->m_cacheWireFormat)
+    {
+      m_wire = packet;
+      return packet->Copy ();
+    }
   return packet;
 }
 
@@ -56,7 +56,10 @@ namespace cs {
  * construct a fully formed NDN Packet by calling Copy(), AddHeader(),
  * AddTail() on the packet received by GetPacket() method.
  *
- * GetFullyFormedNdnPacket method provided as a convenience
+ * GetFullyFormedNdnPacket method provided as a convenience.  Unless disabled by
+ * ContentStore's CacheWireFormat attribute, the fully formed packet is encoded on the
+ * first request and kept in the entry, so subsequent cache hits return a copy-on-write
+ * copy of it without serializing the header again.
  */
 class Entry : public SimpleRefCount<Entry>
 {
@@ -110,6 +113,7 @@ private:
   Ptr<ContentStore> m_cs; ///< \brief content store to which entry is added
   Ptr<const ContentObject> m_header; ///< \brief non-modifiable ContentObject
   Ptr<Packet> m_packet; ///< \brief non-modifiable content of the ContentObject packet
+  mutable Ptr<const Packet> m_wire; ///< \brief cached fully formed packet (0 until first requested)
 };
 
 } // namespace cs
@@ -132,6 +136,11 @@ public:
   static
   TypeId GetTypeId ();
 
+  /**
+   * @brief Default constructor
+   */
+  ContentStore ();
+
   /**
    * @brief Virtual destructor
    */
@@ -216,6 +225,10 @@ protected:
                  Ptr<const ContentObject> > m_cacheHitsTrace; ///< @brief trace of cache hits
 
   TracedCallback<Ptr<const Interest> > m_cacheMissesTrace; ///< @brief trace of cache misses
+
+private:
+  friend class cs::Entry;
+  bool m_cacheWireFormat; ///< @brief whether entries keep fully formed packets
 };
 
 inline std::ostream&
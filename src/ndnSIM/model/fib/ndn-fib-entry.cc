@@ -90,18 +90,53 @@ FaceMetric::UpdateCounter (const bool nack)
 void
 FaceMetric::RecalculateNackRatio ()
 {
+  double oldRatio = m_nackRatio;
   double sample = m_nack>0 ? 1.0 * m_nack / (m_nack + m_data) : 0.0;
   m_nackRatio = m_nackRatio * 0.875 + sample * 0.125;
   if (m_nackRatio < 1e-6)
     m_nackRatio = 1e-6;
 
+  if (m_entry != 0 && m_nackRatio != oldRatio)
+    m_entry->m_version ++;
+
   m_nack = 0;
   m_data = 0;
   Simulator::Schedule (Seconds (0.1), &FaceMetric::RecalculateNackRatio, this);
 }
 
+void
+FaceMetric::SetNackRate (double nackRatio)
+{
+  if (m_entry != 0 && m_nackRatio != nackRatio)
+    m_entry->m_version ++;
+
+  m_nackRatio = nackRatio;
+}
+
 /////////////////////////////////////////////////////////////////////
 
+void
+Entry::ReorderFaces ()
+{
+  const FaceMetricContainer::type::index<i_metric>::type &byMetric = m_faces.get<i_metric> ();
+  const FaceMetricContainer::type::index<i_nth>::type &byNth = m_faces.get<i_nth> ();
+
+  FaceMetricContainer::type::index<i_metric>::type::const_iterator metric = byMetric.begin ();
+  FaceMetricContainer::type::index<i_nth>::type::const_iterator nth = byNth.begin ();
+  while (metric != byMetric.end () && &*metric == &*nth)
+    {
+      metric ++;
+      nth ++;
+    }
+
+  if (metric == byMetric.end ())
+    return; // already in the right order
+
+  // reordering random access index same way as by metric index
+  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
+  m_version ++;
+}
+
 void
 Entry::UpdateFaceRtt (Ptr<Face> face, const Time &sample)
 {
@@ -112,8 +147,7 @@ Entry::UpdateFaceRtt (Ptr<Face> face, const Time &sample)
   m_faces.modify (record,
                   ll::bind (&FaceMetric::UpdateRtt, ll::_1, sample));
 
-  // reordering random access index same way as by metric index
-  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
+  ReorderFaces ();
 }
 
 void
@@ -128,8 +162,7 @@ Entry::UpdateStatus (Ptr<Face> face, FaceMetric::Status status)
   m_faces.modify (record,
                   ll::bind (&FaceMetric::SetStatus, ll::_1, status));
 
-  // reordering random access index same way as by metric index
-  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
+  ReorderFaces ();
 }
 
 void
@@ -142,8 +175,7 @@ Entry::UpdateFaceCounter (Ptr<Face> face, const bool nack)
   m_faces.modify (record,
                   ll::bind (&FaceMetric::UpdateCounter, ll::_1, nack));
 
-  // reordering random access index same way as by metric index
-  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
+  ReorderFaces ();
 }
 
 void
@@ -155,7 +187,11 @@ Entry::AddOrUpdateRoutingMetric (Ptr<Face> face, int32_t metric)
   FaceMetricByFace::type::iterator record = m_faces.get<i_face> ().find (face);
   if (record == m_faces.get<i_face> ().end ())
     {
-      m_faces.insert (FaceMetric (face, metric));
+      FaceMetric &added = const_cast<FaceMetric&> (*m_faces.insert (FaceMetric (face, metric)).first);
+      added.m_entry = this;
+      m_version ++;
+      if (m_fib != 0)
+        m_fib->m_faceIndex.insert (face->GetId (), added);
     }
   else
   {
@@ -170,8 +206,7 @@ Entry::AddOrUpdateRoutingMetric (Ptr<Face> face, int32_t metric)
       }
   }
 
-  // reordering random access index same way as by metric index
-  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
+  ReorderFaces ();
 }
 
 void
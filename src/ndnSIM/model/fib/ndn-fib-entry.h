@@ -28,6 +28,8 @@
 #include "ns3/ndn-limits.h"
 #include "ns3/traced-value.h"
 
+#include "ns3/ndnSIM/utils/face-index.h"
+
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/tag.hpp>
 #include <boost/multi_index/ordered_index.hpp>
@@ -47,6 +49,8 @@ class Fib;
 
 namespace fib {
 
+class Entry;
+
 /**
  * \ingroup ndn
  * \brief Structure holding various parameters associated with a (FibEntry, Face) tuple
@@ -78,6 +82,7 @@ public:
     , m_sRtt   (Seconds (0))
     , m_rttVar (Seconds (0))
     , m_realDelay (Seconds (0))
+    , m_entry (0)
   { }
 
   /**
@@ -167,10 +172,7 @@ public:
    * @brief Set NACK ratio
    */
   void
-  SetNackRate (double nackRatio)
-  {
-    m_nackRatio = nackRatio;
-  }
+  SetNackRate (double nackRatio);
 
   /**
    * @brief Get real propagation delay to the producer, calculated based on NS-3 p2p link delays
@@ -221,8 +223,17 @@ private:
   Time m_rttVar;       ///< \brief round-trip time variation
 
   Time m_realDelay;    ///< \brief real propagation delay to the producer, calculated based on NS-3 p2p link delays
+
+public:
+  Entry *m_entry;                     ///< \brief FIB entry of the next hop (set when the next hop is added to the entry)
+  ndnSIM::face_index_hook m_faceHook; ///< \brief Link into the per-face list of FIB next hops
 };
 
+/**
+ * @brief Index of FIB next hops by their faces
+ */
+typedef ndnSIM::face_index<FaceMetric, &FaceMetric::m_faceHook> FaceIndex;
+
 /// @cond include_hidden
 class i_face {};
 class i_metric {};
@@ -293,6 +304,7 @@ public:
   : m_fib (fib)
   , m_prefix (prefix)
   , m_needsProbing (false)
+  , m_version (0)
   {
   }
 
@@ -355,9 +367,20 @@ public:
   void
   RemoveFace (const Ptr<Face> &face)
   {
-    m_faces.erase (face);
+    if (m_faces.erase (face) > 0)
+      m_version ++;
   }
 
+  /**
+   * @brief Get version of the next hop list
+   *
+   * Version is incremented every time a next hop is added or removed, order of next hops
+   * (i_nth index) changes, or NACK ratio of a next hop changes.  Strategies can use it to
+   * cache values derived from the list of next hops.
+   */
+  uint32_t
+  GetVersion () const { return m_version; }
+
   /**
    * @brief Get pointer to access FIB, to which this entry is added
    */
@@ -365,7 +388,14 @@ public:
   GetFib ();
   
 private:
+  /**
+   * @brief Reorder random access index same way as metric index
+   */
+  void
+  ReorderFaces ();
+
   friend std::ostream& operator<< (std::ostream& os, const Entry &entry);
+  friend class FaceMetric;
 
 public:
   Ptr<Fib> m_fib; ///< \brief FIB to which entry is added
@@ -374,6 +404,9 @@ public:
   FaceMetricContainer::type m_faces; ///< \brief Indexed list of faces
 
   bool m_needsProbing;      ///< \brief flag indicating that probing should be performed
+
+private:
+  uint32_t m_version;       ///< \brief version of the next hop list, see GetVersion ()
 };
 
 std::ostream& operator<< (std::ostream& os, const Entry &entry);
@@ -32,6 +32,8 @@
 #include <boost/ref.hpp>
 #include <boost/lambda/lambda.hpp>
 #include <boost/lambda/bind.hpp>
+
+#include <vector>
 namespace ll = boost::lambda;
 
 NS_LOG_COMPONENT_DEFINE ("ndn.fib.FibImpl");
@@ -150,21 +152,18 @@ FibImpl::Remove (const Ptr<const Name> &prefix)
   // else do nothing
 }
 
-// void
-// FibImpl::Invalidate (const Ptr<const Name> &prefix)
-// {
-//   NS_LOG_FUNCTION (this->GetObject<Node> ()->GetId () << boost::cref(*prefix));
+void
+FibImpl::Invalidate (const Ptr<const Name> &prefix)
+{
+  NS_LOG_FUNCTION (this->GetObject<Node> ()->GetId () << boost::cref(*prefix));
 
-//   super::iterator foundItem, lastItem;
-//   bool reachLast;
-//   boost::tie (foundItem, reachLast, lastItem) = super::getTrie ().find (*prefix);
-  
-//   if (!reachLast || lastItem->payload () == 0)
-//     return; // nothing to invalidate
+  super::iterator fibEntry = super::find_exact (*prefix);
+  if (fibEntry == super::end ())
+    return; // nothing to invalidate
 
-//   super::modify (lastItem,
-//                  ll::bind (&Entry::Invalidate, ll::_1));
-// }
+  super::modify (fibEntry,
+                 ll::bind (&Entry::Invalidate, ll::_1));
+}
 
 void
 FibImpl::InvalidateAll ()
@@ -197,24 +196,29 @@ FibImpl::RemoveFromAll (Ptr<Face> face)
 {
   NS_LOG_FUNCTION (this);
 
-  std::for_each (super::parent_trie::recursive_iterator (super::getTrie ()),
-                 super::parent_trie::recursive_iterator (0), 
-                 ll::bind (&FibImpl::RemoveFace,
-                           this, ll::_1, face));
+  fib::FaceIndex::list_type *nextHops = m_faceIndex.find (face->GetId ());
+  if (nextHops == 0)
+    return;
 
-  super::parent_trie::recursive_iterator trieNode (super::getTrie ());
-  super::parent_trie::recursive_iterator end (0);
-  for (; trieNode != end; trieNode++)
+  // collect affected entries first, removing next hops modifies the per-face list
+  std::vector< Ptr<EntryImpl> > entries;
+  for (fib::FaceIndex::list_type::iterator nextHop = nextHops->begin (); nextHop != nextHops->end (); nextHop++)
     {
-      if (trieNode->payload () == 0) continue;
-      
-      if (trieNode->payload ()->m_faces.size () == 0)
+      entries.push_back (static_cast<EntryImpl*> (nextHop->m_entry));
+    }
+
+  for (std::vector< Ptr<EntryImpl> >::iterator entry = entries.begin (); entry != entries.end (); entry++)
+    {
+      super::iterator trieNode = (*entry)->to_iterator ();
+      RemoveFace (*trieNode, face);
+
+      if ((*entry)->m_faces.size () == 0)
         {
           // notify forwarding strategy about soon be removed FIB entry
           NS_ASSERT (this->GetObject<ForwardingStrategy> () != 0);
-          this->GetObject<ForwardingStrategy> ()->WillRemoveFibEntry (trieNode->payload ());
-          
-          trieNode = super::parent_trie::recursive_iterator (trieNode->erase ());
+          this->GetObject<ForwardingStrategy> ()->WillRemoveFibEntry (*entry);
+
+          super::erase (trieNode);
         }
     }
 }
@@ -100,6 +100,9 @@ public:
   virtual void
   Remove (const Ptr<const Name> &prefix);
 
+  virtual void
+  Invalidate (const Ptr<const Name> &prefix);
+
   virtual void
   InvalidateAll ();
   
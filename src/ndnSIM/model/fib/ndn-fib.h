@@ -114,14 +114,14 @@ public:
   virtual void
   Remove (const Ptr<const Name> &prefix) = 0;
 
-  // /**
-  //  * @brief Invalidate FIB entry ("Safe" version of Remove)
-  //  *
-  //  * All faces for the entry will be assigned maximum routing metric and NDN_FIB_RED status   
-  //  * @param name	Smart pointer to prefix
-  //  */
-  // virtual void
-  // Invalidate (const Ptr<const Name> &prefix) = 0;
+  /**
+   * @brief Invalidate FIB entry ("Safe" version of Remove)
+   *
+   * All faces for the entry will be assigned maximum routing metric and NDN_FIB_RED status
+   * @param name	Smart pointer to prefix
+   */
+  virtual void
+  Invalidate (const Ptr<const Name> &prefix) = 0;
 
   /**
    * @brief Invalidate all FIB entries
@@ -198,8 +198,13 @@ public:
   ////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////
   
+protected:
+  fib::FaceIndex m_faceIndex; ///< @brief Index of FIB next hops by their faces
+
 private:
   Fib (const Fib&) {} ; ///< \brief copy constructor is disabled
+
+  friend class fib::Entry;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
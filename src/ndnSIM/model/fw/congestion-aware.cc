@@ -30,7 +30,6 @@
 #include "ns3/ndn-fib-entry.h"
 #include "ns3/ndn-content-store.h"
 #include "ns3/random-variable.h"
-#include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.h"
 #include "ns3/ndnSIM/utils/ndn-fw-pmin-tag.h"
 
 #include "ns3/assert.h"
@@ -41,6 +40,8 @@
 #include "ns3/string.h"
 
 #include <math.h>
+#include <algorithm>
+#include <vector>
 #include <boost/ref.hpp>
 #include <boost/foreach.hpp>
 #include <boost/lambda/lambda.hpp>
@@ -56,6 +57,85 @@ namespace fw {
 
 NS_OBJECT_ENSURE_REGISTERED (CongestionAware);
 
+/**
+ * @brief Cumulative distribution of traffic fractions over next hops of a FIB entry
+ *
+ * Object is aggregated to the FIB entry and rebuilt only when version of the entry's next
+ * hop list or K changes, so selection of the outgoing face does not recompute (1/p)^k for
+ * every face on every Interest.
+ */
+class CongestionAware::FaceWeights : public Object
+{
+public:
+  static TypeId
+  GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::ndn::fw::CongestionAware::FaceWeights")
+      .SetGroupName ("Ndn")
+      .SetParent<Object> ()
+      ;
+    return tid;
+  }
+
+  FaceWeights ()
+    : m_version (0)
+    , m_k (0)
+    , m_valid (false)
+  {
+  }
+
+  /**
+   * @brief Get index (in i_nth order) of the face selected by random value p, or -1 if none
+   */
+  int32_t
+  Select (const fib::Entry &fibEntry, uint32_t k, double p)
+  {
+    if (!m_valid || m_version != fibEntry.GetVersion () || m_k != k)
+      Rebuild (fibEntry, k);
+
+    // first face whose cumulative fraction is not less than p
+    std::vector<double>::const_iterator face = std::lower_bound (m_cumulative.begin (), m_cumulative.end (), p);
+    if (face == m_cumulative.end ())
+      return -1;
+    return face - m_cumulative.begin ();
+  }
+
+private:
+  void
+  Rebuild (const fib::Entry &fibEntry, uint32_t k)
+  {
+    m_cumulative.resize (fibEntry.m_faces.size ());
+
+    double total = 0.0;
+    uint32_t i = 0;
+    BOOST_FOREACH (const fib::FaceMetric &metricFace, fibEntry.m_faces.get<fib::i_nth> ())
+      {
+        if (fibEntry.m_faces.size () > 1)
+          NS_LOG_DEBUG (fibEntry.GetPrefix () << " " << metricFace.GetFace () << " NackRatio: " << metricFace.GetNackRatio ());
+        m_cumulative[i] = pow (1.0 / metricFace.GetNackRatio (), k);
+        total += m_cumulative[i];
+        i++;
+      }
+
+    double p_sum = 0;
+    for (i = 0; i < m_cumulative.size (); i++)
+      {
+        p_sum += m_cumulative[i] / total;
+        m_cumulative[i] = p_sum;
+      }
+
+    m_version = fibEntry.GetVersion ();
+    m_k = k;
+    m_valid = true;
+  }
+
+private:
+  std::vector<double> m_cumulative;
+  uint32_t m_version;
+  uint32_t m_k;
+  bool m_valid;
+};
+
 TypeId
 CongestionAware::GetTypeId (void)
 {
@@ -88,29 +168,24 @@ CongestionAware::DoPropagateInterest (Ptr<Face> inFace,
 
   bool success = false;
 
-  double total = 0.0;
-  BOOST_FOREACH (const fib::FaceMetric &metricFace, pitEntry->GetFibEntry ()->m_faces.get<fib::i_nth> ())
+  Ptr<fib::Entry> fibEntry = pitEntry->GetFibEntry ();
+  Ptr<FaceWeights> weights = fibEntry->GetObject<FaceWeights> ();
+  if (weights == 0)
     {
-      if (pitEntry->GetFibEntry ()->m_faces.size () > 1)
-        NS_LOG_DEBUG (pitEntry->GetFibEntry ()->GetPrefix () << " " << metricFace.GetFace () << " NackRatio: " << metricFace.GetNackRatio ());
-      total += pow (1.0 / metricFace.GetNackRatio(), m_k);
+      weights = CreateObject<FaceWeights> ();
+      fibEntry->AggregateObject (weights);
     }
 
   UniformVariable r (0, 1.0);
   double p_random = r.GetValue ();
-  double p_sum = 0;
-  BOOST_FOREACH (const fib::FaceMetric &metricFace, pitEntry->GetFibEntry ()->m_faces.get<fib::i_nth> ())
+  int32_t selected = weights->Select (*fibEntry, m_k, p_random);
+  if (selected >= 0)
     {
-      p_sum += pow (1.0 / metricFace.GetNackRatio(), m_k) / total;
-      if (p_random <= p_sum)
-        {
-          success = TrySendOutInterest (inFace, metricFace.GetFace (), header, origPacket, pitEntry);
-
-          if (!success && pitEntry->GetFibEntry ()->m_faces.size () > 1)
-            pitEntry->GetFibEntry ()->UpdateFaceCounter (metricFace.GetFace (), true);
+      const fib::FaceMetric &metricFace = fibEntry->m_faces.get<fib::i_nth> () [selected];
+      success = TrySendOutInterest (inFace, metricFace.GetFace (), header, origPacket, pitEntry);
 
-          break;
-        }
+      if (!success && fibEntry->m_faces.size () > 1)
+        fibEntry->UpdateFaceCounter (metricFace.GetFace (), true);
     }
 
   return success;
@@ -136,20 +211,10 @@ CongestionAware::DidExhaustForwardingOptions (Ptr<Face> inFace,
 {
   if (m_nacksEnabled)
     {
-      Ptr<Packet> packet = Create<Packet> ();
       Ptr<Interest> nackHeader = Create<Interest> (*header);
       nackHeader->SetNack (Interest::NACK_GIVEUP_PIT);
-      packet->AddHeader (*nackHeader);
-
-      FwHopCountTag hopCountTag;
-      if (origPacket->PeekPacketTag (hopCountTag))
-        {
-          packet->AddPacketTag (hopCountTag);
-        }
-      else
-        {
-          NS_LOG_DEBUG ("No FwHopCountTag tag associated with original Interest");
-        }
+      // NACK keeps all tags of the original Interest (hop count and pmin)
+      Ptr<Packet> packet = Interest::ConvertNack (origPacket, Interest::NACK_GIVEUP_PIT);
 
       if (pitEntry->GetFibEntry ()->m_faces.size () > 1)
         {
@@ -160,34 +225,12 @@ CongestionAware::DidExhaustForwardingOptions (Ptr<Face> inFace,
                 pmin = metricFace.GetNackRatio();
             }
 
-          if (pmin == 2.0)
-            {
-              FwPminTag pminTag;
-              if (origPacket->PeekPacketTag (pminTag))
-                {
-                  packet->AddPacketTag (pminTag);
-                }
-            }
-          else
-            {
-              FwPminTag pminTag;
-              if (origPacket->PeekPacketTag (pminTag) && pmin > pminTag.GetPmin())
-                {
-                  packet->AddPacketTag (pminTag);
-                }
-              else
-                {
-                  pminTag.SetPmin (pmin);
-                  packet->AddPacketTag (pminTag);
-                }
-            }
-        }
-      else
-        {
           FwPminTag pminTag;
-          if (origPacket->PeekPacketTag (pminTag))
+          if (pmin != 2.0 &&
+              !(origPacket->PeekPacketTag (pminTag) && pmin > pminTag.GetPmin()))
             {
-              packet->AddPacketTag (pminTag);
+              pminTag.SetPmin (pmin);
+              packet->ReplacePacketTag (pminTag);
             }
         }
 
@@ -243,26 +286,9 @@ CongestionAware::DidReceiveValidNack (Ptr<Face> inFace,
           return;
         }
 
-      Ptr<Packet> nonNackInterest = Create<Packet> ();
       Ptr<Interest> nonNackHeader = Create<Interest> (*header);
       nonNackHeader->SetNack (Interest::NORMAL_INTEREST);
-      nonNackInterest->AddHeader (*nonNackHeader);
-
-      FwHopCountTag hopCountTag;
-      if (origPacket->PeekPacketTag (hopCountTag))
-        {
-          nonNackInterest->AddPacketTag (hopCountTag);
-        }
-      else
-        {
-          NS_LOG_DEBUG ("No FwHopCountTag tag associated with received NACK");
-        }
-
-      FwPminTag pminTag;
-      if (origPacket->PeekPacketTag (pminTag))
-        {
-          nonNackInterest->AddPacketTag (pminTag);
-        }
+      Ptr<Packet> nonNackInterest = Interest::ConvertNack (origPacket, Interest::NORMAL_INTEREST);
 
       DidExhaustForwardingOptions (inFace, nonNackHeader, nonNackInterest, pitEntry);
     }
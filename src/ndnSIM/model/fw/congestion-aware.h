@@ -63,6 +63,8 @@ protected:
                        Ptr<const Packet> origPacket,
                        Ptr<pit::Entry> pitEntry);
 private:
+  class FaceWeights;
+
   typedef Nacks super;
   uint32_t m_k;
 };
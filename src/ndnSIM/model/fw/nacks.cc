@@ -27,7 +27,6 @@
 #include "ns3/ndn-pit.h"
 #include "ns3/ndn-fib.h"
 #include "ns3/ndn-content-store.h"
-#include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.h"
 
 #include "ns3/assert.h"
 #include "ns3/ptr.h"
@@ -116,18 +115,7 @@ Nacks::DidReceiveDuplicateInterest (Ptr<Face> inFace,
       NS_LOG_DEBUG ("Sending NACK_LOOP");
       Ptr<Interest> nackHeader = Create<Interest> (*header);
       nackHeader->SetNack (Interest::NACK_LOOP);
-      Ptr<Packet> nack = Create<Packet> ();
-      nack->AddHeader (*nackHeader);
-
-      FwHopCountTag hopCountTag;
-      if (origPacket->PeekPacketTag (hopCountTag))
-        {
-     	  nack->AddPacketTag (hopCountTag);
-        }
-      else
-        {
-          NS_LOG_DEBUG ("No FwHopCountTag tag associated with received duplicated Interest");
-        }
+      Ptr<Packet> nack = Interest::ConvertNack (origPacket, Interest::NACK_LOOP);
 
       inFace->Send (nack);
       m_outNacks (nackHeader, inFace);
@@ -142,20 +130,9 @@ Nacks::DidExhaustForwardingOptions (Ptr<Face> inFace,
 {
   if (m_nacksEnabled)
     {
-      Ptr<Packet> packet = Create<Packet> ();
       Ptr<Interest> nackHeader = Create<Interest> (*header);
       nackHeader->SetNack (Interest::NACK_GIVEUP_PIT);
-      packet->AddHeader (*nackHeader);
-
-      FwHopCountTag hopCountTag;
-      if (origPacket->PeekPacketTag (hopCountTag))
-        {
-     	  packet->AddPacketTag (hopCountTag);
-        }
-      else
-        {
-          NS_LOG_DEBUG ("No FwHopCountTag tag associated with original Interest");
-        }
+      Ptr<Packet> packet = Interest::ConvertNack (origPacket, Interest::NACK_GIVEUP_PIT);
 
       BOOST_FOREACH (const pit::IncomingFace &incoming, pitEntry->GetIncoming ())
         {
@@ -202,20 +179,9 @@ Nacks::DidReceiveValidNack (Ptr<Face> inFace,
           return;
         }
 
-      Ptr<Packet> nonNackInterest = Create<Packet> ();
       Ptr<Interest> nonNackHeader = Create<Interest> (*header);
       nonNackHeader->SetNack (Interest::NORMAL_INTEREST);
-      nonNackInterest->AddHeader (*nonNackHeader);
-
-      FwHopCountTag hopCountTag;
-      if (origPacket->PeekPacketTag (hopCountTag))
-        {
-     	  nonNackInterest->AddPacketTag (hopCountTag);
-        }
-      else
-        {
-          NS_LOG_DEBUG ("No FwHopCountTag tag associated with received NACK");
-        }
+      Ptr<Packet> nonNackInterest = Interest::ConvertNack (origPacket, Interest::NORMAL_INTEREST);
 
       bool propagated = DoPropagateInterest (inFace, nonNackHeader, nonNackInterest, pitEntry);
       if (!propagated)
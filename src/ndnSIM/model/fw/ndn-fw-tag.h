@@ -22,6 +22,11 @@
 #ifndef NDNSIM_FW_TAG_H
 #define NDNSIM_FW_TAG_H
 
+#include <stdint.h>
+
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+
 namespace ns3 {
 namespace ndn {
 namespace fw {
@@ -36,6 +41,38 @@ public:
   virtual ~Tag () { };
 };
 
+/**
+ * @brief Get next unused slot in the per-PIT-entry table of forwarding strategy tags
+ *
+ * Slots can be allocated by events that are executed in parallel (see MultithreadedSimulatorImpl)
+ */
+inline uint32_t
+AllocateTagSlot ()
+{
+  static uint32_t nextSlot = 0;
+  return __sync_fetch_and_add (&nextSlot, 1);
+}
+
+/**
+ * @brief Slot of forwarding strategy tag of type T in the per-PIT-entry table of tags
+ *
+ * Slots are assigned on first use of each tag type (initialization of the function-local
+ * static is guarded by the compiler).  Tags are looked up by their static type, so T must be
+ * the concrete tag type, not the fw::Tag base class
+ */
+template<class T>
+struct TagSlot
+{
+  static uint32_t
+  Get ()
+  {
+    // a tag added through a base pointer would never be found by GetFwTag<Derived> ()
+    BOOST_STATIC_ASSERT ((!boost::is_same<T, Tag>::value));
+    static uint32_t slot = AllocateTagSlot ();
+    return slot;
+  }
+};
+
 } // namespace fw
 } // namespace ndn
 } // namespace ns3
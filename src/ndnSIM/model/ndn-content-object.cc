@@ -31,6 +31,7 @@ namespace ns3 {
 namespace ndn {
 
 NS_OBJECT_ENSURE_REGISTERED (ContentObject);
+NS_OBJECT_ENSURE_REGISTERED (ContentObjectTemplate);
 NS_OBJECT_ENSURE_REGISTERED (ContentObjectTail);
 
 TypeId
@@ -111,6 +112,13 @@ ContentObject::GetSignature () const
   return m_signature;
 }
 
+uint32_t
+ContentObject::GetNameOffset () const
+{
+  // version, packet type, signature length, and signature
+  return 2 + 2 + ((m_signature != 0) ? 6 : 2);
+}
+
 uint32_t
 ContentObject::GetSerializedSize () const
 {
@@ -224,6 +232,104 @@ ContentObject::Print (std::ostream &os) const
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+ContentObjectTemplate::ContentObjectTemplate ()
+{
+  Init (ContentObject ());
+}
+
+ContentObjectTemplate::ContentObjectTemplate (const ContentObject &header)
+{
+  Init (header);
+}
+
+void
+ContentObjectTemplate::Init (const ContentObject &header)
+{
+  ContentObject unnamed (header);
+  unnamed.SetName (Create<Name> ());
+  m_freshness = unnamed.GetFreshness ();
+
+  Buffer buffer;
+  buffer.AddAtStart (unnamed.GetSerializedSize ());
+  unnamed.Serialize (buffer.Begin ());
+
+  uint32_t nameOffset = unnamed.GetNameOffset ();
+  uint32_t nameSize = unnamed.GetName ().GetSerializedSize ();
+  m_beforeName.resize (nameOffset);
+  m_afterName.resize (buffer.GetSize () - nameOffset - nameSize);
+
+  Buffer::Iterator i = buffer.Begin ();
+  i.Read (&m_beforeName[0], m_beforeName.size ());
+  i.Next (nameSize);
+  i.Read (&m_afterName[0], m_afterName.size ());
+}
+
+void
+ContentObjectTemplate::SetName (Ptr<const Name> name)
+{
+  m_name = name;
+}
+
+Time
+ContentObjectTemplate::GetFreshness () const
+{
+  return m_freshness;
+}
+
+TypeId
+ContentObjectTemplate::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ndn::ContentObjectTemplate")
+    .SetGroupName ("Ndn")
+    .SetParent<Header> ()
+    .AddConstructor<ContentObjectTemplate> ()
+    ;
+  return tid;
+}
+
+TypeId
+ContentObjectTemplate::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+ContentObjectTemplate::Print (std::ostream &os) const
+{
+  if (m_name == 0) throw ContentObjectException ();
+  os << "D: " << *m_name;
+}
+
+uint32_t
+ContentObjectTemplate::GetSerializedSize () const
+{
+  return m_beforeName.size () + m_name->GetSerializedSize () + m_afterName.size ();
+}
+
+void
+ContentObjectTemplate::Serialize (Buffer::Iterator start) const
+{
+  start.Write (&m_beforeName[0], m_beforeName.size ());
+
+  uint32_t offset = m_name->Serialize (start);
+  start.Next (offset);
+
+  start.Write (&m_afterName[0], m_afterName.size ());
+}
+
+uint32_t
+ContentObjectTemplate::Deserialize (Buffer::Iterator start)
+{
+  ContentObject header;
+  uint32_t size = header.Deserialize (start);
+
+  Init (header);
+  m_name = header.GetNamePtr ();
+  return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 ContentObjectTail::ContentObjectTail ()
 {
 }
@@ -163,6 +163,15 @@ public:
   virtual void Serialize (Buffer::Iterator start) const; ///< @brief Serialize the Header
   virtual uint32_t Deserialize (Buffer::Iterator start); ///< @brief Deserialize the Header
 
+private:
+  /**
+   * @brief Get offset of the name in the serialized header
+   */
+  uint32_t
+  GetNameOffset () const;
+
+  friend class ContentObjectTemplate;
+
 private:
   Ptr<Name> m_name;
   Time m_freshness;
@@ -172,6 +181,59 @@ private:
 
 typedef ContentObject ContentObjectHeader;
 
+/**
+ * @brief ContentObject header, serialized once except for the name
+ *
+ * Bytes before and after the name (signature, timestamp, freshness) are serialized when the
+ * template is created.  For every packet only the name is serialized between them, and the name
+ * is not copied.  Packets made with the template are identical to packets made with ContentObject,
+ * but packet metadata records the template as a different header type.
+ */
+class ContentObjectTemplate : public Header
+{
+public:
+  /**
+   * @brief Create an empty template
+   */
+  ContentObjectTemplate ();
+
+  /**
+   * @brief Create template from all fields of the header except the name
+   */
+  ContentObjectTemplate (const ContentObject &header);
+
+  /**
+   * @brief Set name that is serialized between the pre-serialized bytes
+   */
+  void
+  SetName (Ptr<const Name> name);
+
+  /**
+   * @brief Get freshness of the template
+   */
+  Time
+  GetFreshness () const;
+
+  //////////////////////////////////////////////////////////////////
+
+  static TypeId GetTypeId (void); ///< @brief Get TypeId
+  virtual TypeId GetInstanceTypeId (void) const; ///< @brief Get TypeId of the instance
+  virtual void Print (std::ostream &os) const; ///< @brief Print out information about the Header into the stream
+  virtual uint32_t GetSerializedSize (void) const; ///< @brief Get size necessary to serialize the Header
+  virtual void Serialize (Buffer::Iterator start) const; ///< @brief Serialize the Header
+  virtual uint32_t Deserialize (Buffer::Iterator start); ///< @brief Deserialize the Header
+
+private:
+  void
+  Init (const ContentObject &header);
+
+private:
+  Ptr<const Name> m_name;
+  Time m_freshness;
+  std::vector<uint8_t> m_beforeName; ///< @brief serialized fields before the name
+  std::vector<uint8_t> m_afterName;  ///< @brief serialized fields after the name
+};
+
 /**
  * ContentObjectTail for compatibility with other packet formats
  */
@@ -43,6 +43,16 @@ namespace ndn {
 
 NS_OBJECT_ENSURE_REGISTERED (Face);
 
+// hop count is updated on every hop, keep it out of the shared list of packet tags
+static class FwHopCountTagInline
+{
+public:
+  FwHopCountTagInline ()
+  {
+    Packet::EnableInlinePacketTag (FwHopCountTag::GetTypeId ());
+  }
+} g_fwHopCountTagInline;
+
 TypeId
 Face::GetTypeId ()
 {
@@ -124,11 +134,10 @@ Face::Send (Ptr<Packet> packet)
     }
 
   FwHopCountTag hopCount;
-  bool tagExists = packet->RemovePacketTag (hopCount);
-  if (tagExists)
+  if (packet->PeekPacketTag (hopCount))
     {
       hopCount.Increment ();
-      packet->AddPacketTag (hopCount);
+      packet->ReplacePacketTag (hopCount);
     }
 
   bool ok = SendImpl (packet);
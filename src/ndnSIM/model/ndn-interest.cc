@@ -32,6 +32,65 @@ namespace ndn {
 
 NS_OBJECT_ENSURE_REGISTERED (Interest);
 
+namespace {
+
+/**
+ * @brief Fixed-size beginning of the serialized Interest, up to and including the reserved field
+ */
+class InterestPrefix : public Header
+{
+public:
+  static TypeId
+  GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::ndn::InterestPrefix")
+      .SetGroupName ("Ndn")
+      .SetParent<Header> ()
+      .AddConstructor<InterestPrefix> ()
+      ;
+    return tid;
+  }
+
+  virtual TypeId
+  GetInstanceTypeId () const
+  {
+    return GetTypeId ();
+  }
+
+  virtual uint32_t
+  GetSerializedSize () const
+  {
+    return sizeof (m_bytes);
+  }
+
+  virtual void
+  Serialize (Buffer::Iterator start) const
+  {
+    start.Write (m_bytes, sizeof (m_bytes));
+  }
+
+  virtual uint32_t
+  Deserialize (Buffer::Iterator start)
+  {
+    start.Read (m_bytes, sizeof (m_bytes));
+    return sizeof (m_bytes);
+  }
+
+  virtual void
+  Print (std::ostream &os) const
+  {
+    os << "Interest prefix";
+  }
+
+  uint8_t m_bytes[Interest::RESERVED_FIELD_OFFSET + 1];
+};
+
+NS_OBJECT_ENSURE_REGISTERED (InterestPrefix);
+
+} // namespace
+
+const uint32_t Interest::RESERVED_FIELD_OFFSET;
+
 TypeId
 Interest::GetTypeId (void)
 {
@@ -166,34 +225,75 @@ Interest::GetNack () const
 // TODO:
 // CreateReserved: join nack & priority
 uint8_t Interest::CreateReservedField () const {
+  return CreateReservedField (m_priorityType, m_nackType);
+}
+
+uint8_t
+Interest::CreateReservedField (uint8_t priorityType, uint8_t nackType)
+{
   // modNackType is 0, 1, 2 or 3
-  uint8_t modNackType = (m_nackType == NORMAL_INTEREST) ? 0 : m_nackType - 9;
-  uint8_t reserved = modNackType +10*m_priorityType;
-  NS_LOG_INFO ("Reserved " << +reserved <<" from priority " << +m_priorityType << " and nack " << +m_nackType);
+  uint8_t modNackType = (nackType == NORMAL_INTEREST) ? 0 : nackType - 9;
+  NS_ASSERT_MSG (priorityType < MAX_PRIORITY_TYPES, "Priority type does not fit into the reserved field");
+  uint8_t reserved = modNackType +10*priorityType;
+  NS_LOG_INFO ("Reserved " << +reserved <<" from priority " << +priorityType << " and nack " << +nackType);
   return reserved;
 }
 void Interest::ExtractPriorityType (uint8_t reserved) {
-  if (reserved < 10) {
-    m_priorityType = PRIORITY0;
-  } else if (reserved < 20) {
-    m_priorityType = PRIORITY1;
-  } else if (reserved < 30) {
-    m_priorityType = PRIORITY2;
-  } else {
-    m_priorityType = PRIORITY3;
-  }
+  m_priorityType = GetPriorityFromReservedField (reserved);
   NS_LOG_INFO ("Priority Type from deserialize = " << +m_priorityType);
   return;
 }
 void Interest::ExtractNackType(uint8_t reserved) {
-  m_nackType = reserved - 10*m_priorityType;
-  if (m_nackType != NORMAL_INTEREST) {
-    m_nackType = m_nackType + 9;
-  }
+  m_nackType = GetNackFromReservedField (reserved);
   NS_LOG_INFO ("Extracted nack " << +m_nackType);
   return;
 }
 
+uint8_t
+Interest::GetPriorityFromReservedField (uint8_t reserved)
+{
+  uint8_t priorityType = reserved / 10;
+  return priorityType < MAX_PRIORITY_TYPES ? priorityType : MAX_PRIORITY_TYPES - 1;
+}
+
+uint8_t
+Interest::GetNackFromReservedField (uint8_t reserved)
+{
+  uint8_t nackType = reserved - 10 * GetPriorityFromReservedField (reserved);
+  if (nackType != NORMAL_INTEREST)
+    nackType += 9;
+  return nackType;
+}
+
+Ptr<Packet>
+Interest::ConvertNack (Ptr<const Packet> packet, uint8_t nackType)
+{
+  if (packet->BeginItem ().HasNext ())
+    {
+      // packet metadata records the whole Interest as one header, which cannot be split
+      Ptr<Packet> nack = packet->Copy ();
+      Interest interest;
+      nack->RemoveHeader (interest);
+      interest.SetNack (nackType);
+      nack->AddHeader (interest);
+      return nack;
+    }
+
+  InterestPrefix prefix;
+  uint32_t read = packet->CopyData (prefix.m_bytes, sizeof (prefix.m_bytes));
+  NS_ASSERT_MSG (read == sizeof (prefix.m_bytes), "Packet is too short to be an Interest");
+  NS_UNUSED (read);
+
+  uint8_t &reserved = prefix.m_bytes[RESERVED_FIELD_OFFSET];
+  reserved = CreateReservedField (GetPriorityFromReservedField (reserved), nackType);
+
+  // AddHeader copies the shared buffer, but the name and the rest of the Interest are not serialized again
+  Ptr<Packet> nack = packet->Copy ();
+  nack->RemoveAtStart (sizeof (prefix.m_bytes));
+  nack->AddHeader (prefix);
+  return nack;
+}
+
 void
 Interest::SetPriority (uint8_t priorityType) {
   m_priorityType = priorityType;
@@ -209,6 +209,8 @@ public:
     PRIORITY1 = 1,
     PRIORITY2 = 2,
     PRIORITY3 = 3,
+
+    MAX_PRIORITY_TYPES = 16 ///< @brief Number of priority types that can be carried in the reserved field
   };
   
 
@@ -237,6 +239,48 @@ public:
   uint8_t CreateReservedField () const;
   void ExtractPriorityType (uint8_t reserved);
   void ExtractNackType(uint8_t reserved);
+
+  /**
+   * @brief Decode priority type from the value of the reserved field
+   * @see CreateReservedField
+   */
+  static uint8_t
+  GetPriorityFromReservedField (uint8_t reserved);
+
+  /**
+   * @brief Decode NACK type from the value of the reserved field
+   * @see CreateReservedField
+   */
+  static uint8_t
+  GetNackFromReservedField (uint8_t reserved);
+
+  /**
+   * @brief Encode priority type and NACK type into the value of the reserved field
+   */
+  static uint8_t
+  CreateReservedField (uint8_t priorityType, uint8_t nackType);
+
+  /**
+   * @brief Offset of the reserved field in the serialized Interest
+   *
+   * Version (1) + PacketType (1) + Nonce (4) + Scope (1)
+   */
+  static const uint32_t RESERVED_FIELD_OFFSET = 7;
+
+  /**
+   * @brief Convert serialized Interest into NACK of the given type (or NACK back into normal Interest)
+   *
+   * The fixed-size prefix of the serialized Interest is replaced with one that has the new reserved
+   * field (priority type is preserved), so the name is not serialized again and packet tags of the
+   * original packet are kept.  The packet buffer is still copied once.  When packet metadata is
+   * enabled, the Interest header is deserialized and serialized again, so that the metadata
+   * keeps describing a single Interest header.
+   *
+   * @param packet   packet that starts with the serialized Interest
+   * @param nackType NACK_LOOP, NACK_CONGESTION, NACK_GIVEUP_PIT, or NORMAL_INTEREST
+   */
+  static Ptr<Packet>
+  ConvertNack (Ptr<const Packet> packet, uint8_t nackType);
   
 
   //////////////////////////////////////////////////////////////////
@@ -24,6 +24,7 @@
 #include "ns3/packet.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
+#include "ns3/unused.h"
 #include "ns3/callback.h"
 #include "ns3/uinteger.h"
 #include "ns3/trace-source-accessor.h"
@@ -141,6 +142,7 @@ L3Protocol::DoDispose (void)
 
   for (FaceList::iterator i = m_faces.begin (); i != m_faces.end (); ++i)
     {
+      (*i)->Dispose ();
       *i = 0;
     }
   m_faces.clear ();
@@ -178,7 +180,7 @@ L3Protocol::RemoveFace (Ptr<Face> face)
 
   // just to be on a safe side. Do the process in two steps
   std::list< Ptr<pit::Entry> > entriesToRemoves;
-  for (Ptr<pit::Entry> pitEntry = pit->Begin (); pitEntry != 0; pitEntry = pit->Next (pitEntry))
+  BOOST_FOREACH (Ptr<pit::Entry> pitEntry, pit->GetEntriesForFace (face))
     {
       pitEntry->RemoveAllReferencesToFace (face);
 
@@ -252,7 +254,6 @@ L3Protocol::Receive (const Ptr<Face> &face, const Ptr<const Packet> &p)
 
   NS_LOG_LOGIC ("Packet from face " << *face << " received on node " <<  m_node->GetId ());
 
-  Ptr<Packet> packet = p->Copy (); // give upper layers a rw copy of the packet
   try
     {
       HeaderHelper::Type type = HeaderHelper::GetNdnHeaderType (p);
@@ -260,12 +261,14 @@ L3Protocol::Receive (const Ptr<Face> &face, const Ptr<const Packet> &p)
         {
         case HeaderHelper::INTEREST_NDNSIM:
           {
-            s_interestCounter ++;
+            __sync_fetch_and_add (&s_interestCounter, 1); // faces of different nodes can receive packets in parallel
             Ptr<Interest> header = Create<Interest> ();
 
             // Deserialization. Exception may be thrown
-            packet->RemoveHeader (*header);
-            NS_ASSERT_MSG (packet->GetSize () == 0, "Payload of Interests should be zero");
+            // Interests carry no payload, so there is no need for a rw copy of the packet
+            uint32_t headerSize = p->PeekHeader (*header);
+            NS_ASSERT_MSG (p->GetSize () == headerSize, "Payload of Interests should be zero");
+            NS_UNUSED (headerSize);
 
             m_forwardingStrategy->OnInterest (face, header, p/*original packet*/);
             // if (header->GetNack () > 0)
@@ -276,7 +279,8 @@ L3Protocol::Receive (const Ptr<Face> &face, const Ptr<const Packet> &p)
           }
         case HeaderHelper::CONTENT_OBJECT_NDNSIM:
           {
-            s_dataCounter ++;
+            __sync_fetch_and_add (&s_dataCounter, 1);
+            Ptr<Packet> packet = p->Copy (); // give upper layers a rw copy of the packet
             Ptr<ContentObject> header = Create<ContentObject> ();
 
             static ContentObjectTail contentObjectTrailer; //there is no data in this object
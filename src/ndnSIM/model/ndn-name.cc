@@ -21,9 +21,17 @@
 
 #include "ndn-name.h"
 #include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
 #include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#endif
 
 #include <iostream>
+#include <limits>
 
 using namespace std;
 
@@ -34,6 +42,187 @@ namespace ndn {
 
 ATTRIBUTE_HELPER_CPP (Name);
 
+namespace name {
+
+namespace {
+
+struct ComponentHash
+{
+  std::size_t
+  operator() (const std::string &value) const
+  {
+    return ComputeHash (value.data (), value.size ());
+  }
+
+  std::size_t
+  operator() (const ComponentRef &component) const
+  {
+    return component.hash ();
+  }
+};
+
+struct ComponentEqual
+{
+  bool
+  operator() (const ComponentRef &a, const std::string &b) const
+  {
+    return a.size () == b.size () && std::memcmp (a.data (), b.data (), a.size ()) == 0;
+  }
+
+  bool
+  operator() (const std::string &a, const ComponentRef &b) const
+  {
+    return operator() (b, a);
+  }
+};
+
+typedef boost::unordered_map<std::string, uint32_t, ComponentHash> ComponentTable;
+
+bool g_interning = false;
+
+ComponentTable &
+GetComponentTable ()
+{
+  static ComponentTable table;
+  return table;
+}
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * @brief Protects the table, names can be created by events that are executed in parallel
+ */
+SystemMutex g_tableMutex;
+#endif
+
+} // namespace
+
+std::size_t
+ComputeHash (const char *data, uint32_t size)
+{
+  return boost::hash_range (data, data + size);
+}
+
+uint32_t
+Intern (const char *data, uint32_t size, std::size_t hash)
+{
+  if (!g_interning)
+    return 0;
+
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_tableMutex);
+#endif
+  ComponentTable &table = GetComponentTable ();
+  ComponentRef component (data, size, hash, 0, 0);
+  ComponentTable::iterator item = table.find (component, ComponentHash (), ComponentEqual ());
+  if (item != table.end ())
+    return item->second;
+
+  uint32_t id = table.size () + 1;
+  table.insert (std::make_pair (std::string (data, size), id));
+  return id;
+}
+
+Component::Component ()
+  : m_hash (ComputeHash (0, 0))
+  , m_id (Intern (0, 0, m_hash))
+  , m_prefixHash (CombinePrefixHash (0, m_hash))
+{
+}
+
+Component::Component (const std::string &value)
+  : m_value (value)
+  , m_hash (ComputeHash (value.data (), value.size ()))
+  , m_id (Intern (value.data (), value.size (), m_hash))
+  , m_prefixHash (CombinePrefixHash (0, m_hash))
+{
+}
+
+Component::Component (const char *value)
+  : m_value (value)
+  , m_hash (ComputeHash (m_value.data (), m_value.size ()))
+  , m_id (Intern (m_value.data (), m_value.size (), m_hash))
+  , m_prefixHash (CombinePrefixHash (0, m_hash))
+{
+}
+
+Component::Component (const ComponentRef &component)
+  : m_value (component.data (), component.size ())
+  , m_hash (component.hash ())
+  , m_id (component.id ())
+  , m_prefixHash (component.prefix_hash ())
+{
+}
+
+uint64_t
+ComponentRef::toSeqNum () const
+{
+  uint64_t value = 0;
+  if (isSeqNum ())
+    {
+      if (m_size > 1 + sizeof (uint64_t))
+        NS_FATAL_ERROR ("Sequence number component " << *this << " is too long");
+
+      for (uint32_t i = 1; i < m_size; i++)
+        value = (value << 8) | static_cast<uint8_t> (m_data[i]);
+    }
+  else
+    {
+      if (m_size == 0)
+        NS_FATAL_ERROR ("Empty component is not a sequence number");
+
+      for (uint32_t i = 0; i < m_size; i++)
+        {
+          if (m_data[i] < '0' || m_data[i] > '9')
+            NS_FATAL_ERROR ("Component " << *this << " is not a sequence number");
+
+          uint64_t digit = m_data[i] - '0';
+          if (value > (std::numeric_limits<uint64_t>::max () - digit) / 10)
+            NS_FATAL_ERROR ("Sequence number " << *this << " is too large");
+          value = value * 10 + digit;
+        }
+    }
+  return value;
+}
+
+std::ostream &
+operator << (std::ostream &os, const ComponentRef &component)
+{
+  if (component.isSeqNum ())
+    {
+      // binary sequence numbers are printed URI-escaped, e.g., %00%01%02
+      static const char hex[] = "0123456789ABCDEF";
+      for (uint32_t i = 0; i < component.size (); i++)
+        {
+          uint8_t byte = static_cast<uint8_t> (component.data ()[i]);
+          os << '%' << hex[byte >> 4] << hex[byte & 0x0F];
+        }
+    }
+  else
+    os.write (component.data (), component.size ());
+  return os;
+}
+
+std::ostream &
+operator << (std::ostream &os, const Component &component)
+{
+  os << component.ref ();
+  return os;
+}
+
+} // namespace name
+
+void
+Name::EnableComponentInterning (bool enable/* = true*/)
+{
+  name::g_interning = enable;
+}
+
+bool
+Name::IsComponentInterningEnabled ()
+{
+  return name::g_interning;
+}
+
 Name::Name (/* root */)
 {
 }
@@ -68,33 +257,133 @@ Name::Name (const char *prefix)
   is >> *this;
 }
 
-const std::list<std::string> &
+void
+Name::AddComponent (const char *data, uint32_t size, std::size_t hash, uint32_t id)
+{
+  if (data >= m_buffer.begin () && data < m_buffer.end ())
+    {
+      // component of this name is appended, buffer can be reallocated
+      std::string copy (data, size);
+      AddComponent (copy.data (), size, hash, id);
+      return;
+    }
+
+  // push_back doubles the capacity when needed, reserving the exact size here would make building long names quadratic
+  for (uint32_t i = 0; i < size; i++)
+    m_buffer.push_back (data[i]);
+
+  ComponentInfo info;
+  info.m_end = m_buffer.size ();
+  info.m_id = id;
+  info.m_hash = hash;
+  info.m_prefixHash = name::CombinePrefixHash (GetPrefixHash (m_components.size ()), hash);
+  m_components.push_back (info);
+}
+
+Name&
+Name::Add (const std::string &value)
+{
+  std::size_t hash = name::ComputeHash (value.data (), value.size ());
+  AddComponent (value.data (), value.size (), hash, name::Intern (value.data (), value.size (), hash));
+  return *this;
+}
+
+Name&
+Name::Add (const char *value)
+{
+  NS_ASSERT (value != 0);
+
+  uint32_t size = std::strlen (value);
+  std::size_t hash = name::ComputeHash (value, size);
+  AddComponent (value, size, hash, name::Intern (value, size, hash));
+  return *this;
+}
+
+Name&
+Name::Add (uint64_t value)
+{
+  char digits[20];
+  char *start = digits + sizeof (digits);
+  do
+    {
+      *(--start) = '0' + (value % 10);
+      value /= 10;
+    }
+  while (value > 0);
+
+  uint32_t size = digits + sizeof (digits) - start;
+  std::size_t hash = name::ComputeHash (start, size);
+  AddComponent (start, size, hash, name::Intern (start, size, hash));
+  return *this;
+}
+
+Name&
+Name::AddSeqNum (uint64_t seq)
+{
+  char value[1 + sizeof (uint64_t)];
+  char *start = value + sizeof (value);
+  do
+    {
+      *(--start) = static_cast<char> (seq & 0xFF);
+      seq >>= 8;
+    }
+  while (seq > 0);
+  *(--start) = 0; // marker
+
+  uint32_t size = value + sizeof (value) - start;
+  std::size_t hash = name::ComputeHash (start, size);
+  AddComponent (start, size, hash, name::Intern (start, size, hash));
+  return *this;
+}
+
+Name&
+Name::Add (uint32_t value)
+{
+  return Add (static_cast<uint64_t> (value));
+}
+
+Name&
+Name::Add (const name::ComponentRef &component)
+{
+  if (component.id () == 0 && name::g_interning)
+    AddComponent (component.data (), component.size (), component.hash (),
+                  name::Intern (component.data (), component.size (), component.hash ()));
+  else
+    AddComponent (component.data (), component.size (), component.hash (), component.id ());
+  return *this;
+}
+
+std::list<std::string>
 Name::GetComponents () const
 {
-  return m_prefix;
+  std::list<std::string> components;
+  for (const_iterator i = begin (); i != end (); i++)
+    {
+      components.push_back (i->str ());
+    }
+  return components;
 }
 
 std::string
 Name::GetLastComponent () const
 {
-  if (m_prefix.size () == 0)
+  if (m_components.size () == 0)
     {
       return "";
     }
 
-  return m_prefix.back ();
+  return GetComponent (m_components.size () - 1).str ();
 }
 
-std::list<boost::reference_wrapper<const std::string> >
+std::list<std::string>
 Name::GetSubComponents (size_t num) const
 {
-  NS_ASSERT_MSG (0<=num && num<=m_prefix.size (), "Invalid number of subcomponents requested");
+  NS_ASSERT_MSG (0<=num && num<=m_components.size (), "Invalid number of subcomponents requested");
 
-  std::list<boost::reference_wrapper<const std::string> > subComponents;
-  std::list<std::string>::const_iterator component = m_prefix.begin();
-  for (size_t i=0; i<num; i++, component++)
+  std::list<std::string> subComponents;
+  for (size_t i=0; i<num; i++)
     {
-      subComponents.push_back (boost::ref (*component));
+      subComponents.push_back (GetComponent (i).str ());
     }
 
   return subComponents;
@@ -104,11 +393,12 @@ Name
 Name::cut (size_t minusComponents) const
 {
   Name retval;
-  std::list<std::string>::const_iterator component = m_prefix.begin ();
-  for (uint32_t i = 0; i < m_prefix.size () - minusComponents; i++, component++)
-    {
-      retval.Add (*component);
-    }
+  size_t num = m_components.size () - minusComponents;
+  if (num == 0)
+    return retval;
+
+  retval.m_buffer.assign (m_buffer.begin (), m_buffer.begin () + m_components[num-1].m_end);
+  retval.m_components.assign (m_components.begin (), m_components.begin () + num);
 
   return retval;
 }
@@ -116,14 +406,7 @@ Name::cut (size_t minusComponents) const
 size_t
 Name::GetSerializedSize () const
 {
-  size_t nameSerializedSize = 2;
-
-  for (std::list<std::string>::const_iterator i = this->begin ();
-       i != this->end ();
-       i++)
-    {
-      nameSerializedSize += 2 + i->size ();
-    }
+  size_t nameSerializedSize = 2 + 2 * m_components.size () + m_buffer.size ();
   NS_ASSERT_MSG (nameSerializedSize < 30000, "Name is too long (> 30kbytes)");
 
   return nameSerializedSize;
@@ -136,12 +419,12 @@ Name::Serialize (Buffer::Iterator start) const
 
   i.WriteU16 (static_cast<uint16_t> (this->GetSerializedSize ()-2));
 
-  for (std::list<std::string>::const_iterator item = this->begin ();
+  for (const_iterator item = this->begin ();
        item != this->end ();
        item++)
     {
       i.WriteU16 (static_cast<uint16_t> (item->size ()));
-      i.Write (reinterpret_cast<const uint8_t*> (item->c_str ()), item->size ());
+      i.Write (reinterpret_cast<const uint8_t*> (item->data ()), item->size ());
     }
 
   return i.GetDistanceFrom (start);
@@ -153,30 +436,63 @@ Name::Deserialize (Buffer::Iterator start)
   Buffer::Iterator i = start;
 
   uint16_t nameLength = i.ReadU16 ();
+  m_buffer.reserve (m_buffer.size () + nameLength);
   while (nameLength > 0)
     {
       uint16_t length = i.ReadU16 ();
       nameLength = nameLength - 2 - length;
 
-      uint8_t tmp[length];
-      i.Read (tmp, length);
+      // read component directly into the name buffer
+      uint32_t begin = m_buffer.size ();
+      m_buffer.resize (begin + length);
+      i.Read (reinterpret_cast<uint8_t*> (m_buffer.begin () + begin), length);
+
+      const char *data = m_buffer.begin () + begin;
+      std::size_t hash = name::ComputeHash (data, length);
 
-      this->Add (string (reinterpret_cast<const char*> (tmp), length));
+      ComponentInfo info;
+      info.m_end = m_buffer.size ();
+      info.m_id = name::Intern (data, length, hash);
+      info.m_hash = hash;
+      info.m_prefixHash = name::CombinePrefixHash (GetPrefixHash (m_components.size ()), hash);
+      m_components.push_back (info);
     }
 
   return i.GetDistanceFrom (start);
 }
 
+bool
+Name::operator== (const Name &prefix) const
+{
+  if (m_components.size () != prefix.m_components.size () ||
+      m_buffer.size () != prefix.m_buffer.size ())
+    return false;
+
+  // names usually differ in the last components
+  for (size_t i = m_components.size (); i > 0; i--)
+    {
+      if (GetComponent (i-1) != prefix.GetComponent (i-1))
+        return false;
+    }
+  return true;
+}
+
+bool
+Name::operator< (const Name &prefix) const
+{
+  return std::lexicographical_compare (begin (), end (),
+                                       prefix.begin (), prefix.end ());
+}
+
 void
 Name::Print (std::ostream &os) const
 {
-  for (const_iterator i=m_prefix.begin(); i!=m_prefix.end(); i++)
+  for (const_iterator i=begin(); i!=end(); i++)
     {
       os << "/" << *i;
     }
-  if (m_prefix.size ()==0) os << "/";
+  if (m_components.size ()==0) os << "/";
 }
-
 std::ostream &
 operator << (std::ostream &os, const Name &components)
 {
@@ -184,6 +500,52 @@ operator << (std::ostream &os, const Name &components)
   return os;
 }
 
+namespace {
+
+int
+HexDigit (char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1;
+}
+
+/**
+ * @brief Add component read from the input
+ *
+ * Binary sequence numbers are printed URI-escaped (e.g., %00%01%02), such components are converted back
+ */
+void
+AddParsedComponent (Name &components, const std::string &component)
+{
+  if (component.size () >= 3 && component.size () % 3 == 0 && component.compare (0, 3, "%00") == 0)
+    {
+      std::string value;
+      for (uint32_t i = 0; i < component.size (); i += 3)
+        {
+          int high = HexDigit (component[i + 1]);
+          int low = HexDigit (component[i + 2]);
+          if (component[i] != '%' || high < 0 || low < 0)
+            break;
+          value.push_back (static_cast<char> ((high << 4) | low));
+        }
+
+      if (value.size () * 3 == component.size ())
+        {
+          components.Add (value);
+          return;
+        }
+    }
+
+  components.Add (component);
+}
+
+} // namespace
+
 std::istream &
 operator >> (std::istream &is, Name &components)
 {
@@ -196,14 +558,14 @@ operator >> (std::istream &is, Name &components)
       if (*it == '/')
         {
           if (component != "")
-              components.Add (component);
+              AddParsedComponent (components, component);
           component = "";
         }
       else
         component.push_back (*it);
     }
   if (component != "")
-      components.Add (component);
+      AddParsedComponent (components, component);
 
   is.clear ();
   // NS_LOG_ERROR (components << ", bad: " << is.bad () <<", fail: " << is.fail ());
@@ -29,14 +29,292 @@
 #include <string>
 #include <algorithm>
 #include <list>
+#include <cstring>
+#include <sstream>
 #include "ns3/object.h"
 #include "ns3/buffer.h"
 
+#include "ns3/ndnSIM/utils/small-vector.h"
+
 #include <boost/ref.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 
 namespace ns3 {
 namespace ndn {
 
+class Name;
+
+namespace name {
+
+/**
+ * @brief Calculate hash of the name component
+ *
+ * The same value as boost::hash<std::string> of the component would give
+ */
+std::size_t
+ComputeHash (const char *data, uint32_t size);
+
+/**
+ * @brief Calculate hash of the prefix from hash of the parent prefix and hash of the last component
+ */
+inline std::size_t
+CombinePrefixHash (std::size_t parentPrefixHash, std::size_t componentHash)
+{
+  std::size_t seed = parentPrefixHash;
+  seed ^= componentHash + 0x9e3779b9 + (seed<<6) + (seed>>2); // the same as boost::hash_combine
+  return seed;
+}
+
+/**
+ * @brief Get ID of the component in the global component table (component is added if necessary)
+ * @returns 0 if component interning is disabled
+ * @see Name::EnableComponentInterning
+ */
+uint32_t
+Intern (const char *data, uint32_t size, std::size_t hash);
+
+/**
+ * \ingroup ndn
+ * \brief Read-only reference to a name component
+ *
+ * Reference carries precomputed hash and (if interning is enabled) ID of the component, so
+ * comparison and hashing of components are integer operations in most cases.  Reference also
+ * carries hash of the name prefix ending with this component, which is used by name tries.
+ * Reference is valid only as long as the referred name is alive and not modified.
+ */
+class ComponentRef
+{
+public:
+  ComponentRef (const char *data, uint32_t size, std::size_t hash, uint32_t id, std::size_t prefixHash)
+    : m_data (data)
+    , m_size (size)
+    , m_hash (hash)
+    , m_id (id)
+    , m_prefixHash (prefixHash)
+  {
+  }
+
+  /**
+   * @brief Get pointer to the component bytes (not zero-terminated)
+   */
+  const char *
+  data () const
+  {
+    return m_data;
+  }
+
+  /**
+   * @brief Get size of the component in bytes
+   */
+  uint32_t
+  size () const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get precomputed hash of the component
+   */
+  std::size_t
+  hash () const
+  {
+    return m_hash;
+  }
+
+  /**
+   * @brief Get ID of the interned component (0 if component is not interned)
+   */
+  uint32_t
+  id () const
+  {
+    return m_id;
+  }
+
+  /**
+   * @brief Get hash of the name prefix ending with this component
+   */
+  std::size_t
+  prefix_hash () const
+  {
+    return m_prefixHash;
+  }
+
+  /**
+   * @brief Get copy of the component as a string
+   */
+  std::string
+  str () const
+  {
+    return std::string (m_data, m_size);
+  }
+
+  /**
+   * @brief Check whether the component is a binary sequence number (see Name::AddSeqNum)
+   */
+  bool
+  isSeqNum () const
+  {
+    return m_size > 0 && m_data[0] == 0;
+  }
+
+  /**
+   * @brief Get value of the sequence number component
+   *
+   * Both binary (see Name::AddSeqNum) and decimal representations of the number are accepted.
+   * Simulation is stopped if the component is not a sequence number or the number does not fit
+   * into 64 bits
+   */
+  uint64_t
+  toSeqNum () const;
+
+  /**
+   * @brief Compare components byte-wise (the same order as std::string::compare)
+   */
+  int
+  compare (const ComponentRef &other) const
+  {
+    if (m_id != 0 && m_id == other.m_id)
+      return 0;
+
+    int ret = std::memcmp (m_data, other.m_data, std::min (m_size, other.m_size));
+    if (ret != 0)
+      return ret;
+    return (m_size < other.m_size) ? -1 : ((m_size > other.m_size) ? 1 : 0);
+  }
+
+  bool
+  operator== (const ComponentRef &other) const
+  {
+    if (m_hash != other.m_hash)
+      return false;
+    if (m_id != 0 && other.m_id != 0)
+      return m_id == other.m_id;
+    return m_size == other.m_size && std::memcmp (m_data, other.m_data, m_size) == 0;
+  }
+
+  bool
+  operator!= (const ComponentRef &other) const
+  {
+    return !(*this == other);
+  }
+
+  bool
+  operator< (const ComponentRef &other) const
+  {
+    return compare (other) < 0;
+  }
+
+private:
+  const char *m_data;
+  uint32_t m_size;
+  std::size_t m_hash;
+  uint32_t m_id;
+  std::size_t m_prefixHash;
+};
+
+/**
+ * \ingroup ndn
+ * \brief Name component that owns its value
+ *
+ * Used as a key of name tries (Name::partial_type).  When created from a reference, the
+ * component remembers prefix hash of the reference, otherwise the component is assumed to be
+ * the first component of a name.
+ */
+class Component
+{
+public:
+  Component ();
+
+  Component (const std::string &value);
+
+  Component (const char *value);
+
+  Component (const ComponentRef &component);
+
+  /**
+   * @brief Get reference to this component
+   */
+  ComponentRef
+  ref () const
+  {
+    return ComponentRef (m_value.data (), m_value.size (), m_hash, m_id, m_prefixHash);
+  }
+
+  /**
+   * @brief Get value of the component
+   */
+  const std::string &
+  str () const
+  {
+    return m_value;
+  }
+
+  /**
+   * @brief Get precomputed hash of the component
+   */
+  std::size_t
+  hash () const
+  {
+    return m_hash;
+  }
+
+  bool
+  operator== (const Component &other) const
+  {
+    return ref () == other.ref ();
+  }
+
+  bool
+  operator< (const Component &other) const
+  {
+    return ref () < other.ref ();
+  }
+
+private:
+  std::string m_value;
+  std::size_t m_hash;
+  uint32_t m_id;
+  std::size_t m_prefixHash;
+};
+
+inline bool
+operator== (const ComponentRef &a, const Component &b)
+{
+  return a == b.ref ();
+}
+
+inline bool
+operator== (const Component &a, const ComponentRef &b)
+{
+  return a.ref () == b;
+}
+
+/**
+ * @brief Hash of the component in a name trie, i.e., hash of the prefix ending with the component
+ *
+ * All lookups in PIT, FIB, and CS reuse prefix hashes that are calculated only once, when
+ * the name is created or deserialized
+ */
+inline std::size_t
+hash_value (const ComponentRef &component)
+{
+  return component.prefix_hash ();
+}
+
+inline std::size_t
+hash_value (const Component &component)
+{
+  return component.ref ().prefix_hash ();
+}
+
+std::ostream &
+operator << (std::ostream &os, const ComponentRef &component);
+
+std::ostream &
+operator << (std::ostream &os, const Component &component);
+
+} // namespace name
+
 /**
  * \ingroup ndn
  * \brief Hierarchical NDN name
@@ -45,12 +323,16 @@ namespace ndn {
  * Each Component element contains a sequence of zero or more bytes.
  * There are no restrictions on what byte sequences may be used.
  * The Name element in an Interest is often referred to with the term name prefix or simply prefix.
+ *
+ * Components are stored back-to-back in a single buffer with a table of component end offsets,
+ * precomputed hashes and (optionally) IDs of interned components.  Short names do not
+ * require any heap allocations.
  */
 class Name : public SimpleRefCount<Name>
 {
 public:
-  typedef std::list<std::string>::iterator       iterator;
-  typedef std::list<std::string>::const_iterator const_iterator;
+  class const_iterator;
+  typedef const_iterator iterator; ///< @brief Components cannot be modified in place
 
   /**
    * \brief Constructor
@@ -88,13 +370,53 @@ public:
 
   /**
    * \brief Generic Add method
-   * Appends object of type T to the list of components
+   * Appends object of type T (converted to string using operator<<) to the list of components
    * @param[in] value The object to be appended
    */
   template<class T>
   inline Name&
   Add (const T &value);
 
+  /**
+   * \brief Append string as a component
+   */
+  Name&
+  Add (const std::string &value);
+
+  /**
+   * \brief Append zero-terminated string as a component
+   */
+  Name&
+  Add (const char *value);
+
+  /**
+   * \brief Append decimal representation of the number as a component
+   */
+  Name&
+  Add (uint32_t value);
+
+  /**
+   * \brief Append decimal representation of the number as a component
+   */
+  Name&
+  Add (uint64_t value);
+
+  /**
+   * \brief Append sequence number as a binary component
+   *
+   * The component consists of zero marker byte followed by big-endian representation of the
+   * number without leading zeros, so the number can be extracted without parsing
+   * (see name::ComponentRef::toSeqNum)
+   */
+  Name&
+  AddSeqNum (uint64_t seq);
+
+  /**
+   * \brief Append component (hash and ID of the component are reused)
+   */
+  Name&
+  Add (const name::ComponentRef &component);
+
   /**
    * \brief Generic constructor operator
    * The object of type T will be appended to the list of components
@@ -105,11 +427,28 @@ public:
 
   /**
    * \brief Get a name
-   * Returns a list of components (strings)
+   * Returns a copy of the list of components (strings)
    */
-  const std::list<std::string> &
+  std::list<std::string>
   GetComponents () const;
 
+  /**
+   * \brief Get reference to the component
+   * @param[in] index Index of the component, should be less than size ()
+   */
+  inline name::ComponentRef
+  GetComponent (size_t index) const;
+
+  /**
+   * \brief Get hash of the prefix that consists of the first num components of the name
+   *
+   * Prefix hashes are calculated when components are added to the name, so all lookups
+   * (PIT, FIB, CS) share the same hashing pass
+   * @param[in] num Number of components, should be in range [0, size ()]
+   */
+  inline std::size_t
+  GetPrefixHash (size_t num) const;
+
   /**
    * @brief Helper call to get the last component of the name
    */
@@ -120,7 +459,7 @@ public:
    * \brief Get subcomponents of the name, starting with first component
    * @param[in] num Number of components to return. Valid value is in range [1, GetComponents ().size ()]
    */
-  std::list<boost::reference_wrapper<const std::string> >
+  std::list<std::string>
   GetSubComponents (size_t num) const;
 
   /**
@@ -161,24 +500,12 @@ public:
   inline size_t
   size () const;
 
-  /**
-   * @brief Get read-write begin() iterator
-   */
-  inline iterator
-  begin ();
-
   /**
    * @brief Get read-only begin() iterator
    */
   inline const_iterator
   begin () const;
 
-  /**
-   * @brief Get read-write end() iterator
-   */
-  inline iterator
-  end ();
-
   /**
    * @brief Get read-only end() iterator
    */
@@ -188,19 +515,80 @@ public:
   /**
    * \brief Equality operator for Name
    */
-  inline bool
+  bool
   operator== (const Name &prefix) const;
 
   /**
    * \brief Less than operator for Name
    */
-  inline bool
+  bool
   operator< (const Name &prefix) const;
 
-  typedef std::string partial_type;
+  /**
+   * @brief Enable or disable global interning of name components
+   *
+   * When enabled, every distinct component gets a unique integer ID when it is added to a name,
+   * so component comparisons (e.g., in PIT, FIB, and CS lookups) do not need to compare bytes.
+   * The table is never shrunk, so interning should not be used when names contain
+   * many unique components (e.g., random components).  Disabled by default.
+   */
+  static void
+  EnableComponentInterning (bool enable = true);
+
+  /**
+   * @brief Check whether components are interned when added to a name
+   */
+  static bool
+  IsComponentInterningEnabled ();
+
+  typedef name::Component partial_type;
+
+  /**
+   * \brief Random-access iterator over components of the name
+   */
+  class const_iterator
+    : public boost::iterator_facade<const_iterator,
+                                    name::ComponentRef,
+                                    boost::random_access_traversal_tag,
+                                    name::ComponentRef>
+  {
+  public:
+    const_iterator () : m_name (0), m_index (0) { }
+    const_iterator (const Name *name, size_t index) : m_name (name), m_index (index) { }
+
+  private:
+    friend class boost::iterator_core_access;
+
+    name::ComponentRef dereference () const { return m_name->GetComponent (m_index); }
+    bool equal (const const_iterator &other) const { return m_index == other.m_index; }
+    void increment () { m_index ++; }
+    void decrement () { m_index --; }
+    void advance (std::ptrdiff_t n) { m_index += n; }
+    std::ptrdiff_t distance_to (const const_iterator &other) const { return other.m_index - m_index; }
+
+  private:
+    const Name *m_name;
+    size_t m_index;
+  };
+
+private:
+  void
+  AddComponent (const char *data, uint32_t size, std::size_t hash, uint32_t id);
 
 private:
-  std::list<std::string> m_prefix;                              ///< \brief a list of strings (components)
+  /**
+   * \brief Entry of the component table
+   */
+  struct ComponentInfo
+  {
+    uint32_t m_end;     ///< \brief offset of the component end in the buffer
+    uint32_t m_id;      ///< \brief ID of interned component (0 if not interned)
+    std::size_t m_hash; ///< \brief hash of the component
+    std::size_t m_prefixHash; ///< \brief hash of the prefix ending with the component
+  };
+
+  ndnSIM::small_vector<char, 64> m_buffer;                 ///< \brief components, back-to-back
+  ndnSIM::small_vector<ComponentInfo, 8> m_components;     ///< \brief component table
 };
 
 /**
@@ -211,7 +599,8 @@ operator << (std::ostream &os, const Name &components);
 
 /**
  * \brief Read components from input and add them to components. Will read input stream till eof
- * Substrings separated by slashes will become separate components
+ * Substrings separated by slashes will become separate components.  Components printed as
+ * URI-escaped binary sequence numbers (e.g., %00%01%02) are converted back to binary
  */
 std::istream &
 operator >> (std::istream &is, Name &components);
@@ -222,31 +611,32 @@ operator >> (std::istream &is, Name &components);
 size_t
 Name::size () const
 {
-  return m_prefix.size ();
+  return m_components.size ();
 }
 
-Name::iterator
-Name::begin ()
+name::ComponentRef
+Name::GetComponent (size_t index) const
 {
-  return m_prefix.begin ();
+  NS_ASSERT (index < m_components.size ());
+  const ComponentInfo &info = m_components[index];
+  uint32_t begin = (index == 0) ? 0 : m_components[index-1].m_end;
+  return name::ComponentRef (m_buffer.begin () + begin, info.m_end - begin, info.m_hash, info.m_id, info.m_prefixHash);
 }
 
-/**
- * @brief Get read-only begin() iterator
- */
-Name::const_iterator
-Name::begin () const
+std::size_t
+Name::GetPrefixHash (size_t num) const
 {
-  return m_prefix.begin ();
+  NS_ASSERT (num <= m_components.size ());
+  return (num == 0) ? 0 : m_components[num-1].m_prefixHash;
 }
 
 /**
- * @brief Get read-write end() iterator
+ * @brief Get read-only begin() iterator
  */
-Name::iterator
-Name::end ()
+Name::const_iterator
+Name::begin () const
 {
-  return m_prefix.end ();
+  return const_iterator (this, 0);
 }
 
 /**
@@ -255,7 +645,7 @@ Name::end ()
 Name::const_iterator
 Name::end () const
 {
-  return m_prefix.end ();
+  return const_iterator (this, m_components.size ());
 }
 
 
@@ -281,31 +671,7 @@ Name::Add (const T &value)
 {
   std::ostringstream os;
   os << value;
-  m_prefix.push_back (os.str ());
-
-  return *this;
-}
-
-/**
- * \brief Equality operator for Name
- */
-bool
-Name::operator== (const Name &prefix) const
-{
-  if (m_prefix.size () != prefix.m_prefix.size ())
-    return false;
-
-  return std::equal (m_prefix.begin (), m_prefix.end (), prefix.m_prefix.begin ());
-}
-
-/**
- * \brief Less than operator for Name
- */
-bool
-Name::operator< (const Name &prefix) const
-{
-  return std::lexicographical_compare (m_prefix.begin (), m_prefix.end (),
-                                       prefix.m_prefix.begin (), prefix.m_prefix.end ());
+  return Add (os.str ());
 }
 
 ATTRIBUTE_HELPER_HEADER (Name);
@@ -32,6 +32,12 @@
 #include "ns3/ndn-header-helper.h"
 #include "ns3/ndn-interest.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
+
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 NS_LOG_COMPONENT_DEFINE ("ndn.ShaperNetDeviceFace");
 
@@ -89,6 +95,16 @@ private:
 
 NS_OBJECT_ENSURE_REGISTERED (ShaperNetDeviceFace);
 
+// CoDel timestamps are added and removed on every hop
+static class TimestampTagInline
+{
+public:
+  TimestampTagInline ()
+  {
+    Packet::EnableInlinePacketTag (TimestampTag::GetTypeId ());
+  }
+} g_timestampTagInline;
+
 TypeId
 ShaperNetDeviceFace::GetTypeId ()
 {
@@ -132,12 +148,35 @@ ShaperNetDeviceFace::GetTypeId ()
                    TimeValue (Seconds(0.1)),
                    MakeTimeAccessor (&ShaperNetDeviceFace::m_delayObserveInterval),
                    MakeTimeChecker ())
+    .AddAttribute ("Scheduler",
+                   "Scheduler that shares the shaping rate among interest classes (WFQ/DRR/SP_WRR)",
+                   EnumValue (SCHEDULER_WFQ),
+                   MakeEnumAccessor (&ShaperNetDeviceFace::SetScheduler, &ShaperNetDeviceFace::GetScheduler),
+                   MakeEnumChecker (SCHEDULER_WFQ, "SCHEDULER_WFQ",
+                                    SCHEDULER_DRR, "SCHEDULER_DRR",
+                                    SCHEDULER_SP_WRR, "SCHEDULER_SP_WRR"))
+    .AddAttribute ("ClassWeights",
+                   "Weights of interest classes, one per priority (number of weights defines number of classes).",
+                   StringValue ("1 2 4 8"),
+                   MakeStringAccessor (&ShaperNetDeviceFace::SetClassWeights, &ShaperNetDeviceFace::GetClassWeights),
+                   MakeStringChecker ())
+    .AddAttribute ("Quantum",
+                   "Quantum (in bytes) of an interest class with weight 1 (for DRR). "
+                   "A class whose quantum is smaller than its interests needs several rounds to send one.",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&ShaperNetDeviceFace::m_quantum),
+                   MakeUintegerChecker<uint32_t> (1))
     ;
   return tid;
 }
 
 ShaperNetDeviceFace::ShaperNetDeviceFace (Ptr<Node> node, const Ptr<NetDevice> &netDevice)
   : NetDeviceFace (node, netDevice)
+  , m_scheduler (SCHEDULER_WFQ)
+  , m_quantum (64)
+  , m_drrTurnStarted (false)
+  , m_virtualTime (0.0)
+  , m_activations (0)
   , m_lastUpdateTime (0.0)
   , m_byteSinceLastUpdate (0)
   , m_observedInInterestBitRate (0.0)
@@ -150,7 +189,25 @@ ShaperNetDeviceFace::ShaperNetDeviceFace (Ptr<Node> node, const Ptr<NetDevice> &
   , m_outContentFirst (true)
   , m_inContentFirst (false)
   , m_shaperState (OPEN)
-  , m_old_delay (0.0)
+{
+  m_headroom = 0.98;
+
+  DataRateValue dataRate;
+  netDevice->GetAttribute ("DataRate", dataRate);
+  m_outBitRate = (dataRate.Get().GetBitRate());
+  m_inBitRate = m_outBitRate; // assume symmetric bandwidth, can be overridden by SetInRate()
+}
+
+ShaperNetDeviceFace::InterestClass::InterestClass (double weight/* = 1.0*/)
+  : m_weight (weight)
+  , m_finish (0.0)
+  , m_deficit (0.0)
+  , m_active (false)
+{
+}
+
+ShaperNetDeviceFace::InterestAqm::InterestAqm ()
+  : m_old_delay (0.0)
   , m_drop_prob (0.0)
   , m_dq_count (-1)
   , m_avg_dq_rate (0.0)
@@ -161,18 +218,6 @@ ShaperNetDeviceFace::ShaperNetDeviceFace (Ptr<Node> node, const Ptr<NetDevice> &
   , m_drop_count (0)
   , m_dropping (false)
 {
-  uint8_t i;
-  for (i=8; i<4; i++) {
-    m_subShaperState[i] = OPEN;
-    m_queuePrevState[i] = 0;
-  }
-
-  m_headroom = 0.98;
-
-  DataRateValue dataRate;
-  netDevice->GetAttribute ("DataRate", dataRate);
-  m_outBitRate = (dataRate.Get().GetBitRate());
-  m_inBitRate = m_outBitRate; // assume symmetric bandwidth, can be overridden by SetInRate()
 }
 
 ShaperNetDeviceFace::~ShaperNetDeviceFace ()
@@ -180,6 +225,15 @@ ShaperNetDeviceFace::~ShaperNetDeviceFace ()
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+void
+ShaperNetDeviceFace::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  // the face can outlive the simulator, so the timer is cancelled while the simulator still exists
+  Simulator::Cancel (m_pieUpdateEvent);
+  NetDeviceFace::DoDispose ();
+}
+
 ShaperNetDeviceFace& ShaperNetDeviceFace::operator= (const ShaperNetDeviceFace &)
 {
   return *this;
@@ -197,8 +251,7 @@ ShaperNetDeviceFace::SetMode (ShaperNetDeviceFace::QueueMode mode)
 {
   NS_LOG_FUNCTION (this << mode);
   m_mode = mode;
-  if (m_mode == QUEUE_MODE_PIE)
-    Simulator::Schedule (Seconds(0.03), &ShaperNetDeviceFace::PIEUpdate, this);
+  // PIE update timer is started by the first enqueued interest
 }
 
 ShaperNetDeviceFace::QueueMode
@@ -208,28 +261,108 @@ ShaperNetDeviceFace::GetMode (void)
   return m_mode;
 }
 
-// JRO - take into account all queues
+void
+ShaperNetDeviceFace::SetScheduler (ShaperNetDeviceFace::SchedulerType scheduler)
+{
+  NS_LOG_FUNCTION (this << scheduler);
+  m_scheduler = scheduler;
+
+  // finish times are kept by all schedulers, but only WFQ keeps backlogged classes ordered by them
+  m_finishOrder.clear ();
+  m_drrTurnStarted = false;
+  for (std::list<uint32_t>::iterator cls = m_activeClasses.begin ();
+       cls != m_activeClasses.end ();
+       cls++)
+    {
+      InterestClass &c = m_classes[*cls];
+      if (m_scheduler == SCHEDULER_WFQ)
+        c.m_finishPosition = m_finishOrder.insert (std::make_pair (std::make_pair (c.m_finish, m_activations++), *cls)).first;
+
+      if (m_scheduler == SCHEDULER_SP_WRR)
+        c.m_deficit = c.m_weight;
+      else
+        c.m_deficit = 0.0;
+    }
+}
+
+ShaperNetDeviceFace::SchedulerType
+ShaperNetDeviceFace::GetScheduler () const
+{
+  return m_scheduler;
+}
+
+void
+ShaperNetDeviceFace::SetClassWeights (const std::string &weights)
+{
+  NS_LOG_FUNCTION (this << weights);
+  if (!m_activeClasses.empty ())
+    NS_FATAL_ERROR ("Interest classes cannot be changed while interests are queued");
+
+  std::string list = weights;
+  std::replace (list.begin (), list.end (), ',', ' ');
+  std::istringstream is (list);
+
+  std::vector<InterestClass> classes;
+  double weight;
+  while (is >> weight)
+    {
+      if (weight <= 0)
+        NS_FATAL_ERROR ("Weight of interest class should be positive: " << weights);
+      classes.push_back (InterestClass (weight));
+    }
+
+  if (!is.eof () || classes.empty ())
+    NS_FATAL_ERROR ("Invalid list of interest class weights: " << weights);
+
+  m_classes.swap (classes);
+}
+
+std::string
+ShaperNetDeviceFace::GetClassWeights () const
+{
+  std::ostringstream os;
+  for (std::vector<InterestClass>::const_iterator cls = m_classes.begin ();
+       cls != m_classes.end ();
+       cls++)
+    {
+      if (cls != m_classes.begin ())
+        os << " ";
+      os << cls->m_weight;
+    }
+  return os.str ();
+}
+
 void
 ShaperNetDeviceFace::PIEUpdate ()
 {
   NS_LOG_FUNCTION (this);
 
+  bool active = false;
+  for (std::vector<InterestClass>::iterator cls = m_classes.begin ();
+       cls != m_classes.end ();
+       cls++)
+    {
+      if (cls->m_aqm.PieUpdate (cls->m_queue.size (), m_delayTarget, m_maxBurst))
+        active = true;
+    }
+
+  // do not keep idle faces busy with PIE updates, the next interest restarts the timer
+  if (active)
+    m_pieUpdateEvent = Simulator::Schedule (Seconds(0.03), &ShaperNetDeviceFace::PIEUpdate, this);
+}
+
+bool
+ShaperNetDeviceFace::InterestAqm::PieUpdate (uint32_t qlen, Time delayTarget, Time maxBurst)
+{
   double qdelay;
   if (m_avg_dq_rate > 0)
-    // JRO
-    /*
-    qdelay = (m_interestPriorityQueue[0].size() +
-              m_interestPriorityQueue[1].size() +
-              m_interestPriorityQueue[2].size() +
-              m_interestPriorityQueue[3].size())/m_avg_dq_rate;
-    */
-    qdelay = m_interestQueue.size() / m_avg_dq_rate;
+    qdelay = qlen / m_avg_dq_rate;
   else
     qdelay = 0.0;
 
   NS_LOG_LOGIC(this << " PIE qdelay: " << qdelay << " old delay: " << m_old_delay);
 
-  double tmp_p = 0.125 * (qdelay - m_delayTarget.GetSeconds()) + 1.25 * (qdelay - m_old_delay);
+  double tmp_p = 0.125 * (qdelay - delayTarget.GetSeconds()) + 1.25 * (qdelay - m_old_delay);
   if (m_drop_prob < 0.01)
       tmp_p /= 8.0;
   else if (m_drop_prob < 0.1)
@@ -245,56 +378,60 @@ ShaperNetDeviceFace::PIEUpdate ()
 
   NS_LOG_LOGIC(this << " PIE: udpate drop probability to " << m_drop_prob);
 
-  if (qdelay < m_delayTarget.GetSeconds() / 2 && m_old_delay < m_delayTarget.GetSeconds() / 2 and m_drop_prob == 0.0)
+  bool reset = false;
+  if (qdelay < delayTarget.GetSeconds() / 2 && m_old_delay < delayTarget.GetSeconds() / 2 && m_drop_prob == 0.0)
     {
       m_dq_count = -1;
       m_avg_dq_rate = 0.0;
-      m_burst_allowance = m_maxBurst;
+      m_burst_allowance = maxBurst;
+      reset = true;
     }
 
   m_old_delay = qdelay;
-  Simulator::Schedule (Seconds(0.03), &ShaperNetDeviceFace::PIEUpdate, this);
+
+  // further updates of an empty class would keep resetting it to the same state
+  return !(reset && qlen == 0);
 }
 
-// JRO
-void ShaperNetDeviceFace::CalculateSubShapers(double shapingBitRate, double subShaper[4]) {
-  double sumOfWeights = 0.0;
-  // weights for each priority are hardcoded
-  // ss3 = 2ss2 = 4ss1 = 8ss0
-  double weights[4] = {1.0, 2.0, 4.0, 8.0};
-  uint8_t i;	
-  for (i=0; i<4; i++) {
-    if ((m_queuePrevState[i] == 0)&&(m_interestPriorityQueue[i].size() != 0))
+bool
+ShaperNetDeviceFace::InterestAqm::PieShouldDrop (Time delayTarget) const
+{
+  if (m_burst_allowance <= 0 && !(m_old_delay < delayTarget.GetSeconds() / 2 && m_drop_prob < 0.2))
     {
-      m_queuePrevState[i] = 1;
-      m_lastUpdateQueues = Simulator::Now();
-    } else if ((m_queuePrevState[i] == 1) &&
-        (m_interestPriorityQueue[i].size() == 0) &&
-        (Simulator::Now() - m_lastUpdateQueues >= Seconds(0.01)))
+      NS_LOG_LOGIC(this << " PIE: flip a coin to decide to drop or not " << m_drop_prob);
+      UniformVariable r (0.0, 1.0);
+      if (r.GetValue () < m_drop_prob)
+        {
+          NS_LOG_LOGIC(this << " PIE drop");
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+ShaperNetDeviceFace::InterestAqm::CodelShouldDrop (Time delayObserveInterval)
+{
+  if (m_dropping && Simulator::Now() >= m_drop_next)
     {
-      m_queuePrevState[i] = 0;
-      m_lastUpdateQueues = Simulator::Now();
+      NS_LOG_LOGIC(this << " CoDel drop");
+      m_drop_count++;
+      m_drop_next += Seconds(delayObserveInterval.GetSeconds() / sqrt(m_drop_count));
+      return true;
     }
-    // update subShapers rate
-    sumOfWeights += (m_queuePrevState[i] > 0) ? weights[i] : 0.0;
-  }
+  return false;
+}
 
-  subShaper[0] = shapingBitRate/sumOfWeights;
-  subShaper[1] = (m_queuePrevState[1] > 0) ? subShaper[0]*weights[1] : 0.0;
-  subShaper[2] = (m_queuePrevState[2] > 0) ? subShaper[0]*weights[2] : 0.0;
-  subShaper[3] = (m_queuePrevState[3] > 0) ? subShaper[0]*weights[3] : 0.0;
-  subShaper[0] = (m_queuePrevState[0] > 0) ? subShaper[0]            : 0.0;
-
-  NS_LOG_LOGIC("### queue 0 size: " << m_interestPriorityQueue[0].size());
-  NS_LOG_LOGIC("### queue 1 size: " << m_interestPriorityQueue[1].size());
-  NS_LOG_LOGIC("### queue 2 size: " << m_interestPriorityQueue[2].size());
-  NS_LOG_LOGIC("### queue 3 size: " << m_interestPriorityQueue[3].size());
-  NS_LOG_LOGIC("sumOfWeights: " << +sumOfWeights);
-  NS_LOG_LOGIC("### shaping rate: " << +shapingBitRate);
-  NS_LOG_LOGIC("### ss0: " << +subShaper[0]);
-  NS_LOG_LOGIC("### ss1: " << +subShaper[1]);
-  NS_LOG_LOGIC("### ss2: " << +subShaper[2]);
-  NS_LOG_LOGIC("### ss3: " << +subShaper[3]);
+void
+ShaperNetDeviceFace::InterestAqm::CodelEmpty ()
+{
+  if (m_dropping)
+    {
+      // leave dropping state if queue is empty
+      NS_LOG_LOGIC(this << " CoDel: leave dropping state due to empty queue");
+      m_first_above_time = Seconds(0.0);
+      m_dropping = false;
+    }
 }
 
 bool
@@ -307,61 +444,53 @@ ShaperNetDeviceFace::SendImpl (Ptr<Packet> p)
     {
     case HeaderHelper::INTEREST_NDNSIM:
       {
-        Ptr<Packet> packet = p->Copy ();
-        Ptr<Interest> header = Create<Interest> ();
-        packet->RemoveHeader (*header);
-        uint8_t interestPriority = header->GetPriority();
-        if (header->GetNack () > 0)
+        // classify without copying the packet and deserializing the Interest
+        uint8_t interestPriority = Interest::PRIORITY0;
+        uint8_t nackType = Interest::NORMAL_INTEREST;
+        HeaderHelper::GetInterestClass (p, interestPriority, nackType);
+        if (nackType > 0)
           return NetDeviceFace::SendImpl (p); // no shaping for NACK packets
 
-	// JRO
-	// UNDO: replace queue
-        if(m_interestPriorityQueue[interestPriority].size() < m_maxInterest)
+        // priorities beyond configured classes are served by the highest class
+        uint32_t cls = std::min<uint32_t> (interestPriority, m_classes.size () - 1);
+
+        if(m_classes[cls].m_queue.size() < m_maxInterest)
           {
             NS_LOG_LOGIC(this << " Max queue size " << m_maxInterest);
+            InterestAqm &aqm = m_classes[cls].m_aqm;
             if (m_mode == QUEUE_MODE_PIE)
               {
-                if (m_burst_allowance <= 0 && !(m_old_delay < m_delayTarget.GetSeconds() / 2 && m_drop_prob < 0.2))
-                  {
-                    NS_LOG_LOGIC(this << " PIE: flip a coin to decide to drop or not " << m_drop_prob);
-                    UniformVariable r (0.0, 1.0);
-                    if (r.GetValue () < m_drop_prob)
-                      {
-                        NS_LOG_LOGIC(this << " PIE drop");
-                        return false;
-                      }
-                  }
+                if (!m_pieUpdateEvent.IsRunning ())
+                  m_pieUpdateEvent = Simulator::Schedule (Seconds(0.03), &ShaperNetDeviceFace::PIEUpdate, this);
+
+                if (aqm.PieShouldDrop (m_delayTarget))
+                  return false;
               }
             else if (m_mode == QUEUE_MODE_CODEL)
               {
-                if (m_dropping && Simulator::Now() >= m_drop_next)
-                  {
-                    NS_LOG_LOGIC(this << " CoDel drop");
-                    m_drop_count++;
-                    m_drop_next += Seconds(m_delayObserveInterval.GetSeconds() / sqrt(m_drop_count));
-                    return false;
-                  }
+                if (aqm.CodelShouldDrop (m_delayObserveInterval))
+                  return false;
 
                 TimestampTag tag;
                 p->AddPacketTag(tag);
               }
 
-            // JRO
             // push into different queues depending on priority
-            m_interestPriorityQueue[interestPriority].push(p);
-            NS_LOG_LOGIC("Enqueuing " << +interestPriority);
-            NS_LOG_LOGIC("... for queue size is " << m_interestPriorityQueue[interestPriority].size());
+            m_classes[cls].m_queue.push(p);
+            if (!m_classes[cls].m_active)
+              ActivateClass (cls);
+            NS_LOG_LOGIC("Enqueuing " << cls);
+            NS_LOG_LOGIC("... for queue size is " << m_classes[cls].m_queue.size());
 
-	    // UNDO rename it
-            if (m_subShaperState[interestPriority] == OPEN) {
+            if (m_shaperState == OPEN) {
               NS_LOG_LOGIC("... and it is OPEN");
-              ShaperDequeue(interestPriority);
-   	    }
+              ShaperDequeue();
+            }
 
             return true;
           }
         else { // drop Interest but do not return Nack?
-            NS_LOG_LOGIC(this << " Tail drop, current size" << m_interestPriorityQueue[interestPriority].size());
+            NS_LOG_LOGIC(this << " Tail drop, current size" << m_classes[cls].m_queue.size());
             return false;
         }
       }
@@ -383,66 +512,161 @@ ShaperNetDeviceFace::SendImpl (Ptr<Packet> p)
       return false;
     }
 }
-// JRO
-// must have Open/Blocked for the 4 queues
 void
-ShaperNetDeviceFace::ShaperOpen (uint8_t priority) {
+ShaperNetDeviceFace::ShaperOpen ()
+{
   NS_LOG_FUNCTION (this);
 
-  NS_LOG_LOGIC("ShaperOpen for queue: " << +priority);
-
-  // UNDO: replace m_interestQueue per m_interestPriorityQueue[priority]
-  if (m_interestPriorityQueue[priority].size() > 0) {
-      ShaperDequeue(priority);
-  } else { // queue has no element
-      // JRO
-      m_subShaperState[priority] = OPEN;
-
-      if (m_mode == QUEUE_MODE_CODEL) {
-          if (m_dropping) {
-              // leave dropping state if queue is empty
-              NS_LOG_LOGIC(this << " CoDel: leave dropping state due to empty queue");
-              m_first_above_time = Seconds(0.0);
-              m_dropping = false;
+  if (!m_activeClasses.empty ())
+    {
+      ShaperDequeue ();
+    }
+  else // queues have no element
+    {
+      m_shaperState = OPEN;
+    }
+}
+
+void
+ShaperNetDeviceFace::ActivateClass (uint32_t cls)
+{
+  InterestClass &c = m_classes[cls];
+  NS_ASSERT (!c.m_active && !c.m_queue.empty ());
+
+  c.m_active = true;
+  c.m_activePosition = m_activeClasses.insert (m_activeClasses.end (), cls);
+
+  c.m_finish = std::max (m_virtualTime, c.m_finish) + c.m_queue.front ()->GetSize () / c.m_weight;
+  if (m_scheduler == SCHEDULER_WFQ)
+    c.m_finishPosition = m_finishOrder.insert (std::make_pair (std::make_pair (c.m_finish, m_activations++), cls)).first;
+
+  if (m_scheduler == SCHEDULER_SP_WRR)
+    c.m_deficit = c.m_weight;
+  else
+    c.m_deficit = 0.0;
+}
+
+void
+ShaperNetDeviceFace::DeactivateClass (uint32_t cls)
+{
+  InterestClass &c = m_classes[cls];
+  NS_ASSERT (c.m_active && c.m_queue.empty ());
+
+  c.m_active = false;
+  if (c.m_activePosition == m_activeClasses.begin ())
+    m_drrTurnStarted = false; // next class starts its turn
+  m_activeClasses.erase (c.m_activePosition);
+  if (m_scheduler == SCHEDULER_WFQ)
+    m_finishOrder.erase (c.m_finishPosition);
+  c.m_deficit = 0.0;
+}
+
+uint32_t
+ShaperNetDeviceFace::SelectClass ()
+{
+  NS_ASSERT (!m_activeClasses.empty ());
+
+  switch (m_scheduler)
+    {
+    case SCHEDULER_WFQ:
+      // smallest virtual finish time among backlogged classes
+      return m_finishOrder.begin ()->second;
+    case SCHEDULER_DRR:
+      {
+        // the class at the front of the round gets its quantum once per turn and sends while its
+        // deficit covers the head-of-line interest, then it is moved to the end of the round.
+        // A turn is O(1), and a class sends at least one interest per turn if its quantum is not
+        // smaller than interests.
+        for (;;)
+          {
+            uint32_t cls = m_activeClasses.front ();
+            InterestClass &c = m_classes[cls];
+            if (!m_drrTurnStarted)
+              {
+                c.m_deficit += m_quantum * c.m_weight;
+                m_drrTurnStarted = true;
+              }
+
+            double size = c.m_queue.front ()->GetSize ();
+            if (c.m_deficit >= size)
+              {
+                c.m_deficit -= size;
+                return cls;
+              }
+
+            m_activeClasses.splice (m_activeClasses.end (), m_activeClasses, m_activeClasses.begin ());
+            m_drrTurnStarted = false;
           }
       }
-  }
+    case SCHEDULER_SP_WRR:
+      {
+        uint32_t highest = m_classes.size () - 1;
+        if (m_classes[highest].m_active)
+          return highest;
+
+        uint32_t cls = m_activeClasses.front ();
+        InterestClass &c = m_classes[cls];
+        c.m_deficit -= 1.0;
+        if (c.m_deficit <= 0)
+          {
+            // credit is exhausted, move to the end of the round
+            c.m_deficit += c.m_weight;
+            m_activeClasses.splice (m_activeClasses.end (), m_activeClasses, m_activeClasses.begin ());
+          }
+        return cls;
+      }
+    }
+
+  NS_FATAL_ERROR ("Unknown scheduler type");
+  return 0;
 }
 
 // take interests from shaper queue and dispatch them to L2 queue 
 void
-ShaperNetDeviceFace::ShaperDequeue (uint8_t priority)
+ShaperNetDeviceFace::ShaperDequeue ()
 {
   NS_LOG_FUNCTION (this);
-  // UNDO: replace queue
-  NS_LOG_LOGIC(this << " shaper qlen: " << m_interestPriorityQueue[priority].size());
 
-  // JRO - take from priority queues
-  Ptr<Packet> p = m_interestPriorityQueue[priority].front();
+  uint32_t cls = SelectClass ();
+  InterestClass &c = m_classes[cls];
+  NS_LOG_LOGIC(this << " shaper class: " << cls << ", qlen: " << c.m_queue.size());
 
-  // all queues will be in the same mode
+  Ptr<Packet> p = c.m_queue.front();
+
+  // all queues will be in the same mode, but each class has its own AQM state
   if (m_mode == QUEUE_MODE_PIE) {
-    DequeuePIE(priority);
+    c.m_aqm.PieDequeue(c.m_queue.size());
   } else if (m_mode == QUEUE_MODE_CODEL) {
-    DequeueCODEL(p);
+    DequeueCODEL(c.m_aqm, p);
   }
 
+  c.m_queue.pop();
+  m_virtualTime = c.m_finish;
+  if (c.m_queue.empty ())
+    {
+      DeactivateClass (cls);
+      if (m_mode == QUEUE_MODE_CODEL)
+        c.m_aqm.CodelEmpty ();
+    }
+  else
+    {
+      c.m_finish += c.m_queue.front ()->GetSize () / c.m_weight;
+      if (m_scheduler == SCHEDULER_WFQ)
+        {
+          // keep the activation order for ties, so the class does not lose its place
+          uint64_t activation = c.m_finishPosition->first.second;
+          m_finishOrder.erase (c.m_finishPosition);
+          c.m_finishPosition = m_finishOrder.insert (std::make_pair (std::make_pair (c.m_finish, activation), cls)).first;
+        }
+    }
+
   double shapingBitRate = CalculateShapingRate(p->GetSize());
-  // JRO
-  // calculate sub-shapers rates and schedule event
-  double subShapingBitRate[4] = {0.0, 0.0, 0.0, 0.0};
-  CalculateSubShapers(shapingBitRate, subShapingBitRate);
-  // size in bits / rate = period
-  Time gap = Seconds (p->GetSize() * 8.0 / subShapingBitRate[priority]);
-  // pop it later to calculate subShapingRate correctly
+  Time gap = Seconds (p->GetSize() * 8.0 / shapingBitRate);
 
   NS_LOG_LOGIC("Actual shaping rate: " << shapingBitRate << "bps, Gap: " << gap);
 
-  // JRO
-  m_subShaperState[priority] = BLOCKED;
-  m_interestPriorityQueue[priority].pop();
-
-  Simulator::Schedule (gap, &ShaperNetDeviceFace::ShaperOpen, this, priority);
+  m_shaperState = BLOCKED;
+  Simulator::Schedule (gap, &ShaperNetDeviceFace::ShaperOpen, this);
 
   // send out the interest
   NetDeviceFace::SendImpl (p);
@@ -573,9 +797,8 @@ double ShaperNetDeviceFace::CalculateShapingRate (uint32_t packetSize) {
   return shapingBitRate;
 }
 // JRO - refactoring
-void ShaperNetDeviceFace::DequeuePIE (uint8_t priority) {
-      // UNDO: replace queue
-      if (m_dq_count == -1 && m_interestPriorityQueue[priority].size() >= 10) {
+void ShaperNetDeviceFace::InterestAqm::PieDequeue (uint32_t qlen) {
+      if (m_dq_count == -1 && qlen >= 10) {
           // start a measurement cycle
           NS_LOG_LOGIC(this << " PIE: start a measurement cycle");
           m_dq_start = Simulator::Now();
@@ -598,7 +821,7 @@ void ShaperNetDeviceFace::DequeuePIE (uint8_t priority) {
 	      }
               NS_LOG_LOGIC(this << " PIE: average dequeue rate " << m_avg_dq_rate);
 
-              if (m_interestQueue.size() >= 10) {
+              if (qlen >= 10) {
                   // start a measurement cycle
                   NS_LOG_LOGIC(this << " PIE: start a measurement cycle");
                   m_dq_start = Simulator::Now();
@@ -616,30 +839,33 @@ void ShaperNetDeviceFace::DequeuePIE (uint8_t priority) {
   return;
 }
 // JRO - refactoring
-void ShaperNetDeviceFace::DequeueCODEL (Ptr<Packet> p) {
+void ShaperNetDeviceFace::DequeueCODEL (InterestAqm &aqm, Ptr<Packet> p) {
       TimestampTag tag;
-      p->PeekPacketTag (tag);
+      p->RemovePacketTag (tag);
       Time sojourn_time = Simulator::Now() - tag.GetTimestamp ();
       NS_LOG_LOGIC(this << " CoDel sojourn time: " << sojourn_time);
-      p->RemovePacketTag (tag);
 
-      if (m_dropping && sojourn_time < m_delayTarget) {
+      aqm.CodelDequeue (sojourn_time, m_delayTarget, m_delayObserveInterval);
+}
+
+void ShaperNetDeviceFace::InterestAqm::CodelDequeue (Time sojourn_time, Time delayTarget, Time delayObserveInterval) {
+      if (m_dropping && sojourn_time < delayTarget) {
           // leave dropping state
           NS_LOG_LOGIC(this << " CoDel: leave dropping state due to low delay");
           m_first_above_time = Seconds(0.0);
           m_dropping = false;
         }
-      else if (!m_dropping && sojourn_time >= m_delayTarget) {
+      else if (!m_dropping && sojourn_time >= delayTarget) {
           if (m_first_above_time == Seconds(0.0)) {
               NS_LOG_LOGIC(this << " CoDel: first above time " << Simulator::Now());
-              m_first_above_time = Simulator::Now() + m_delayObserveInterval;
+              m_first_above_time = Simulator::Now() + delayObserveInterval;
           } else if (Simulator::Now() >= m_first_above_time
-                   && (Simulator::Now() - m_drop_next < m_delayObserveInterval || Simulator::Now() - m_first_above_time >= m_delayObserveInterval)) {
+                   && (Simulator::Now() - m_drop_next < delayObserveInterval || Simulator::Now() - m_first_above_time >= delayObserveInterval)) {
               // enter dropping state
               NS_LOG_LOGIC(this << " CoDel: enter dropping state");
               m_dropping = true;
 
-              if (Simulator::Now() - m_drop_next < m_delayObserveInterval)
+              if (Simulator::Now() - m_drop_next < delayObserveInterval)
                 m_drop_count = m_drop_count>2 ? m_drop_count-2 : 0;
               else
                 m_drop_count = 0;
@@ -20,9 +20,15 @@
 #define NDN_SHAPER_NET_DEVICE_FACE_H
 
 #include <queue>
+#include <vector>
+#include <list>
+#include <map>
+#include <string>
 #include "ndn-net-device-face.h"
 #include "ns3/net-device.h"
 #include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 namespace ndn {
@@ -89,7 +95,49 @@ public:
    */
   QueueMode GetMode (void);
 
+  /**
+   * \brief Enumeration of the schedulers that share the shaping rate among Interest classes
+   *
+   */
+  enum SchedulerType
+  {
+    SCHEDULER_WFQ,    ///< Weighted fair queueing (self-clocked virtual finish times)
+    SCHEDULER_DRR,    ///< Deficit round robin, quantum scaled by class weight
+    SCHEDULER_SP_WRR, ///< Strict priority for the highest class, weighted round robin for the rest
+  };
+
+  /**
+   * \brief Set the scheduler that shares the shaping rate among Interest classes
+   *
+   * Can be changed while interests are queued, the queued interests are served by the new scheduler
+   */
+  void SetScheduler (SchedulerType scheduler);
+
+  /**
+   * \brief Get the scheduler that shares the shaping rate among Interest classes
+   */
+  SchedulerType GetScheduler () const;
+
+  /**
+   * \brief Set weights of the Interest classes
+   *
+   * Number of weights defines number of classes.  Interests with priority equal or
+   * larger than number of classes are served by the highest class.  Classes cannot be
+   * changed while interests are queued (simulation is stopped with an error).
+   *
+   * \param weights Space- or comma-separated list of positive weights, e.g., "1 2 4 8"
+   */
+  void SetClassWeights (const std::string &weights);
+
+  /**
+   * \brief Get weights of the Interest classes
+   */
+  std::string GetClassWeights () const;
+
 protected:
+  virtual void
+  DoDispose ();
+
   void PIEUpdate ();
 
   virtual bool
@@ -99,15 +147,18 @@ private:
   ShaperNetDeviceFace (const ShaperNetDeviceFace &); ///< \brief Disabled copy constructor
   ShaperNetDeviceFace& operator= (const ShaperNetDeviceFace &); ///< \brief Disabled copy operator
 
-  void ShaperOpen (uint8_t priority);
-  void ShaperDequeue (uint8_t priority);
+  class InterestAqm;
+
+  void ShaperOpen ();
+  void ShaperDequeue ();
   // JRO - refactoring
   double CalculateShapingRate(uint32_t packetSize);
-  // this method calculates the sub-shapers rate based on the shaper rate
-  void CalculateSubShapers(double shapingBitRate, double subShapers[4]);
+  // select class of the next interest to be sent out, according to the scheduler
+  uint32_t SelectClass ();
+  void ActivateClass (uint32_t cls);
+  void DeactivateClass (uint32_t cls);
   // refactoring original code
-  void DequeuePIE(uint8_t priority);
-  void DequeueCODEL(Ptr<Packet> p);
+  void DequeueCODEL(InterestAqm &aqm, Ptr<Packet> p);
 
   virtual void ReceiveFromNetDevice (Ptr<NetDevice> device,
                              Ptr<const Packet> p,
@@ -116,11 +167,86 @@ private:
                              const Address &to,
                              NetDevice::PacketType packetType);
 
-  std::queue<Ptr<Packet> > m_interestQueue;
-  // JRO
-  // instead of having one interest queue here,
-  // we have 4, one per priority
-  std::queue<Ptr<Packet> > m_interestPriorityQueue[4];
+  /**
+   * \brief PIE/CoDel state of a single Interest class
+   *
+   * Each class measures its own dequeue rate (PIE) and sojourn time (CoDel), so delay
+   * of one class does not trigger drops in the other classes.
+   */
+  class InterestAqm
+  {
+  public:
+    InterestAqm ();
+
+    /// PIE: decide whether an arriving interest should be randomly dropped
+    bool
+    PieShouldDrop (Time delayTarget) const;
+
+    /// PIE: account a dequeue from the queue of length qlen (before dequeue)
+    void
+    PieDequeue (uint32_t qlen);
+
+    /**
+     * \brief PIE: periodic update of the drop probability
+     * \returns false if the class is idle and does not need further updates
+     */
+    bool
+    PieUpdate (uint32_t qlen, Time delayTarget, Time maxBurst);
+
+    /// CoDel: decide whether an arriving interest should be dropped (in dropping state)
+    bool
+    CodelShouldDrop (Time delayObserveInterval);
+
+    /// CoDel: update dropping state based on sojourn time of the dequeued interest
+    void
+    CodelDequeue (Time sojournTime, Time delayTarget, Time delayObserveInterval);
+
+    /// CoDel: leave dropping state when the queue becomes empty
+    void
+    CodelEmpty ();
+
+  private:
+    // for PIE
+    double m_old_delay;
+    double m_drop_prob;
+    int64_t m_dq_count;
+    double m_avg_dq_rate;
+    Time m_dq_start;
+    Time m_burst_allowance;
+
+    // for CoDel
+    Time m_first_above_time;
+    Time m_drop_next;
+    uint32_t m_drop_count;
+    bool m_dropping;
+  };
+
+  /**
+   * \brief Per-priority Interest class served by the shaper
+   */
+  struct InterestClass
+  {
+    InterestClass (double weight = 1.0);
+
+    std::queue<Ptr<Packet> > m_queue;
+    InterestAqm m_aqm;
+    double m_weight;
+    double m_finish;  ///< WFQ: virtual finish time of the head-of-line interest
+    double m_deficit; ///< DRR: deficit counter (bytes), WRR: remaining credit (packets)
+    bool m_active;    ///< class is backlogged and is in the active class list
+    std::list<uint32_t>::iterator m_activePosition;
+    std::map<std::pair<double, uint64_t>, uint32_t>::iterator m_finishPosition; ///< WFQ: position in m_finishOrder
+  };
+
+  std::vector<InterestClass> m_classes;
+  std::list<uint32_t> m_activeClasses; ///< backlogged classes, in round-robin order
+  // WFQ: backlogged classes ordered by virtual finish time, ties are broken by activation order
+  std::map<std::pair<double, uint64_t>, uint32_t> m_finishOrder;
+  SchedulerType m_scheduler;
+  uint32_t m_quantum;                  ///< DRR quantum (bytes) of a class with weight 1
+  bool m_drrTurnStarted;               ///< DRR: class at the front of the round has got its quantum
+  double m_virtualTime;                ///< WFQ virtual time (finish time of the last sent interest)
+  uint64_t m_activations;              ///< WFQ: number of class activations, used to break ties
 
   uint32_t m_maxInterest;
   double m_headroom;
@@ -149,31 +275,14 @@ private:
     BLOCKED
   };
 
-  // TODO: remove this line
   ShaperState m_shaperState;
-  // JRO
-  ShaperState m_subShaperState[4];
-  uint8_t m_queuePrevState[4];
-  Time m_lastUpdateQueues;
 
   QueueMode m_mode;
   Time m_delayTarget; // for PIE or CoDel
   Time m_maxBurst; // for PIE
   Time m_delayObserveInterval; // for CoDel
 
-  // for PIE
-  double m_old_delay;
-  double m_drop_prob;
-  int64_t m_dq_count;
-  double m_avg_dq_rate;
-  Time m_dq_start;
-  Time m_burst_allowance;
-
-  // for CoDel
-  Time m_first_above_time;
-  Time m_drop_next;
-  uint32_t m_drop_count;
-  bool m_dropping;
+  EventId m_pieUpdateEvent; ///< PIE update timer shared by all classes, runs only while some class is not idle
 };
 
 } // namespace ndn
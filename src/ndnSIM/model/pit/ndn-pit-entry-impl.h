@@ -44,35 +44,26 @@ public:
   : Entry (pit, header, fibEntry)
   , item_ (0)
   {
-    CONTAINER.i_time.insert (*this);
-    CONTAINER.RescheduleCleaning ();
+    CONTAINER.UpdateExpiration (*this);
   }
   
   virtual ~EntryImpl ()
   {
-    CONTAINER.i_time.erase (Pit::time_index::s_iterator_to (*this));
-    
-    CONTAINER.RescheduleCleaning ();
+    CONTAINER.i_time.erase (*this);
   }
 
   virtual void
   UpdateLifetime (const Time &offsetTime)
   {
-    CONTAINER.i_time.erase (Pit::time_index::s_iterator_to (*this));
     super::UpdateLifetime (offsetTime);
-    CONTAINER.i_time.insert (*this);
-
-    CONTAINER.RescheduleCleaning ();
+    CONTAINER.UpdateExpiration (*this);
   }
 
   virtual void
   OffsetLifetime (const Time &offsetTime)
   {
-    CONTAINER.i_time.erase (Pit::time_index::s_iterator_to (*this));
     super::OffsetLifetime (offsetTime);
-    CONTAINER.i_time.insert (*this);
-
-    CONTAINER.RescheduleCleaning ();
+    CONTAINER.UpdateExpiration (*this);
   }
   
   // to make sure policies work
@@ -83,20 +74,31 @@ public:
   typename Pit::super::const_iterator to_iterator () const { return item_; }
 
 public:
-  boost::intrusive::set_member_hook<> time_hook_;
+  ndnSIM::timer_wheel_hook time_hook_;
   
 private:
   typename Pit::super::iterator item_;
 };
 
+/**
+ * @brief Maps expiration time of PIT entry to the tick of PIT's timer wheel (rounding up)
+ */
 template<class T>
-struct TimestampIndex
+struct ExpireTick
 {
-  bool
-  operator () (const T &a, const T &b) const
+  ExpireTick (int64_t tick = 1)
+    : m_tick (tick)
   {
-    return a.GetExpireTime () < b.GetExpireTime ();
   }
+
+  uint64_t
+  operator () (const T &item) const
+  {
+    int64_t expire = item.GetExpireTime ().GetTimeStep ();
+    return expire <= 0 ? 0 : (expire + m_tick - 1) / m_tick;
+  }
+
+  int64_t m_tick; ///< @brief Duration of one tick in simulator time steps
 };
 
 } // namespace pit
@@ -31,6 +31,7 @@
 #include <boost/lambda/lambda.hpp>
 #include <boost/lambda/bind.hpp>
 #include <boost/foreach.hpp>
+#include <algorithm>
 namespace ll = boost::lambda;
 
 NS_LOG_COMPONENT_DEFINE ("ndn.pit.Entry");
@@ -102,13 +103,14 @@ Entry::GetExpireTime () const
 bool
 Entry::IsNonceSeen (uint32_t nonce) const
 {
-  return m_seenNonces.find (nonce) != m_seenNonces.end ();
+  return std::find (m_seenNonces.begin (), m_seenNonces.end (), nonce) != m_seenNonces.end ();
 }
 
 void
 Entry::AddSeenNonce (uint32_t nonce)
 {
-  m_seenNonces.insert (nonce);
+  if (!IsNonceSeen (nonce))
+    m_seenNonces.push_back (nonce);
 }
 
 
@@ -120,6 +122,7 @@ Entry::AddIncoming (Ptr<Face> face)
 
   // NS_ASSERT_MSG (ret.second, "Something is wrong");
 
+  LinkFace (face);
   return ret.first;
 }
 
@@ -127,12 +130,14 @@ void
 Entry::RemoveIncoming (Ptr<Face> face)
 {
   m_incoming.erase (face);
+  UnlinkUnusedFaces ();
 }
 
 void
 Entry::ClearIncoming ()
 {
   m_incoming.clear ();
+  UnlinkUnusedFaces ();
 }
 
 Entry::out_iterator
@@ -147,6 +152,8 @@ Entry::AddOutgoing (Ptr<Face> face)
       // m_outgoing.modify (ret.first,
       //                    ll::bind (&OutgoingFace::UpdateOnRetransmit, ll::_1));
     }
+  else
+    LinkFace (face);
 
   return ret.first;
 }
@@ -155,6 +162,7 @@ void
 Entry::ClearOutgoing ()
 {
   m_outgoing.clear ();
+  UnlinkUnusedFaces ();
 }
 
 void
@@ -170,6 +178,37 @@ Entry::RemoveAllReferencesToFace (Ptr<Face> face)
 
   if (outgoing != m_outgoing.end ())
     m_outgoing.erase (outgoing);
+
+  UnlinkUnusedFaces ();
+}
+
+void
+Entry::LinkFace (Ptr<Face> face)
+{
+  for (ndnSIM::small_vector<FaceLink, 4>::iterator link = m_faceLinks.begin ();
+       link != m_faceLinks.end ();
+       link ++)
+    {
+      if (link->m_face == face)
+        return;
+    }
+
+  m_faceLinks.push_back (FaceLink (this, face));
+  m_container.m_faceIndex.insert (face->GetId (), m_faceLinks.back ());
+}
+
+void
+Entry::UnlinkUnusedFaces ()
+{
+  for (uint32_t i = m_faceLinks.size (); i > 0; i--)
+    {
+      Ptr<Face> face = m_faceLinks[i - 1].m_face;
+      if (m_incoming.find (face) == m_incoming.end () &&
+          m_outgoing.find (face) == m_outgoing.end ())
+        {
+          m_faceLinks.erase (m_faceLinks.begin () + (i - 1));
+        }
+    }
 }
 
 // void
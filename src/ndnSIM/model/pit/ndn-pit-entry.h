@@ -28,6 +28,11 @@
 
 #include "ns3/ndn-pit-entry-incoming-face.h"
 #include "ns3/ndn-pit-entry-outgoing-face.h"
+#include "ns3/ndn-fw-tag.h"
+
+#include "ns3/ndnSIM/utils/small-vector.h"
+#include "ns3/ndnSIM/utils/small-set.h"
+#include "ns3/ndnSIM/utils/face-index.h"
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/tag.hpp>
@@ -36,7 +41,6 @@
 // #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
 // #include <boost/multi_index/mem_fun.hpp>
-#include <set>
 #include <boost/shared_ptr.hpp>
 
 namespace ns3 {
@@ -44,8 +48,6 @@ namespace ndn {
 
 class Pit;
 
-namespace fw { class Tag; }
-
 namespace pit {
 
 /// @cond include_hidden
@@ -82,6 +84,53 @@ class i_retx {};
 // };
 
 
+class Entry;
+
+/**
+ * @brief Link of PIT entry into the per-face list of entries that have incoming or
+ * outgoing records for the face
+ *
+ * Copy of a link takes over position of the original in the per-face list (and the original
+ * is unlinked), so links can be stored in a container that relocates its elements.
+ */
+struct FaceLink
+{
+  FaceLink (Entry *entry, Ptr<Face> face)
+    : m_entry (entry)
+    , m_face (face)
+  {
+  }
+
+  FaceLink (const FaceLink &other)
+    : m_entry (other.m_entry)
+    , m_face (other.m_face)
+  {
+    m_hook.swap_nodes (const_cast<FaceLink&> (other).m_hook);
+  }
+
+  FaceLink &
+  operator= (const FaceLink &other)
+  {
+    if (this != &other)
+      {
+        m_hook.unlink ();
+        m_entry = other.m_entry;
+        m_face = other.m_face;
+        m_hook.swap_nodes (const_cast<FaceLink&> (other).m_hook);
+      }
+    return *this;
+  }
+
+  Entry *m_entry;   ///< @brief PIT entry that references the face
+  Ptr<Face> m_face; ///< @brief Referenced face
+  ndnSIM::face_index_hook m_hook;
+};
+
+/**
+ * @brief Index of PIT entries by faces of their incoming and outgoing records
+ */
+typedef ndnSIM::face_index<FaceLink, &FaceLink::m_hook> FaceIndex;
+
 /**
  * \ingroup ndn
  * \brief structure for PIT entry
@@ -91,14 +140,17 @@ class i_retx {};
 class Entry : public SimpleRefCount<Entry>
 {
 public:
-  typedef std::set< IncomingFace > in_container; ///< @brief incoming faces container type
+  // Almost all entries have only a few incoming/outgoing faces and nonces, so they are kept
+  // inline in the entry and searched linearly
+
+  typedef ndnSIM::small_set< IncomingFace, 4 > in_container; ///< @brief incoming faces container type
   typedef in_container::iterator in_iterator;                ///< @brief iterator to incoming faces
 
   // typedef OutgoingFaceContainer::type out_container; ///< @brief outgoing faces container type
-  typedef std::set< OutgoingFace > out_container; ///< @brief outgoing faces container type
+  typedef ndnSIM::small_set< OutgoingFace, 4 > out_container; ///< @brief outgoing faces container type
   typedef out_container::iterator out_iterator;              ///< @brief iterator to outgoing faces
 
-  typedef std::set< uint32_t > nonce_container;  ///< @brief nonce container type
+  typedef ndnSIM::small_vector< uint32_t, 8 > nonce_container;  ///< @brief nonce container type
 
   /**
    * \brief PIT entry constructor
@@ -270,9 +322,14 @@ public:
 
   /**
    * @brief Add new forwarding strategy tag
+   *
+   * Tags are indexed by their static type: tag added as boost::shared_ptr<T> can be
+   * retrieved only using GetFwTag<T> (previously added tag of the same type is replaced).
+   * Adding a tag as boost::shared_ptr<fw::Tag> does not compile.
    */
+  template<class T>
   inline void
-  AddFwTag (boost::shared_ptr< fw::Tag > tag);
+  AddFwTag (boost::shared_ptr< T > tag);
 
   /**
    * @brief Get forwarding strategy tag (tag is not removed)
@@ -297,6 +354,18 @@ public:
 private:
   friend std::ostream& operator<< (std::ostream& os, const Entry &entry);
 
+  /**
+   * @brief Make sure entry is in the per-face list of face
+   */
+  void
+  LinkFace (Ptr<Face> face);
+
+  /**
+   * @brief Remove entry from per-face lists of faces that are no longer in incoming or outgoing records
+   */
+  void
+  UnlinkUnusedFaces ();
+
 protected:
   Pit &m_container; ///< @brief Reference to the container (to rearrange indexes, if necessary)
 
@@ -312,7 +381,9 @@ protected:
   Time m_lastRetransmission; ///< @brief Last time when number of retransmissions were increased
   uint32_t m_maxRetxCount;   ///< @brief Maximum allowed number of retransmissions via outgoing faces
 
-  std::list< boost::shared_ptr<fw::Tag> > m_fwTags; ///< @brief Forwarding strategy tags
+  ndnSIM::small_vector< boost::shared_ptr<fw::Tag>, 2 > m_fwTags; ///< @brief Forwarding strategy tags, indexed by fw::TagSlot
+
+  ndnSIM::small_vector< FaceLink, 4 > m_faceLinks; ///< @brief Links into per-face lists of PIT entries (one for each face in m_incoming and m_outgoing)
 };
 
 struct EntryIsNotEmpty
@@ -326,69 +397,35 @@ struct EntryIsNotEmpty
 
 std::ostream& operator<< (std::ostream& os, const Entry &entry);
 
+template<class T>
 inline void
-Entry::AddFwTag (boost::shared_ptr< fw::Tag > tag)
+Entry::AddFwTag (boost::shared_ptr< T > tag)
 {
-  m_fwTags.push_back (tag);
+  uint32_t slot = fw::TagSlot<T>::Get ();
+  if (m_fwTags.size () <= slot)
+    m_fwTags.resize (slot + 1);
+
+  m_fwTags[slot] = tag;
 }
 
-/**
- * @brief Get and remove forwarding strategy tag
- */
 template<class T>
 inline boost::shared_ptr< T >
 Entry::GetFwTag ()
 {
-  for (std::list< boost::shared_ptr<fw::Tag> >::iterator item = m_fwTags.begin ();
-       item != m_fwTags.end ();
-       item ++)
-    {
-      boost::shared_ptr< T > retPtr = boost::dynamic_pointer_cast<T> (*item);
-      if (retPtr != boost::shared_ptr< T > ())
-        {
-          return retPtr;
-        }
-    }
-
-  return boost::shared_ptr< T > ();
-}
+  uint32_t slot = fw::TagSlot<T>::Get ();
+  if (m_fwTags.size () <= slot)
+    return boost::shared_ptr< T > ();
 
-// /**
-//  * @brief Peek the forwarding strategy tag
-//  */
-// template<class T>
-// inline boost::shared_ptr< const T >
-// Entry::PeekFwTag () const
-// {
-//   for (std::list< boost::shared_ptr<fw::Tag> >::const_iterator item = m_fwTags.begin ();
-//        item != m_fwTags.end ();
-//        item ++)
-//     {
-//       boost::shared_ptr< const T > retPtr = boost::dynamic_pointer_cast<const T> (*item);
-//       if (retPtr != 0)
-//         {
-//           return retPtr;
-//         }
-//     }
-
-//   return 0;
-// }
+  return boost::static_pointer_cast< T > (m_fwTags[slot]);
+}
 
 template<class T>
 inline void
 Entry::RemoveFwTag ()
 {
-  for (std::list< boost::shared_ptr<fw::Tag> >::iterator item = m_fwTags.begin ();
-       item != m_fwTags.end ();
-       item ++)
-    {
-      boost::shared_ptr< T > retPtr = boost::dynamic_pointer_cast< T > (*item);
-      if (retPtr != boost::shared_ptr< T > ())
-        {
-          m_fwTags.erase (item);
-          return;
-        }
-    }
+  uint32_t slot = fw::TagSlot<T>::Get ();
+  if (m_fwTags.size () > slot)
+    m_fwTags[slot].reset ();
 }
 
 
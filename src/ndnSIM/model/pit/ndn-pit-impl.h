@@ -25,8 +25,10 @@
 
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 
 #include "../../utils/trie/trie-with-policy.h"
+#include "../../utils/timer-wheel.h"
 #include "ndn-pit-entry-impl.h"
 
 #include "ns3/ndn-interest.h"
@@ -34,6 +36,8 @@
 #include "ns3/ndn-forwarding-strategy.h"
 #include "ns3/ndn-name.h"
 
+#include <boost/bind.hpp>
+
 
 namespace ns3 {
 namespace ndn {
@@ -117,8 +121,10 @@ public:
   GetPolicy () { return super::getPolicy (); }
 
 protected:
+  void UpdateExpiration (EntryImpl< PitImpl< Policy > > &item);
   void RescheduleCleaning ();
   void CleanExpired ();
+  void EraseTimedOut (EntryImpl< PitImpl< Policy > > &item);
 
   // inherited from Object class
   virtual void NotifyNewAggregate (); ///< @brief Even when object is aggregated to another Object
@@ -134,21 +140,25 @@ private:
   uint32_t
   GetCurrentSize () const;
 
+  Time
+  GetExpirationTick () const;
+
+  void
+  SetExpirationTick (const Time &tick);
+
+  uint64_t
+  GetCurrentTick () const;
+
 private:
   EventId m_cleanEvent;
+  uint64_t m_cleanTick; ///< @brief Tick of the timer wheel at which m_cleanEvent is scheduled
   Ptr<Fib> m_fib; ///< \brief Link to FIB table
   Ptr<ForwardingStrategy> m_forwardingStrategy;
 
   static LogComponent g_log; ///< @brief Logging variable
 
   // indexes
-  typedef
-  boost::intrusive::multiset<entry,
-                        boost::intrusive::compare < TimestampIndex< entry > >,
-                        boost::intrusive::member_hook< entry,
-                                                       boost::intrusive::set_member_hook<>,
-                                                       &entry::time_hook_>
-                        > time_index;
+  typedef ndnSIM::timer_wheel<entry, &entry::time_hook_, ExpireTick< entry > > time_index;
   time_index i_time;
 
   friend class EntryImpl< PitImpl >;
@@ -182,6 +192,14 @@ PitImpl< Policy >::GetTypeId ()
                    UintegerValue (0),
                    MakeUintegerAccessor (&PitImpl< Policy >::GetCurrentSize),
                    MakeUintegerChecker<uint32_t> ())
+
+    .AddAttribute ("ExpirationTick",
+                   "Granularity of PIT entry expiration. Entries are removed at the first tick of the "
+                   "timer wheel that is not earlier than their expiration time",
+                   StringValue ("1ms"),
+                   MakeTimeAccessor (&PitImpl< Policy >::GetExpirationTick,
+                                     &PitImpl< Policy >::SetExpirationTick),
+                   MakeTimeChecker ())
     ;
 
   return tid;
@@ -196,6 +214,7 @@ PitImpl<Policy>::GetCurrentSize () const
 
 template<class Policy>
 PitImpl<Policy>::PitImpl ()
+  : m_cleanTick (0)
 {
 }
 
@@ -218,6 +237,30 @@ PitImpl<Policy>::SetMaxSize (uint32_t maxSize)
   super::getPolicy ().set_max_size (maxSize);
 }
 
+template<class Policy>
+Time
+PitImpl<Policy>::GetExpirationTick () const
+{
+  return TimeStep (i_time.tick_of ().m_tick);
+}
+
+template<class Policy>
+void
+PitImpl<Policy>::SetExpirationTick (const Time &tick)
+{
+  NS_ASSERT_MSG (i_time.empty (), "Expiration tick can be changed only when PIT is empty");
+  NS_ASSERT_MSG (tick.IsStrictlyPositive (), "Expiration tick should be positive");
+
+  i_time.set_tick_of (ExpireTick< entry > (tick.GetTimeStep ()));
+}
+
+template<class Policy>
+uint64_t
+PitImpl<Policy>::GetCurrentTick () const
+{
+  return Simulator::Now ().GetTimeStep () / i_time.tick_of ().m_tick;
+}
+
 template<class Policy>
 void
 PitImpl<Policy>::NotifyNewAggregate ()
@@ -246,25 +289,39 @@ PitImpl<Policy>::DoDispose ()
   Pit::DoDispose ();
 }
 
+template<class Policy>
+void
+PitImpl<Policy>::UpdateExpiration (EntryImpl< PitImpl< Policy > > &item)
+{
+  uint64_t tick = i_time.insert (item, GetCurrentTick ());
+
+  // the cleaning event is moved only if the entry expires earlier than the currently scheduled tick
+  if (!m_cleanEvent.IsRunning () || tick < m_cleanTick)
+    RescheduleCleaning ();
+}
+
 template<class Policy>
 void
 PitImpl<Policy>::RescheduleCleaning ()
 {
-  // m_cleanEvent.Cancel ();
-  Simulator::Remove (m_cleanEvent); // slower, but better for memory
-  if (i_time.empty ())
+  Simulator::Remove (m_cleanEvent);
+
+  uint64_t nextTick = i_time.next_tick ();
+  if (nextTick == time_index::NONE)
     {
       // NS_LOG_DEBUG ("No items in PIT");
       return;
     }
 
-  Time nextEvent = i_time.begin ()->GetExpireTime () - Simulator::Now ();
+  Time nextTime = TimeStep (nextTick * i_time.tick_of ().m_tick);
+  Time nextEvent = nextTime - Simulator::Now ();
   if (nextEvent <= 0) nextEvent = Seconds (0);
 
   NS_LOG_DEBUG ("Schedule next cleaning in " <<
                 nextEvent.ToDouble (Time::S) << "s (at " <<
-                i_time.begin ()->GetExpireTime () << "s abs time");
+                nextTime << "s abs time");
 
+  m_cleanTick = nextTick;
   m_cleanEvent = Simulator::Schedule (nextEvent,
                                       &PitImpl<Policy>::CleanExpired, this);
 }
@@ -274,21 +331,8 @@ void
 PitImpl<Policy>::CleanExpired ()
 {
   NS_LOG_LOGIC ("Cleaning PIT. Total: " << i_time.size ());
-  Time now = Simulator::Now ();
 
-  // uint32_t count = 0;
-  while (!i_time.empty ())
-    {
-      typename time_index::iterator entry = i_time.begin ();
-      if (entry->GetExpireTime () <= now) // is the record stale?
-        {
-          m_forwardingStrategy->WillEraseTimedOutPendingInterest (entry->to_iterator ()->payload ());
-          super::erase (entry->to_iterator ());
-          // count ++;
-        }
-      else
-        break; // nothing else to do. All later records will not be stale
-    }
+  i_time.advance (GetCurrentTick (), boost::bind (&PitImpl<Policy>::EraseTimedOut, this, _1));
 
   if (super::getPolicy ().size ())
     {
@@ -298,6 +342,14 @@ PitImpl<Policy>::CleanExpired ()
   RescheduleCleaning ();
 }
 
+template<class Policy>
+void
+PitImpl<Policy>::EraseTimedOut (EntryImpl< PitImpl< Policy > > &item)
+{
+  m_forwardingStrategy->WillEraseTimedOutPendingInterest (item.to_iterator ()->payload ());
+  super::erase (item.to_iterator ());
+}
+
 template<class Policy>
 Ptr<Entry>
 PitImpl<Policy>::Lookup (const ContentObject &header)
@@ -22,6 +22,7 @@
 
 #include "ns3/ndn-interest.h"
 #include "ns3/ndn-content-object.h"
+#include "ns3/ndn-face.h"
 
 #include "ns3/log.h"
 #include "ns3/nstime.h"
@@ -70,5 +71,21 @@ Pit::~Pit ()
 {
 }
 
+std::vector< Ptr<pit::Entry> >
+Pit::GetEntriesForFace (Ptr<Face> face)
+{
+  std::vector< Ptr<pit::Entry> > entries;
+
+  pit::FaceIndex::list_type *links = m_faceIndex.find (face->GetId ());
+  if (links == 0)
+    return entries;
+
+  for (pit::FaceIndex::list_type::iterator link = links->begin (); link != links->end (); link++)
+    {
+      entries.push_back (link->m_entry);
+    }
+  return entries;
+}
+
 } // namespace ndn
 } // namespace ns3
@@ -27,6 +27,8 @@
 
 #include "ndn-pit-entry.h"
 
+#include <vector>
+
 namespace ns3 {
 namespace ndn {
 
@@ -154,6 +156,14 @@ public:
   ////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////
 
+  /**
+   * @brief Get all PIT entries that have incoming or outgoing records for the face
+   *
+   * Entries are found using per-face index, without walking the whole PIT
+   */
+  std::vector< Ptr<pit::Entry> >
+  GetEntriesForFace (Ptr<Face> face);
+
   /**
    * @brief Static call to cheat python bindings
    */
@@ -177,6 +187,11 @@ protected:
   Time m_PitEntryPruningTimout;
 
   Time m_maxPitEntryLifetime;
+
+private:
+  pit::FaceIndex m_faceIndex; ///< @brief Index of PIT entries by faces of incoming and outgoing records
+
+  friend class pit::Entry;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,82 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ndnSIM-cs-freshness.h"
+
+using namespace std;
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("ndn.CsFreshnessTest");
+
+void
+ContentStoreFreshnessTest::Add (const std::string &name, double freshness)
+{
+  Ptr<ndn::ContentObject> header = Create<ndn::ContentObject> ();
+  header->SetName (ndn::Name (name));
+  header->SetFreshness (Seconds (freshness));
+
+  NS_TEST_ASSERT_MSG_EQ (m_cs->Add (header, Create<Packet> (10)), true, "entry should have been added");
+}
+
+void
+ContentStoreFreshnessTest::CheckLookup (const std::string &name, bool expectedHit)
+{
+  Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+  interest->SetName (Create<ndn::Name> (name));
+
+  bool hit = m_cs->Lookup (interest).get<0> () != 0;
+  NS_TEST_ASSERT_MSG_EQ (hit, expectedHit, "unexpected result of lookup for " << name << " at " << Simulator::Now ().ToDouble (Time::S) << "s");
+}
+
+void
+ContentStoreFreshnessTest::CheckSize (uint32_t expectedSize)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_cs->GetSize (), expectedSize, "wrong size at " << Simulator::Now ().ToDouble (Time::S) << "s");
+}
+
+void
+ContentStoreFreshnessTest::DoRun ()
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::ndn::cs::Freshness::Lru");
+  factory.Set ("MaxSize", StringValue ("10"));
+  factory.Set ("ExpirationTick", StringValue ("100ms"));
+  m_cs = factory.Create<ndn::ContentStore> ();
+
+  Add ("/a", 0.15);
+  Add ("/b", 0); // never expires
+  Add ("/c", 1.0);
+
+  // /a is stale, but is drained only at the tick of 200ms; lookup should not return it
+  Simulator::Schedule (Seconds (0.1), &ContentStoreFreshnessTest::CheckLookup, this, std::string ("/a"), true);
+  Simulator::Schedule (Seconds (0.16), &ContentStoreFreshnessTest::CheckSize, this, 3);
+  Simulator::Schedule (Seconds (0.17), &ContentStoreFreshnessTest::CheckLookup, this, std::string ("/a"), false);
+  Simulator::Schedule (Seconds (0.18), &ContentStoreFreshnessTest::CheckSize, this, 2);
+
+  Simulator::Schedule (Seconds (0.5), &ContentStoreFreshnessTest::CheckLookup, this, std::string ("/c"), true);
+  Simulator::Schedule (Seconds (1.05), &ContentStoreFreshnessTest::CheckSize, this, 1);
+  Simulator::Schedule (Seconds (1.1), &ContentStoreFreshnessTest::CheckLookup, this, std::string ("/b"), true);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_cs = 0;
+}
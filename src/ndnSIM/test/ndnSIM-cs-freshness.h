@@ -0,0 +1,50 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NDNSIM_CS_FRESHNESS_H
+#define NDNSIM_CS_FRESHNESS_H
+
+#include "ns3/test.h"
+#include "ns3/ptr.h"
+#include "ns3/ndn-content-store.h"
+
+namespace ns3
+{
+
+class ContentStoreFreshnessTest : public TestCase
+{
+public:
+  ContentStoreFreshnessTest ()
+    : TestCase ("Content store freshness test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  void Add (const std::string &name, double freshness);
+  void CheckLookup (const std::string &name, bool expectedHit);
+  void CheckSize (uint32_t expectedSize);
+
+private:
+  Ptr<ndn::ContentStore> m_cs;
+};
+
+}
+
+#endif // NDNSIM_CS_FRESHNESS_H
@@ -0,0 +1,347 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ndnSIM-global-routing.h"
+#include "../helper/boost-graph-ndn-global-routing-helper.h"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/foreach.hpp>
+#include <limits>
+
+using namespace std;
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("ndn.GlobalRoutingTest");
+
+Ptr<ndn::Face>
+GlobalRoutingUpdateTest::GetFace (const NetDeviceContainer &link, uint32_t end)
+{
+  return link.Get (end)->GetNode ()->GetObject<ndn::L3Protocol> ()->GetFaceByNetDevice (link.Get (end));
+}
+
+void
+GlobalRoutingUpdateTest::SetLinkUp (const NetDeviceContainer &link, bool up)
+{
+  GetFace (link, 0)->SetUp (up);
+  GetFace (link, 1)->SetUp (up);
+}
+
+void
+GlobalRoutingUpdateTest::CheckRoute (Ptr<Node> node, Ptr<ndn::Face> expectedFace, int32_t expectedMetric)
+{
+  Ptr<ndn::fib::Entry> entry = node->GetObject<ndn::Fib> ()->Find (ndn::Name ("/d"));
+  NS_TEST_ASSERT_MSG_NE (entry, 0, "FIB entry should exist on node " << node->GetId ());
+
+  const ndn::fib::FaceMetric &best = entry->FindBestCandidate ();
+  NS_TEST_ASSERT_MSG_EQ (best.GetFace (), expectedFace, "wrong face on node " << node->GetId ());
+  NS_TEST_ASSERT_MSG_EQ (best.GetRoutingCost (), expectedMetric, "wrong metric on node " << node->GetId ());
+}
+
+void
+GlobalRoutingUpdateTest::CheckNextHop (Ptr<Node> node, Ptr<ndn::Face> face, int32_t expectedMetric)
+{
+  Ptr<ndn::fib::Entry> entry = node->GetObject<ndn::Fib> ()->Find (ndn::Name ("/d"));
+  NS_TEST_ASSERT_MSG_NE (entry, 0, "FIB entry should exist on node " << node->GetId ());
+
+  ndn::fib::FaceMetricContainer::type::index<ndn::fib::i_face>::type::iterator record =
+    entry->m_faces.get<ndn::fib::i_face> ().find (face);
+  NS_TEST_ASSERT_MSG_EQ ((record != entry->m_faces.get<ndn::fib::i_face> ().end ()), true,
+                         "next hop should exist on node " << node->GetId ());
+  NS_TEST_ASSERT_MSG_EQ (record->GetRoutingCost (), expectedMetric, "wrong metric on node " << node->GetId ());
+}
+
+void
+GlobalRoutingUpdateTest::CreateTopology ()
+{
+  //    b
+  //  /   \     a-b, b-d, c-d have metric 1
+  // a     d    a-c has metric 2
+  //  \   /
+  //    c
+  NodeContainer nodes;
+  nodes.Create (4);
+  m_a = nodes.Get (0);
+  m_b = nodes.Get (1);
+  m_c = nodes.Get (2);
+  m_d = nodes.Get (3);
+
+  PointToPointHelper p2p;
+  m_ab = p2p.Install (m_a, m_b);
+  m_bd = p2p.Install (m_b, m_d);
+  m_ac = p2p.Install (m_a, m_c);
+  m_cd = p2p.Install (m_c, m_d);
+
+  ndn::StackHelper ndnHelper;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      ndnHelper.Install (nodes.Get (i));
+    }
+  GetFace (m_ac, 0)->SetMetric (2);
+
+  ndn::GlobalRoutingHelper routingHelper;
+  routingHelper.InstallAll ();
+  routingHelper.AddOrigin ("/d", m_d);
+}
+
+void
+GlobalRoutingUpdateTest::CheckCalculateRoutes (bool incremental)
+{
+  CreateTopology ();
+  if (incremental)
+    ndn::GlobalRoutingHelper::EnableIncrementalUpdates ();
+  ndn::GlobalRoutingHelper::CalculateRoutes ();
+
+  CheckRoute (m_a, GetFace (m_ab, 0), 2);
+  CheckRoute (m_c, GetFace (m_cd, 0), 1);
+
+  // only the routes of a and b depend on the link
+  SetLinkUp (m_ab, false);
+  ndn::GlobalRoutingHelper::UpdateRoutes ();
+  CheckRoute (m_a, GetFace (m_ac, 0), 3);
+  CheckRoute (m_b, GetFace (m_bd, 0), 1);
+  CheckRoute (m_c, GetFace (m_cd, 0), 1);
+
+  // metric changes are handled the same way as link failures
+  GetFace (m_ac, 0)->SetMetric (5);
+  ndn::GlobalRoutingHelper::UpdateRoutes ();
+  CheckRoute (m_a, GetFace (m_ac, 0), 6);
+
+  SetLinkUp (m_ab, true);
+  ndn::GlobalRoutingHelper::UpdateRoutes ();
+  CheckRoute (m_a, GetFace (m_ab, 0), 2);
+
+  Simulator::Destroy ();
+}
+
+void
+GlobalRoutingUpdateTest::CheckCalculateAllPossibleRoutes ()
+{
+  CreateTopology ();
+  ndn::GlobalRoutingHelper::EnableIncrementalUpdates ();
+  ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes ();
+
+  CheckRoute (m_a, GetFace (m_ab, 0), 2);
+  CheckNextHop (m_a, GetFace (m_ac, 0), 3);
+  CheckNextHop (m_b, GetFace (m_ab, 1), 4);
+
+  // routes via the failed link are invalidated, other routes of the same prefix are kept
+  SetLinkUp (m_ab, false);
+  ndn::GlobalRoutingHelper::UpdateRoutes ();
+  CheckRoute (m_a, GetFace (m_ac, 0), 3);
+  CheckNextHop (m_a, GetFace (m_ab, 0), std::numeric_limits<uint16_t>::max ());
+  CheckRoute (m_b, GetFace (m_bd, 0), 1);
+  CheckNextHop (m_b, GetFace (m_ab, 1), std::numeric_limits<uint16_t>::max ());
+
+  GetFace (m_ac, 0)->SetMetric (5);
+  ndn::GlobalRoutingHelper::UpdateRoutes ();
+  CheckRoute (m_a, GetFace (m_ac, 0), 6);
+
+  SetLinkUp (m_ab, true);
+  ndn::GlobalRoutingHelper::UpdateRoutes ();
+  CheckRoute (m_a, GetFace (m_ab, 0), 2);
+  CheckNextHop (m_a, GetFace (m_ac, 0), 6);
+  CheckNextHop (m_b, GetFace (m_ab, 1), 7);
+
+  Simulator::Destroy ();
+}
+
+void
+GlobalRoutingUpdateTest::DoRun ()
+{
+  CheckCalculateRoutes (true);
+  CheckCalculateAllPossibleRoutes ();
+
+  // without kept shortest path trees, all routes are recalculated
+  CheckCalculateRoutes (false);
+}
+
+void
+GlobalRoutingReferenceTest::CreateTopology ()
+{
+  //  a --1-- b --3-- c
+  //  |       |       |     /c is exported by c, /d by d
+  //  3       2       1
+  //  |       |       |     all shortest paths are unique
+  //  d --4-- e --1-- f
+  NodeContainer nodes;
+  nodes.Create (6);
+  Ptr<Node> a = nodes.Get (0), b = nodes.Get (1), c = nodes.Get (2);
+  Ptr<Node> d = nodes.Get (3), e = nodes.Get (4), f = nodes.Get (5);
+
+  PointToPointHelper p2p;
+  std::vector<std::pair<NetDeviceContainer, uint16_t> > links;
+  links.push_back (std::make_pair (p2p.Install (a, b), 1));
+  links.push_back (std::make_pair (p2p.Install (b, c), 3));
+  links.push_back (std::make_pair (p2p.Install (a, d), 3));
+  links.push_back (std::make_pair (p2p.Install (b, e), 2));
+  links.push_back (std::make_pair (p2p.Install (c, f), 1));
+  links.push_back (std::make_pair (p2p.Install (d, e), 4));
+  links.push_back (std::make_pair (p2p.Install (e, f), 1));
+
+  ndn::StackHelper ndnHelper;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      ndnHelper.Install (nodes.Get (i));
+    }
+
+  for (uint32_t i = 0; i < links.size (); i++)
+    for (uint32_t end = 0; end < 2; end++)
+      {
+        Ptr<NetDevice> device = links[i].first.Get (end);
+        device->GetNode ()->GetObject<ndn::L3Protocol> ()->GetFaceByNetDevice (device)->SetMetric (links[i].second);
+      }
+
+  ndn::GlobalRoutingHelper routingHelper;
+  routingHelper.InstallAll ();
+  routingHelper.AddOrigin ("/c", c);
+  routingHelper.AddOrigin ("/d", d);
+}
+
+void
+GlobalRoutingReferenceTest::AddReferenceRoutes (Ptr<Node> node, Routes &routes)
+{
+  // Dijkstra over GlobalRouter interfaces, as routes were calculated before the CSR graph
+  boost::NdnGlobalRouterGraph graph;
+  Ptr<ndn::GlobalRouter> source = node->GetObject<ndn::GlobalRouter> ();
+
+  // GlobalRouter ids are not reset between simulations and cannot index vertices
+  std::map<Ptr<ndn::GlobalRouter>, uint32_t> ids;
+  BOOST_FOREACH (const Ptr<ndn::GlobalRouter> &router, graph.GetVertices ())
+    {
+      uint32_t id = ids.size ();
+      ids[router] = id;
+    }
+
+  boost::DistancesMap distances;
+  boost::dijkstra_shortest_paths (graph, source,
+                                  boost::distance_map (boost::ref (distances))
+                                  .distance_inf (boost::WeightInf)
+                                  .distance_zero (boost::WeightZero)
+                                  .distance_compare (boost::WeightCompare ())
+                                  .distance_combine (boost::WeightCombine ())
+                                  .vertex_index_map (boost::make_assoc_property_map (ids)));
+
+  for (boost::DistancesMap::iterator i = distances.begin (); i != distances.end (); i++)
+    {
+      Ptr<ndn::Face> face = i->second.get<0> ();
+      if (i->first == source || face == 0 ||
+          face->GetMetric () == std::numeric_limits<uint16_t>::max () - 1)
+        continue;
+
+      BOOST_FOREACH (const Ptr<const ndn::Name> &prefix, i->first->GetLocalPrefixes ())
+        {
+          routes[std::make_pair (node->GetId (), boost::lexical_cast<std::string> (*prefix))][face->GetId ()] = i->second.get<1> ();
+        }
+    }
+}
+
+GlobalRoutingReferenceTest::Routes
+GlobalRoutingReferenceTest::CalculateReferenceRoutes (bool allPossible)
+{
+  Routes routes;
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      if (!allPossible)
+        {
+          AddReferenceRoutes (*node, routes);
+          continue;
+        }
+
+      // enable one face at a time
+      Ptr<ndn::L3Protocol> l3 = (*node)->GetObject<ndn::L3Protocol> ();
+      std::vector<uint16_t> originalMetric (l3->GetNFaces ());
+      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
+        {
+          originalMetric[faceId] = l3->GetFace (faceId)->GetMetric ();
+          l3->GetFace (faceId)->SetMetric (std::numeric_limits<uint16_t>::max () - 1);
+        }
+
+      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
+        {
+          if (DynamicCast<ndn::NetDeviceFace> (l3->GetFace (faceId)) == 0)
+            continue;
+
+          l3->GetFace (faceId)->SetMetric (originalMetric[faceId]);
+          AddReferenceRoutes (*node, routes);
+          l3->GetFace (faceId)->SetMetric (std::numeric_limits<uint16_t>::max () - 1);
+        }
+
+      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
+        {
+          l3->GetFace (faceId)->SetMetric (originalMetric[faceId]);
+        }
+    }
+  return routes;
+}
+
+void
+GlobalRoutingReferenceTest::CheckFib (const Routes &expected)
+{
+  std::map<uint32_t, uint32_t> entriesPerNode;
+  for (Routes::const_iterator route = expected.begin (); route != expected.end (); route++)
+    {
+      Ptr<Node> node = NodeList::GetNode (route->first.first);
+      entriesPerNode[node->GetId ()]++;
+
+      Ptr<ndn::fib::Entry> entry = node->GetObject<ndn::Fib> ()->Find (ndn::Name (route->first.second));
+      NS_TEST_ASSERT_MSG_NE (entry, 0, "FIB entry " << route->first.second << " should exist on node " << node->GetId ());
+      NS_TEST_ASSERT_MSG_EQ (entry->m_faces.size (), route->second.size (),
+                             "wrong number of next hops for " << route->first.second << " on node " << node->GetId ());
+
+      for (ndn::fib::FaceMetricContainer::type::index<ndn::fib::i_face>::type::iterator record = entry->m_faces.get<ndn::fib::i_face> ().begin ();
+           record != entry->m_faces.get<ndn::fib::i_face> ().end ();
+           record++)
+        {
+          std::map<uint32_t, int32_t>::const_iterator metric = route->second.find (record->GetFace ()->GetId ());
+          NS_TEST_ASSERT_MSG_EQ ((metric != route->second.end ()), true,
+                                 "unexpected next hop for " << route->first.second << " on node " << node->GetId ());
+          NS_TEST_ASSERT_MSG_EQ (record->GetRoutingCost (), metric->second,
+                                 "wrong metric for " << route->first.second << " on node " << node->GetId ());
+        }
+    }
+
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((*node)->GetObject<ndn::Fib> ()->GetSize (), entriesPerNode[(*node)->GetId ()],
+                             "wrong number of FIB entries on node " << (*node)->GetId ());
+    }
+}
+
+void
+GlobalRoutingReferenceTest::DoRun ()
+{
+  CreateTopology ();
+  Routes expected = CalculateReferenceRoutes (false);
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 10, "every node should have routes to the prefixes of other nodes");
+  ndn::GlobalRoutingHelper::CalculateRoutes ();
+  CheckFib (expected);
+  Simulator::Destroy ();
+
+  CreateTopology ();
+  expected = CalculateReferenceRoutes (true);
+  ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes ();
+  CheckFib (expected);
+  Simulator::Destroy ();
+}
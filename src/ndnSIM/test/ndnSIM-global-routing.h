@@ -0,0 +1,80 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NDNSIM_GLOBAL_ROUTING_H
+#define NDNSIM_GLOBAL_ROUTING_H
+
+#include "ns3/test.h"
+#include "ns3/ptr.h"
+#include "ns3/ndn-face.h"
+#include "ns3/node.h"
+#include "ns3/net-device-container.h"
+
+#include <map>
+#include <string>
+
+namespace ns3
+{
+
+class GlobalRoutingUpdateTest : public TestCase
+{
+public:
+  GlobalRoutingUpdateTest ()
+    : TestCase ("Global routing update test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  void CreateTopology ();
+  void CheckCalculateRoutes (bool incremental);
+  void CheckCalculateAllPossibleRoutes ();
+
+  Ptr<ndn::Face> GetFace (const NetDeviceContainer &link, uint32_t end);
+  void SetLinkUp (const NetDeviceContainer &link, bool up);
+  void CheckRoute (Ptr<Node> node, Ptr<ndn::Face> expectedFace, int32_t expectedMetric);
+  void CheckNextHop (Ptr<Node> node, Ptr<ndn::Face> face, int32_t expectedMetric);
+
+  Ptr<Node> m_a, m_b, m_c, m_d;
+  NetDeviceContainer m_ab, m_bd, m_ac, m_cd;
+};
+
+class GlobalRoutingReferenceTest : public TestCase
+{
+public:
+  GlobalRoutingReferenceTest ()
+    : TestCase ("Global routing reference test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  // (node id, prefix) -> face id -> metric
+  typedef std::map<std::pair<uint32_t, std::string>, std::map<uint32_t, int32_t> > Routes;
+
+  void CreateTopology ();
+  Routes CalculateReferenceRoutes (bool allPossible);
+  void AddReferenceRoutes (Ptr<Node> node, Routes &routes);
+  void CheckFib (const Routes &expected);
+};
+
+}
+
+#endif // NDNSIM_GLOBAL_ROUTING_H
@@ -0,0 +1,116 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ndnSIM-name.h"
+
+#include <boost/lexical_cast.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <limits>
+
+using namespace std;
+
+namespace ns3 {
+
+using namespace ndn;
+
+NS_LOG_COMPONENT_DEFINE ("ndn.NameTest");
+
+void
+NameTest::DoRun ()
+{
+  bool interning = Name::IsComponentInterningEnabled ();
+
+  Name::EnableComponentInterning (false);
+  CheckNames (false);
+
+  Name::EnableComponentInterning (true);
+  CheckNames (true);
+
+  Name::EnableComponentInterning (interning);
+}
+
+void
+NameTest::CheckNames (bool interning)
+{
+  Name name ("/prefix/sub");
+  name (1234u) ("last");
+  NS_TEST_ASSERT_MSG_EQ (name.size (), 4, "wrong number of components");
+  NS_TEST_ASSERT_MSG_EQ (boost::lexical_cast<string> (name), "/prefix/sub/1234/last", "print failed");
+  NS_TEST_ASSERT_MSG_EQ (name.GetLastComponent (), "last", "last component failed");
+  NS_TEST_ASSERT_MSG_EQ (name.GetComponent (2).str (), "1234", "numeric component failed");
+  NS_TEST_ASSERT_MSG_EQ (name.GetComponent (0).hash (), boost::hash<string> () ("prefix"), "component hash failed");
+  NS_TEST_ASSERT_MSG_EQ ((name.GetComponent (0).id () != 0), interning, "component interning failed");
+  NS_TEST_ASSERT_MSG_EQ (boost::lexical_cast<string> (Name ()), "/", "root print failed");
+
+  NS_TEST_ASSERT_MSG_EQ (name.cut (2), Name ("/prefix/sub"), "cut failed");
+  NS_TEST_ASSERT_MSG_EQ (name.cut (4), Name (), "cut of all components failed");
+
+  // prefix hashes do not depend on how the name is created
+  NS_TEST_ASSERT_MSG_EQ (name.cut (2).GetPrefixHash (2), name.GetPrefixHash (2), "prefix hash of cut name failed");
+  NS_TEST_ASSERT_MSG_EQ (Name ("/prefix/sub").GetPrefixHash (2), name.GetPrefixHash (2), "prefix hash failed");
+  NS_TEST_ASSERT_MSG_EQ ((Name ("/sub/prefix").GetPrefixHash (2) != name.GetPrefixHash (2)), true, "prefix hash failed");
+  NS_TEST_ASSERT_MSG_EQ (name.GetComponent (1).prefix_hash (), name.GetPrefixHash (2), "component prefix hash failed");
+
+  // sequence numbers
+  Name seqName ("/prefix");
+  seqName.AddSeqNum (0).AddSeqNum (258).Add (1234u);
+  NS_TEST_ASSERT_MSG_EQ (seqName.GetComponent (1).size (), 2, "binary sequence number size failed");
+  NS_TEST_ASSERT_MSG_EQ (seqName.GetComponent (1).toSeqNum (), 0, "binary sequence number failed");
+  NS_TEST_ASSERT_MSG_EQ (seqName.GetComponent (2).toSeqNum (), 258, "binary sequence number failed");
+  NS_TEST_ASSERT_MSG_EQ (seqName.GetComponent (3).toSeqNum (), 1234, "decimal sequence number failed");
+  NS_TEST_ASSERT_MSG_EQ (seqName.GetComponent (3).isSeqNum (), false, "decimal sequence number is not binary");
+  NS_TEST_ASSERT_MSG_EQ (boost::lexical_cast<string> (seqName), "/prefix/%00%00/%00%01%02/1234", "sequence number print failed");
+  NS_TEST_ASSERT_MSG_EQ (Name ("/prefix/%00%00/%00%01%02/1234"), seqName, "sequence number parsing failed");
+  NS_TEST_ASSERT_MSG_EQ (Name ("/%00%0g").GetComponent (0).str (), "%00%0g", "invalid escape should be kept");
+  NS_TEST_ASSERT_MSG_EQ (Name ("/18446744073709551615").GetComponent (0).toSeqNum (), std::numeric_limits<uint64_t>::max (), "largest decimal sequence number failed");
+
+  // names that do not fit into inline storage
+  Name longName;
+  string value;
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      longName.Add (string ("component-") + boost::lexical_cast<string> (i));
+      value += string ("/component-") + boost::lexical_cast<string> (i);
+    }
+  longName.Add (longName.GetComponent (0)); // appending own component
+  value += "/component-0";
+  NS_TEST_ASSERT_MSG_EQ (boost::lexical_cast<string> (longName), value, "long name failed");
+  NS_TEST_ASSERT_MSG_EQ (longName, Name (value), "long name comparison failed");
+
+  // order is the same as for the list of string components
+  NS_TEST_ASSERT_MSG_EQ ((Name ("/a/b") < Name ("/a/b/c")), true, "less than failed");
+  NS_TEST_ASSERT_MSG_EQ ((Name ("/a/bb") < Name ("/a/c")), true, "less than failed");
+  NS_TEST_ASSERT_MSG_EQ ((Name ("/a/c") < Name ("/a/bb")), false, "less than failed");
+  NS_TEST_ASSERT_MSG_EQ ((Name ("/a/b") < Name ("/a/b")), false, "less than failed");
+  NS_TEST_ASSERT_MSG_EQ ((Name ("/ab/c") == Name ("/a/bc")), false, "equality failed");
+
+  // serialization
+  Buffer buffer;
+  buffer.AddAtStart (longName.GetSerializedSize ());
+  longName.Serialize (buffer.Begin ());
+
+  Name target;
+  NS_TEST_ASSERT_MSG_EQ (target.Deserialize (buffer.Begin ()), longName.GetSerializedSize (), "deserialize failed");
+  NS_TEST_ASSERT_MSG_EQ (target, longName, "deserialized name is different");
+  NS_TEST_ASSERT_MSG_EQ (target.GetComponent (3).hash (), longName.GetComponent (3).hash (), "deserialized hash is different");
+  NS_TEST_ASSERT_MSG_EQ (target.GetComponent (3).id (), longName.GetComponent (3).id (), "deserialized id is different");
+  NS_TEST_ASSERT_MSG_EQ (target.GetPrefixHash (21), longName.GetPrefixHash (21), "deserialized prefix hash is different");
+}
+
+}
@@ -0,0 +1,42 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NDNSIM_TEST_NAME_H
+#define NDNSIM_TEST_NAME_H
+
+#include "ns3/test.h"
+
+namespace ns3
+{
+
+class NameTest : public TestCase
+{
+public:
+  NameTest ()
+    : TestCase ("Name test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  void
+  CheckNames (bool interning);
+};
+
+}
+
+#endif // NDNSIM_TEST_NAME_H
@@ -24,6 +24,7 @@
 #include "ns3/point-to-point-module.h"
 
 #include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
 
 NS_LOG_COMPONENT_DEFINE ("ndn.PitTest");
 
@@ -142,4 +143,61 @@ PitTest::DoRun ()
   Simulator::Destroy ();
 }
 
+namespace
+{
+
+struct FirstTag : public ndn::fw::Tag
+{
+  FirstTag (int value) : m_value (value) { }
+  int m_value;
+};
+
+struct SecondTag : public ndn::fw::Tag
+{
+  SecondTag (int value) : m_value (value) { }
+  int m_value;
+};
+
+}
+
+void
+PitFwTagTest::DoRun ()
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Node> nodeSink = CreateObject<Node> ();
+  PointToPointHelper p2p;
+  p2p.Install (node, nodeSink);
+
+  ndn::StackHelper ndn;
+  ndn.Install (node);
+  ndn.Install (nodeSink);
+
+  ndn::StackHelper::AddRoute (node, "/", 0, 0);
+
+  Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+  interest->SetName (Create<ndn::Name> ("/tag"));
+  interest->SetNonce (1);
+  Ptr<ndn::pit::Entry> entry = node->GetObject<ndn::Pit> ()->Create (interest);
+  NS_TEST_ASSERT_MSG_NE (entry, 0, "PIT entry should be created");
+
+  NS_TEST_ASSERT_MSG_NE (ndn::fw::TagSlot<FirstTag>::Get (), ndn::fw::TagSlot<SecondTag>::Get (),
+                         "Tags of different types should have different slots");
+  NS_TEST_ASSERT_MSG_EQ ((entry->GetFwTag<FirstTag> () == 0), true, "New entry should have no tags");
+
+  entry->AddFwTag (boost::make_shared<FirstTag> (1));
+  entry->AddFwTag (boost::make_shared<SecondTag> (2));
+  NS_TEST_ASSERT_MSG_EQ (entry->GetFwTag<FirstTag> ()->m_value, 1, "Wrong tag of the first type");
+  NS_TEST_ASSERT_MSG_EQ (entry->GetFwTag<SecondTag> ()->m_value, 2, "Wrong tag of the second type");
+
+  // tag of the same type is replaced, tags of other types are kept
+  entry->AddFwTag (boost::make_shared<FirstTag> (3));
+  NS_TEST_ASSERT_MSG_EQ (entry->GetFwTag<FirstTag> ()->m_value, 3, "Tag should have been replaced");
+  entry->RemoveFwTag<FirstTag> ();
+  NS_TEST_ASSERT_MSG_EQ ((entry->GetFwTag<FirstTag> () == 0), true, "Tag should have been removed");
+  NS_TEST_ASSERT_MSG_EQ (entry->GetFwTag<SecondTag> ()->m_value, 2, "Tag of other type should be kept");
+
+  entry = 0;
+  Simulator::Destroy ();
+}
+
 }
@@ -48,6 +48,18 @@ private:
   void Check2 (Ptr<ndn::Pit> pit);
   void Check3 (Ptr<ndn::Pit> pit);
 };
+
+class PitFwTagTest : public TestCase
+{
+public:
+  PitFwTagTest ()
+    : TestCase ("PIT entry forwarding strategy tag test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
   
 }
 
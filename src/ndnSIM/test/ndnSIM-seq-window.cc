@@ -0,0 +1,117 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+
+#include "ndnSIM-seq-window.h"
+
+#include "../utils/seq-window.h"
+
+#include <map>
+
+using namespace std;
+using namespace ns3;
+using namespace ndn::ndnSIM;
+
+NS_LOG_COMPONENT_DEFINE ("ndn.SeqWindowTest");
+
+void
+SeqWindowTest::DoRun ()
+{
+  seq_window<uint32_t> window;
+  NS_TEST_ASSERT_MSG_EQ (window.empty (), true, "New window should be empty");
+  NS_TEST_ASSERT_MSG_EQ (window.find (0), 0, "Nothing is stored in a new window");
+
+  // span grows beyond the initial buffer in both directions
+  window[100] = 1;
+  window[130] = 2;
+  window[90] = 3;
+  NS_TEST_ASSERT_MSG_EQ (window.size (), 3, "Three values should be stored");
+  NS_TEST_ASSERT_MSG_EQ (*window.find (100), 1, "Wrong value after growth");
+  NS_TEST_ASSERT_MSG_EQ (*window.find (130), 2, "Wrong value after growth");
+  NS_TEST_ASSERT_MSG_EQ (*window.find (90), 3, "Wrong value after growth");
+  NS_TEST_ASSERT_MSG_EQ (window.find (110), 0, "Nothing is stored between values");
+  NS_TEST_ASSERT_MSG_EQ (window.find (89), 0, "Nothing is stored below the window");
+  NS_TEST_ASSERT_MSG_EQ (window.find (131), 0, "Nothing is stored above the window");
+
+  window.erase (110);
+  NS_TEST_ASSERT_MSG_EQ (window.size (), 3, "Erasing a missing value is a no-op");
+
+  // erasing the lowest value slides the window to the next stored one
+  window.erase (90);
+  NS_TEST_ASSERT_MSG_EQ (window.find (90), 0, "Erased value should not be found");
+  NS_TEST_ASSERT_MSG_EQ (*window.find (100), 1, "Wrong value after sliding");
+  window.erase (100);
+  window.erase (130);
+  NS_TEST_ASSERT_MSG_EQ (window.empty (), true, "All values have been erased");
+  NS_TEST_ASSERT_MSG_EQ (window.find (130), 0, "Nothing is stored in an empty window");
+
+  // values in flight of a consumer: the window slides over the buffer and wraps around,
+  // compared against a map with the same operations
+  std::map<uint32_t, uint32_t> reference;
+  uint32_t state = 1;
+  uint32_t next = 1000;
+  for (uint32_t step = 0; step < 20000; step++)
+    {
+      state = state * 1103515245 + 12345;
+      uint32_t random = (state >> 16) & 0x7fff;
+
+      if (reference.empty () || random % 3 != 0)
+        {
+          // send the next sequence number, sometimes retransmit one of the older ones
+          uint32_t seq = next ++;
+          if (random % 7 == 0 && next - 1000 > 50)
+            seq = next - 1 - random % 50;
+          window[seq] = step;
+          reference[seq] = step;
+        }
+      else
+        {
+          // receive one of the sequence numbers in flight, mostly from the beginning of the window
+          std::map<uint32_t, uint32_t>::iterator item = reference.begin ();
+          for (uint32_t skip = random % 4; skip > 0 && item != reference.end (); skip--)
+            item++;
+          if (item == reference.end ())
+            item = reference.begin ();
+          window.erase (item->first);
+          reference.erase (item);
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (window.size (), reference.size (), "Wrong number of values at step " << step);
+    }
+
+  for (uint32_t seq = 900; seq < next + 100; seq++)
+    {
+      std::map<uint32_t, uint32_t>::iterator item = reference.find (seq);
+      const uint32_t *value = window.find (seq);
+      if (item == reference.end ())
+        {
+          NS_TEST_ASSERT_MSG_EQ (value, 0, "Nothing should be stored for " << seq);
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_NE (value, 0, "Value should be stored for " << seq);
+          NS_TEST_ASSERT_MSG_EQ (*value, item->second, "Wrong value for " << seq);
+        }
+    }
+
+  window.clear ();
+  NS_TEST_ASSERT_MSG_EQ (window.empty (), true, "Window should be empty after clear");
+  window[5] = 7;
+  NS_TEST_ASSERT_MSG_EQ (*window.find (5), 7, "Window should be usable after clear");
+}
@@ -53,9 +53,28 @@ InterestSerializationTest::DoRun ()
   source.SetNack (10);
   NS_TEST_ASSERT_MSG_EQ (source.GetNack (), 10, "set/get NACK failed");
 
+  source.SetPriority (Interest::PRIORITY2);
+  NS_TEST_ASSERT_MSG_EQ (source.GetPriority (), Interest::PRIORITY2, "set/get priority failed");
+
   Packet packet (0);
   //serialization
   packet.AddHeader (source);
+
+  //classification without deserialization
+  uint8_t priority = 0xFF;
+  uint8_t nack = 0xFF;
+  NS_TEST_ASSERT_MSG_EQ (HeaderHelper::GetInterestClass (packet.Copy (), priority, nack), true, "Interest classification failed");
+  NS_TEST_ASSERT_MSG_EQ (+priority, +source.GetPriority (), "peeked priority failed");
+  NS_TEST_ASSERT_MSG_EQ (+nack, +source.GetNack (), "peeked NACK failed");
+
+  //conversion without deserialization
+  Ptr<Packet> converted = Interest::ConvertNack (packet.Copy (), Interest::NACK_GIVEUP_PIT);
+  Interest convertedTarget;
+  converted->RemoveHeader (convertedTarget);
+  NS_TEST_ASSERT_MSG_EQ (+convertedTarget.GetNack (), +Interest::NACK_GIVEUP_PIT, "converted NACK failed");
+  NS_TEST_ASSERT_MSG_EQ (+convertedTarget.GetPriority (), +source.GetPriority (), "converted priority failed");
+  NS_TEST_ASSERT_MSG_EQ (convertedTarget.GetName (), source.GetName (), "converted name failed");
+  NS_TEST_ASSERT_MSG_EQ (convertedTarget.GetNonce (), source.GetNonce (), "converted nonce failed");
 	
   //deserialization
   Interest target;
@@ -66,6 +85,53 @@ InterestSerializationTest::DoRun ()
   NS_TEST_ASSERT_MSG_EQ (source.GetInterestLifetime (), target.GetInterestLifetime (), "source/target interest lifetime failed");
   NS_TEST_ASSERT_MSG_EQ (source.GetNonce ()           , target.GetNonce ()           , "source/target nonce failed");
   NS_TEST_ASSERT_MSG_EQ (source.GetNack ()            , target.GetNack ()            , "source/target NACK failed");
+  NS_TEST_ASSERT_MSG_EQ (source.GetPriority ()        , target.GetPriority ()        , "source/target priority failed");
+}
+
+InterestNackCheckingTest::InterestNackCheckingTest ()
+  : TestCase ("Interest NACK conversion with packet checking")
+{
+  // metadata cannot be enabled after packets have been created
+  PacketMetadata::Enable ();
+}
+
+void
+InterestNackCheckingTest::DoRun ()
+{
+  // other tests may not keep the metadata consistent
+  Packet::EnableChecking ();
+
+  Interest source;
+  source.SetName (Create<Name> (boost::lexical_cast<Name> ("/test/test2")));
+  source.SetNonce (200);
+  source.SetPriority (Interest::PRIORITY1);
+
+  Ptr<Packet> packet = Create<Packet> (10);
+  packet->AddHeader (source);
+
+  Ptr<Packet> nack = Interest::ConvertNack (packet, Interest::NACK_LOOP);
+  std::ostringstream os;
+  nack->Print (os);
+
+  Interest nackTarget;
+  nack->RemoveHeader (nackTarget);
+  NS_TEST_ASSERT_MSG_EQ (+nackTarget.GetNack (), +Interest::NACK_LOOP, "converted NACK failed");
+  NS_TEST_ASSERT_MSG_EQ (+nackTarget.GetPriority (), +source.GetPriority (), "converted priority failed");
+  NS_TEST_ASSERT_MSG_EQ (nackTarget.GetName (), source.GetName (), "converted name failed");
+  NS_TEST_ASSERT_MSG_EQ (nack->GetSize (), 10, "payload of the NACK changed");
+
+  nack->AddHeader (nackTarget);
+  Ptr<Packet> interest = Interest::ConvertNack (nack, Interest::NORMAL_INTEREST);
+  Interest interestTarget;
+  interest->RemoveHeader (interestTarget);
+  NS_TEST_ASSERT_MSG_EQ (+interestTarget.GetNack (), +Interest::NORMAL_INTEREST, "NACK to Interest conversion failed");
+  NS_TEST_ASSERT_MSG_EQ (interestTarget.GetNonce (), source.GetNonce (), "converted nonce failed");
+}
+
+void
+InterestNackCheckingTest::DoTeardown ()
+{
+  Packet::DisableChecking ();
 }
 
 void
@@ -92,6 +158,19 @@ ContentObjectSerializationTest::DoRun ()
   Packet packet (0);
   //serialization
   packet.AddHeader (source);
+
+  //serialization through the template
+  ContentObjectTemplate dataTemplate (source);
+  dataTemplate.SetName (source.GetNamePtr ());
+  Packet templatePacket (0);
+  templatePacket.AddHeader (dataTemplate);
+  NS_TEST_ASSERT_MSG_EQ (templatePacket.GetSize (), packet.GetSize (), "template size failed");
+
+  std::vector<uint8_t> bytes (packet.GetSize ());
+  std::vector<uint8_t> templateBytes (templatePacket.GetSize ());
+  packet.CopyData (&bytes[0], bytes.size ());
+  templatePacket.CopyData (&templateBytes[0], templateBytes.size ());
+  NS_TEST_ASSERT_MSG_EQ ((bytes == templateBytes), true, "template serialization failed");
 	
   //deserialization
   ContentObject target;
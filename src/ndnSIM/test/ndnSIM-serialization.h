@@ -39,6 +39,16 @@ private:
   virtual void DoRun ();
 };
 
+class InterestNackCheckingTest : public TestCase
+{
+public:
+  InterestNackCheckingTest ();
+    
+private:
+  virtual void DoRun ();
+  virtual void DoTeardown ();
+};
+
 class ContentObjectSerializationTest : public TestCase
 {
 public:
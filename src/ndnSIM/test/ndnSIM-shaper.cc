@@ -0,0 +1,204 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ppp-header.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ndnSIM-shaper.h"
+
+using namespace std;
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("ndn.ShaperTest");
+
+void
+ShaperSchedulerTest::CreateFace (const std::string &scheduler, const std::string &weights, uint32_t quantum)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper p2p;
+  NetDeviceContainer link = p2p.Install (nodes.Get (0), nodes.Get (1));
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.EnableShaper (true);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      ndnHelper.Install (nodes.Get (i));
+    }
+
+  m_face = DynamicCast<ndn::ShaperNetDeviceFace> (nodes.Get (0)->GetObject<ndn::L3Protocol> ()->GetFaceByNetDevice (link.Get (0)));
+  NS_TEST_ASSERT_MSG_NE (m_face, 0, "shaper should be installed on point-to-point faces");
+
+  m_face->SetAttribute ("Scheduler", StringValue (scheduler));
+  m_face->SetAttribute ("ClassWeights", StringValue (weights));
+  m_face->SetAttribute ("Quantum", UintegerValue (quantum));
+
+  m_order.clear ();
+  link.Get (0)->TraceConnectWithoutContext ("MacTx", MakeCallback (&ShaperSchedulerTest::Transmitted, this));
+}
+
+void
+ShaperSchedulerTest::Send (const std::string &priorities)
+{
+  // interests of all classes have the same size
+  for (std::string::const_iterator priority = priorities.begin (); priority != priorities.end (); priority++)
+    {
+      ndn::Interest interest;
+      interest.SetName (Create<ndn::Name> ("/shaper/test"));
+      interest.SetNonce (1);
+      interest.SetPriority (*priority - '0');
+
+      Ptr<Packet> packet = Create<Packet> ();
+      packet->AddHeader (interest);
+      NS_TEST_ASSERT_MSG_EQ (m_face->Send (packet), true, "interest should be queued");
+    }
+}
+
+void
+ShaperSchedulerTest::SwitchScheduler (const std::string &scheduler)
+{
+  m_face->SetAttribute ("Scheduler", StringValue (scheduler));
+}
+
+void
+ShaperSchedulerTest::Transmitted (Ptr<const Packet> p)
+{
+  // MacTx is fired after the point-to-point header is added
+  Ptr<Packet> packet = p->Copy ();
+  PppHeader ppp;
+  packet->RemoveHeader (ppp);
+
+  uint8_t priority = 0;
+  uint8_t nack = 0;
+  if (ndn::HeaderHelper::GetInterestClass (packet, priority, nack) && nack == ndn::Interest::NORMAL_INTEREST)
+    m_order += static_cast<char> ('0' + priority);
+}
+
+void
+ShaperSchedulerTest::CheckOrder (const std::string &expectedOrder)
+{
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_order, expectedOrder, "wrong order of dequeued interests");
+
+  m_face = 0;
+  Simulator::Destroy ();
+}
+
+void
+ShaperSchedulerTest::DoRun ()
+{
+  // the first interest is sent right away, the rest are queued and served by the scheduler
+
+  // WFQ: twice as many interests of class 1, ties of finish times go to the class that was backlogged first
+  CreateFace ("SCHEDULER_WFQ", "1 2", 64);
+  Simulator::Schedule (Seconds (0.0), &ShaperSchedulerTest::Send, this, "000000111111");
+  CheckOrder ("010110110100");
+
+  // DRR: quantum is below the interest size, so classes need several rounds to send an interest
+  CreateFace ("SCHEDULER_DRR", "1 3 1", 7);
+  Simulator::Schedule (Seconds (0.0), &ShaperSchedulerTest::Send, this, "0000001111112");
+  CheckOrder ("0110121101000");
+
+  // SP_WRR: the highest class has strict priority, other classes are served by weighted round robin
+  CreateFace ("SCHEDULER_SP_WRR", "1 2 4", 64);
+  Simulator::Schedule (Seconds (0.0), &ShaperSchedulerTest::Send, this, "000001111" "22");
+  CheckOrder ("02201101100");
+
+  // queued interests are served after the scheduler is changed
+  CreateFace ("SCHEDULER_DRR", "1 2", 10);
+  Simulator::Schedule (Seconds (0.0), &ShaperSchedulerTest::Send, this, "000000111111");
+  Simulator::Schedule (Seconds (0.0), &ShaperSchedulerTest::SwitchScheduler, this, "SCHEDULER_WFQ");
+  CheckOrder ("010110110100");
+}
+
+void
+ShaperAqmTest::Send (uint8_t priority)
+{
+  ndn::Interest interest;
+  interest.SetName (Create<ndn::Name> ("/shaper/aqm"));
+  interest.SetNonce (1);
+  interest.SetPriority (priority);
+
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (interest);
+  m_sent[priority]++;
+  if (!m_face->Send (packet))
+    m_drops[priority]++;
+}
+
+void
+ShaperAqmTest::CheckDrops (const std::string &mode)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  // interests are shaped to about 1000 per second, so PIE measures the dequeue rate
+  // (10 dequeues) between its updates
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer link = p2p.Install (nodes.Get (0), nodes.Get (1));
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.EnableShaper (true);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      ndnHelper.Install (nodes.Get (i));
+    }
+
+  m_face = DynamicCast<ndn::ShaperNetDeviceFace> (nodes.Get (0)->GetObject<ndn::L3Protocol> ()->GetFaceByNetDevice (link.Get (0)));
+  NS_TEST_ASSERT_MSG_NE (m_face, 0, "shaper should be installed on point-to-point faces");
+
+  // queue limit is never reached, so all drops are made by the AQM
+  m_face->SetAttribute ("QueueMode", StringValue (mode));
+  m_face->SetAttribute ("ClassWeights", StringValue ("1 1"));
+  m_face->SetAttribute ("MaxInterest", UintegerValue (10000));
+  m_face->SetAttribute ("DelayTarget", TimeValue (MilliSeconds (50)));
+  m_face->SetAttribute ("DelayObserveInterval", TimeValue (MilliSeconds (100)));
+
+  // class 0 is overloaded, class 1 sends well below its share of the rate
+  m_sent.assign (2, 0);
+  m_drops.assign (2, 0);
+  for (uint32_t i = 0; i < 8000; i++)
+    Simulator::Schedule (MicroSeconds (250 * i), &ShaperAqmTest::Send, this, 0);
+  for (uint32_t i = 0; i < 20; i++)
+    Simulator::Schedule (MilliSeconds (100 * i + 1), &ShaperAqmTest::Send, this, 1);
+
+  Simulator::Stop (Seconds (3.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_GT (m_drops[0], 0, mode << " should drop interests of the overloaded class");
+  NS_TEST_ASSERT_MSG_LT (m_drops[0], m_sent[0], mode << " should not drop all interests of the overloaded class");
+  NS_TEST_ASSERT_MSG_EQ (m_drops[1], 0, mode << " should not drop interests of the class with short queue");
+
+  // the face outlives the simulator, its timers are cancelled when the node is disposed
+  Simulator::Destroy ();
+  m_face = 0;
+}
+
+void
+ShaperAqmTest::DoRun ()
+{
+  CheckDrops ("QUEUE_MODE_CODEL");
+  CheckDrops ("QUEUE_MODE_PIE");
+}
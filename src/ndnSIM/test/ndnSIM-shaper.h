@@ -0,0 +1,77 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NDNSIM_SHAPER_H
+#define NDNSIM_SHAPER_H
+
+#include "ns3/test.h"
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+#include "ns3/ndn-shaper-net-device-face.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class ShaperSchedulerTest : public TestCase
+{
+public:
+  ShaperSchedulerTest ()
+    : TestCase ("Shaper scheduler test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  void CreateFace (const std::string &scheduler, const std::string &weights, uint32_t quantum);
+  void Send (const std::string &priorities);
+  void CheckOrder (const std::string &expectedOrder);
+  void SwitchScheduler (const std::string &scheduler);
+  void Transmitted (Ptr<const Packet> p);
+
+private:
+  Ptr<ndn::ShaperNetDeviceFace> m_face;
+  std::string m_order;
+};
+
+class ShaperAqmTest : public TestCase
+{
+public:
+  ShaperAqmTest ()
+    : TestCase ("Shaper per-class AQM test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  void CheckDrops (const std::string &mode);
+  void Send (uint8_t priority);
+
+private:
+  Ptr<ndn::ShaperNetDeviceFace> m_face;
+  std::vector<uint32_t> m_sent;
+  std::vector<uint32_t> m_drops;
+};
+
+}
+
+#endif // NDNSIM_SHAPER_H
@@ -24,6 +24,13 @@
 #include "ndnSIM-serialization.h"
 #include "ndnSIM-pit.h"
 #include "ndnSIM-fib-entry.h"
+#include "ndnSIM-name.h"
+#include "ndnSIM-trie.h"
+#include "ndnSIM-timer-wheel.h"
+#include "ndnSIM-seq-window.h"
+#include "ndnSIM-cs-freshness.h"
+#include "ndnSIM-global-routing.h"
+#include "ndnSIM-shaper.h"
 
 namespace ns3
 {
@@ -37,8 +44,19 @@ public:
     SetDataDir (NS_TEST_SOURCEDIR);
 
     AddTestCase (new InterestSerializationTest ());
+    AddTestCase (new InterestNackCheckingTest ());
     AddTestCase (new ContentObjectSerializationTest ());
     AddTestCase (new FibEntryTest ());
+    AddTestCase (new NameTest ());
+    AddTestCase (new TrieTest ());
+    AddTestCase (new TimerWheelTest ());
+    AddTestCase (new SeqWindowTest ());
+    AddTestCase (new ContentStoreFreshnessTest ());
+    AddTestCase (new GlobalRoutingUpdateTest ());
+    AddTestCase (new GlobalRoutingReferenceTest ());
+    AddTestCase (new ShaperSchedulerTest ());
+    AddTestCase (new ShaperAqmTest ());
+    AddTestCase (new PitFwTagTest ());
     // AddTestCase (new PitTest ());
   }
 };
@@ -0,0 +1,107 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+
+#include "ndnSIM-timer-wheel.h"
+
+#include "../utils/timer-wheel.h"
+
+#include <vector>
+
+using namespace std;
+using namespace ns3;
+using namespace ndn::ndnSIM;
+
+NS_LOG_COMPONENT_DEFINE ("ndn.TimerWheelTest");
+
+struct TimerItem
+{
+  TimerItem () : tick_ (0), expired_ (0) {}
+
+  uint64_t tick_;
+  uint64_t expired_; ///< tick at which item was expired by the wheel
+  timer_wheel_hook hook_;
+};
+
+struct TimerItemTick
+{
+  uint64_t operator () (const TimerItem &item) const { return item.tick_; }
+};
+
+typedef timer_wheel<TimerItem, &TimerItem::hook_, TimerItemTick> wheel_type;
+
+struct ExpireAt
+{
+  ExpireAt (uint64_t &now, uint32_t &count) : now_ (now), count_ (count) {}
+
+  void operator () (TimerItem &item) const { item.expired_ = now_; count_ ++; }
+
+  uint64_t &now_;
+  uint32_t &count_;
+};
+
+void
+TimerWheelTest::DoRun ()
+{
+  wheel_type wheel;
+  NS_TEST_ASSERT_MSG_EQ ((wheel.next_tick () == wheel_type::NONE), true, "Empty wheel has nothing to do");
+
+  // expiration ticks spanning all levels of the wheel, including beyond its range
+  uint64_t ticks[] = { 1, 5, 255, 256, 257, 1000, 16383, 16384, 20000, 1048576, 5000000, 70000000, 200000000 };
+  const size_t count = sizeof (ticks) / sizeof (ticks[0]);
+
+  vector<TimerItem> items (count);
+  for (size_t i = 0; i < count; i++)
+    {
+      items[i].tick_ = ticks[i];
+      wheel.insert (items[i], 0);
+    }
+  NS_TEST_ASSERT_MSG_EQ (wheel.size (), count, "All items should be in the wheel");
+
+  // one item removed before it expires
+  TimerItem removed;
+  removed.tick_ = 300;
+  wheel.insert (removed, 0);
+  wheel.erase (removed);
+  NS_TEST_ASSERT_MSG_EQ (wheel.size (), count, "Erased item should not be in the wheel");
+
+  uint64_t now = 0;
+  uint32_t expired = 0;
+  while (!wheel.empty ())
+    {
+      now = wheel.next_tick ();
+      wheel.advance (now, ExpireAt (now, expired));
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (expired, count, "All items should have been expired");
+  for (size_t i = 0; i < count; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (items[i].expired_, ticks[i], "Item expired at a wrong tick");
+    }
+  NS_TEST_ASSERT_MSG_EQ (removed.expired_, 0, "Erased item should never expire");
+
+  // item that is already late is expired at the first tick that has not been processed yet
+  TimerItem late;
+  late.tick_ = 10;
+  NS_TEST_ASSERT_MSG_EQ (wheel.insert (late, now), now + 1, "Late item should be placed into the next tick");
+  now ++;
+  wheel.advance (now, ExpireAt (now, expired));
+  NS_TEST_ASSERT_MSG_EQ (wheel.empty (), true, "Late item should have been expired");
+  NS_TEST_ASSERT_MSG_EQ (late.expired_, now, "Late item expired at a wrong tick");
+}
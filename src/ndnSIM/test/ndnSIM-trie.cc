@@ -27,6 +27,10 @@
 #include "../utils/trie/lru-policy.h"
 #include "../utils/trie/random-policy.h"
 #include "../utils/trie/fifo-policy.h"
+#include "../utils/trie/lfu-policy.h"
+#include "../utils/trie/tinylfu-policy.h"
+#include "../utils/trie/two-queue-policy.h"
+#include "../utils/trie/arc-policy.h"
 #include "../utils/trie/multi-policy.h"
 
 #include <boost/lexical_cast.hpp>
@@ -38,108 +42,176 @@ using namespace boost;
 
 NS_LOG_COMPONENT_DEFINE ("ndn.Trie");
 
-// class Integer : public ns3::SimpleRefCount<Integer>
-// {
-// public:
-//   ::Integer (int value) : value_ (value) {}
-
-//   operator int () const { return value_; }
-// private:
-//   int value_;
-// };
+class TriePayload : public ns3::SimpleRefCount<TriePayload>
+{
+public:
+  TriePayload (int value) : value_ (value) {}
 
-// std::ostream &
-// operator << (std::ostream &os, const ::Integer &i)
-// {
-//   os << (int)i;
-//   return os;
-// }
+  operator int () const { return value_; }
+private:
+  int value_;
+};
 
 void
 TrieTest::DoRun ()
 {
-  cerr << "TrieTest is temporarily broken" << endl;
-  // typedef trie_with_policy<
-  //   ns3::NdnName,
-  //   smart_pointer_payload_traits<Integer>,
-  //   multi_policy_traits<
-  //     mpl::vector2<lru_policy_traits,random_policy_traits>
-  //     > > trie;
-  
-  // trie x;
-  // x.getPolicy ().get<0> ().set_max_size (100);
-  // x.getPolicy ().get<1> ().set_max_size (3);
-  // // // x.getPolicy ().get<1> ().set_max_size (3);
-  // // // // x.getPolicy ().get1 ().set_max_size (10);
-  // // // // x.getPolicy ().get2 ().set_max_size (3);
-  
-  // // // // x.getTrie ().PrintStat (std::cout);
-  
-  // ns3::NdnName n1,n2,n3,n4;
-  // // // // n1("a")("b")("c");
-  // // // // n2("a")("b")("d");
-  // // // // n3("a")("b")("f");
-  // // // // n4("a")("b");
-
-  // n1("a");
-  // n2("b");
-  // n3("c");
-  // n4("d");
-
-  // x.insert (n1, ns3::Create<Integer> (1));
-  // x.insert (n2, ns3::Create<Integer> (2));
-  // // // // x.longest_prefix_match (n1);
-  // x.insert (n3, ns3::Create<Integer> (3));
-  // x.insert (n4, ns3::Create<Integer> (4));
-  // x.insert (n4, ns3::Create<Integer> (4));
-
-  // std::cout << "digraph trie {\n";
-  // std::cout << x.getTrie ();
-  // std::cout << "}\n";
-
-  // Ptr<Node> node = CreateObject<Node> ();
-  // Names::Add ("TestNode", node);
-  // Ptr<ndn::App> app = CreateObject<ndn::App> ();
-  // node->AddApplication (app);
-  
-  // ObjectFactory factory ("ns3::ndn::fib::Default");
-  
-  // Ptr<ndn::Fib> fib = factory.Create<ndn::Fib> ();
-  // node->AggregateObject (fib);
-  // Ptr<ndn::Face> face = CreateObject<ndn::AppFace> (app);
-
-  // fib->Add (lexical_cast<ndn::Name> ("/bla"), face, 1);
-  // fib->Add (lexical_cast<ndn::Name> ("/bla/1"), face, 1);
-  // fib->Add (lexical_cast<ndn::Name> ("/bla/2"), face, 1);
-  // fib->Add (lexical_cast<ndn::Name> ("/bla/3"), face, 1);
-  // fib->Add (lexical_cast<ndn::Name> ("/bla/1/1"), face, 1);
-  // fib->Add (lexical_cast<ndn::Name> ("/bla/1/2"), face, 1);
-  
-  // cout << *fib << endl;
-
-  // fib->RemoveFromAll (face);
-
-  // cout << *fib << endl;
-  // BOOST_FOREACH (const trie::parent_trie &item, x.getPolicy ())
-  //   {
-  //     std::cout << *item.payload () << " " << std::endl;
-  //   }
-
-  // ns3::NdnName n4;
-  // n4("a")("c");
-    
-  // // std::cout << *x->find (n4).get<0> ();
-
-  // x->prune ();
-  // // x->find (n5).get<0> ()->erase ();
-  // x->find (n1).get<0> ()->erase ();
-    
-  // std::cout << "digraph trie {\n";
-  // std::cout << *x;
-  // std::cout << "}\n";
-
-  // x->PrintStat (std::cout);
-
-  // delete x;
+  typedef trie_with_policy<
+    ndn::Name,
+    smart_pointer_payload_traits<TriePayload>,
+    lru_policy_traits
+    > trie_type;
+
+  trie_type x;
+  x.getPolicy ().set_max_size (1000);
+
+  // more children than inline and initial buckets can hold
+  for (int i = 0; i < 100; i++)
+    {
+      ndn::Name name ("/prefix");
+      name (static_cast<uint32_t> (i));
+      NS_TEST_ASSERT_MSG_EQ (x.insert (name, Create<TriePayload> (i)).second, true, "insert failed");
+    }
+  NS_TEST_ASSERT_MSG_EQ (x.getTrie ().allocator ().allocated (), 101, "wrong number of allocated nodes");
+
+  for (int i = 0; i < 100; i++)
+    {
+      ndn::Name name ("/prefix");
+      name (static_cast<uint32_t> (i));
+      trie_type::iterator item = x.find_exact (name);
+      NS_TEST_ASSERT_MSG_EQ ((item != x.end ()), true, "lookup failed");
+      NS_TEST_ASSERT_MSG_EQ (static_cast<int> (*item->payload ()), i, "wrong payload");
+    }
+
+  NS_TEST_ASSERT_MSG_EQ ((x.find_exact (ndn::Name ("/prefix/100")) == x.end ()), true, "lookup of absent name succeeded");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<int> (*x.longest_prefix_match (ndn::Name ("/prefix/5/more"))->payload ()), 5,
+                         "longest prefix match failed");
+
+  // erased nodes are returned to the pool and recycled
+  for (int i = 0; i < 100; i++)
+    {
+      ndn::Name name ("/prefix");
+      name (static_cast<uint32_t> (i));
+      x.erase (name);
+    }
+  NS_TEST_ASSERT_MSG_EQ (x.getTrie ().allocator ().allocated (), 0, "nodes were not released");
+
+  size_t capacity = x.getTrie ().allocator ().capacity ();
+  x.insert (ndn::Name ("/other/name"), Create<TriePayload> (1));
+  NS_TEST_ASSERT_MSG_EQ (x.getTrie ().allocator ().allocated (), 2, "wrong number of allocated nodes");
+  NS_TEST_ASSERT_MSG_EQ (x.getTrie ().allocator ().capacity (), capacity, "freed nodes were not recycled");
+
+  // LFU: least frequently used item is evicted, ties are broken in favour of the older one
+  typedef trie_with_policy<
+    ndn::Name,
+    smart_pointer_payload_traits<TriePayload>,
+    lfu_policy_traits
+    > lfu_trie_type;
+
+  lfu_trie_type lfu;
+  lfu.getPolicy ().set_max_size (3);
+  lfu.insert (ndn::Name ("/a"), Create<TriePayload> (1));
+  lfu.insert (ndn::Name ("/b"), Create<TriePayload> (2));
+  lfu.insert (ndn::Name ("/c"), Create<TriePayload> (3));
+  lfu.longest_prefix_match (ndn::Name ("/a"));
+  lfu.longest_prefix_match (ndn::Name ("/a"));
+  lfu.longest_prefix_match (ndn::Name ("/b"));
+
+  lfu.insert (ndn::Name ("/d"), Create<TriePayload> (4));
+  NS_TEST_ASSERT_MSG_EQ ((lfu.find_exact (ndn::Name ("/c")) == lfu.end ()), true, "/c should have been evicted");
+  lfu.insert (ndn::Name ("/e"), Create<TriePayload> (5));
+  NS_TEST_ASSERT_MSG_EQ ((lfu.find_exact (ndn::Name ("/d")) == lfu.end ()), true, "/d should have been evicted");
+
+  int expected[] = {5, 2, 1};
+  int pos = 0;
+  for (lfu_trie_type::policy_container::iterator item = lfu.getPolicy ().begin ();
+       item != lfu.getPolicy ().end ();
+       item++, pos++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (static_cast<int> (*item->payload ()), expected[pos], "wrong LFU order");
+      NS_TEST_ASSERT_MSG_EQ (lfu_trie_type::policy_container::policy_base::get_order (&(*item)), static_cast<uint64_t> (pos), "wrong frequency");
+    }
+  NS_TEST_ASSERT_MSG_EQ (pos, 3, "wrong number of items in LFU policy");
+
+  lfu.erase (ndn::Name ("/b"));
+  lfu.longest_prefix_match (ndn::Name ("/e"));
+  NS_TEST_ASSERT_MSG_EQ (lfu.getPolicy ().size (), 2, "wrong number of items in LFU policy");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<int> (*lfu.getPolicy ().begin ()->payload ()), 5, "wrong LFU order");
+
+  // LFU with dynamic aging: new items start with frequency of the last evicted one
+  typedef trie_with_policy<
+    ndn::Name,
+    smart_pointer_payload_traits<TriePayload>,
+    lfu_aging_policy_traits
+    > lfu_aging_trie_type;
+
+  lfu_aging_trie_type aging;
+  aging.getPolicy ().set_max_size (2);
+  aging.insert (ndn::Name ("/a"), Create<TriePayload> (1));
+  aging.longest_prefix_match (ndn::Name ("/a"));
+  aging.insert (ndn::Name ("/b"), Create<TriePayload> (2));
+  aging.longest_prefix_match (ndn::Name ("/b"));
+  aging.longest_prefix_match (ndn::Name ("/b"));
+
+  aging.insert (ndn::Name ("/c"), Create<TriePayload> (3));
+  NS_TEST_ASSERT_MSG_EQ ((aging.find_exact (ndn::Name ("/a")) == aging.end ()), true, "/a should have been evicted");
+  NS_TEST_ASSERT_MSG_EQ (lfu_aging_trie_type::policy_container::policy_base::get_order (&(*aging.getPolicy ().begin ())), 1,
+                         "new item should inherit frequency of the evicted one");
+
+  // TinyLFU: new item is admitted only if it is more popular than the LRU victim
+  typedef trie_with_policy<
+    ndn::Name,
+    smart_pointer_payload_traits<TriePayload>,
+    tinylfu_policy_traits
+    > tinylfu_trie_type;
+
+  tinylfu_trie_type tinylfu;
+  tinylfu.getPolicy ().set_max_size (2);
+  tinylfu.insert (ndn::Name ("/a"), Create<TriePayload> (1));
+  tinylfu.insert (ndn::Name ("/b"), Create<TriePayload> (2));
+  tinylfu.longest_prefix_match (ndn::Name ("/a"));
+  NS_TEST_ASSERT_MSG_EQ (tinylfu.insert (ndn::Name ("/c"), Create<TriePayload> (3)).second, false, "one-hit item should not be admitted");
+  NS_TEST_ASSERT_MSG_EQ ((tinylfu.find_exact (ndn::Name ("/b")) != tinylfu.end ()), true, "/b should not have been evicted");
+  NS_TEST_ASSERT_MSG_EQ (tinylfu.insert (ndn::Name ("/c"), Create<TriePayload> (3)).second, true, "repeated item should be admitted");
+  NS_TEST_ASSERT_MSG_EQ ((tinylfu.find_exact (ndn::Name ("/b")) == tinylfu.end ()), true, "/b should have been evicted");
+  NS_TEST_ASSERT_MSG_EQ (tinylfu.getPolicy ().size (), 2, "wrong number of items in TinyLFU policy");
+
+  // 2Q: items that return after eviction from A1in go to Am
+  typedef trie_with_policy<
+    ndn::Name,
+    smart_pointer_payload_traits<TriePayload>,
+    two_queue_policy_traits
+    > two_queue_trie_type;
+
+  two_queue_trie_type twoQueue;
+  twoQueue.getPolicy ().set_max_size (4);
+  twoQueue.insert (ndn::Name ("/a"), Create<TriePayload> (1));
+  twoQueue.insert (ndn::Name ("/b"), Create<TriePayload> (2));
+  twoQueue.insert (ndn::Name ("/c"), Create<TriePayload> (3));
+  twoQueue.insert (ndn::Name ("/d"), Create<TriePayload> (4));
+  twoQueue.insert (ndn::Name ("/e"), Create<TriePayload> (5));
+  NS_TEST_ASSERT_MSG_EQ ((twoQueue.find_exact (ndn::Name ("/a")) == twoQueue.end ()), true, "/a should have been evicted");
+  twoQueue.insert (ndn::Name ("/a"), Create<TriePayload> (1));
+  NS_TEST_ASSERT_MSG_EQ ((twoQueue.find_exact (ndn::Name ("/b")) == twoQueue.end ()), true, "/b should have been evicted");
+  NS_TEST_ASSERT_MSG_EQ (twoQueue.getPolicy ().hot_size (), 1, "/a should be in Am");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<int> (*twoQueue.getPolicy ().hot_front ().payload ()), 1, "/a should be in Am");
+
+  // ARC: hit in ghost list B1 brings item into T2
+  typedef trie_with_policy<
+    ndn::Name,
+    smart_pointer_payload_traits<TriePayload>,
+    arc_policy_traits
+    > arc_trie_type;
+
+  arc_trie_type arc;
+  arc.getPolicy ().set_max_size (2);
+  arc.insert (ndn::Name ("/a"), Create<TriePayload> (1));
+  arc.insert (ndn::Name ("/b"), Create<TriePayload> (2));
+  arc.longest_prefix_match (ndn::Name ("/a"));
+  arc.insert (ndn::Name ("/c"), Create<TriePayload> (3));
+  NS_TEST_ASSERT_MSG_EQ ((arc.find_exact (ndn::Name ("/b")) == arc.end ()), true, "/b should have been evicted from T1");
+  arc.insert (ndn::Name ("/b"), Create<TriePayload> (2));
+  NS_TEST_ASSERT_MSG_EQ ((arc.find_exact (ndn::Name ("/a")) == arc.end ()), true, "/a should have been evicted from T2");
+  NS_TEST_ASSERT_MSG_EQ ((arc.find_exact (ndn::Name ("/c")) != arc.end ()), true, "/c should stay in T1");
+  NS_TEST_ASSERT_MSG_EQ (arc.getPolicy ().hot_size (), 1, "/b should be in T2");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<int> (*arc.getPolicy ().hot_front ().payload ()), 2, "/b should be in T2");
 }
-
@@ -0,0 +1,147 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+"""Loader for binary trace files written by ndnSIM tracers (TRACE_FORMAT_BINARY)
+
+As a module:
+
+    trace = load ("rate-trace.bin")   # pandas.DataFrame if pandas is available,
+                                      # otherwise dict of column name -> list of values
+
+As a script, converts binary trace to the same tab-separated format as text tracers produce:
+
+    ndn-binary-trace.py rate-trace.bin > rate-trace.txt
+"""
+
+import struct
+import sys
+
+MAGIC = b"NDNTRACE"
+VERSION = 1
+
+FLOAT64 = 0
+INT64 = 1
+STRING = 2
+
+_FORMATS = {FLOAT64: ("d", 8), INT64: ("q", 8), STRING: ("I", 4)}
+
+
+class _Reader (object):
+    def __init__ (self, data):
+        self.data = data
+        self.offset = 0
+
+    def eof (self):
+        return self.offset >= len (self.data)
+
+    def read (self, size):
+        if self.offset + size > len (self.data):
+            raise ValueError ("Truncated trace file")
+        value = self.data[self.offset:self.offset + size]
+        self.offset += size
+        return value
+
+    def u32 (self):
+        return struct.unpack ("<I", self.read (4))[0]
+
+    def string (self):
+        return self.read (self.u32 ()).decode ("utf-8")
+
+    def values (self, type, count):
+        format, size = _FORMATS[type]
+        return list (struct.unpack ("<%d%s" % (count, format), self.read (size * count)))
+
+
+def read_columns (path):
+    """Read trace file into list of (name, type, values) tuples, string values are resolved"""
+    with open (path, "rb") as f:
+        reader = _Reader (f.read ())
+
+    if reader.read (len (MAGIC)) != MAGIC:
+        raise ValueError ("%s is not a binary ndnSIM trace" % path)
+    version = reader.u32 ()
+    if version != VERSION:
+        raise ValueError ("Unsupported version of binary trace: %d" % version)
+
+    columns = []
+    for i in range (reader.u32 ()):
+        type = ord (reader.read (1))
+        columns.append ((reader.string (), type, []))
+
+    dictionary = []
+    while not reader.eof ():
+        rows = reader.u32 ()
+        for i in range (reader.u32 ()):
+            dictionary.append (reader.string ())
+
+        for name, type, values in columns:
+            changed = bytearray (reader.read ((rows + 7) // 8))
+            marked = [row for row in range (rows) if changed[row // 8] & (1 << (row % 8))]
+            stored = reader.values (type, len (marked))
+
+            # unmarked rows repeat the value of the previous row
+            block = [None] * rows
+            for row, value in zip (marked, stored):
+                block[row] = value
+            for row in range (1, rows):
+                if block[row] is None:
+                    block[row] = block[row - 1]
+
+            if type == STRING:
+                block = [dictionary[id] for id in block]
+            values.extend (block)
+
+    return columns
+
+
+def load (path):
+    """Load trace file into pandas.DataFrame (or dict of lists if pandas is not available)"""
+    columns = read_columns (path)
+    try:
+        import pandas
+    except ImportError:
+        return dict ((name, values) for name, type, values in columns)
+
+    frame = pandas.DataFrame (dict ((name, values) for name, type, values in columns),
+                              columns = [name for name, type, values in columns])
+    for name, type, values in columns:
+        if type == STRING:
+            frame[name] = frame[name].astype ("category")
+    return frame
+
+
+def _format (type, value):
+    if type == FLOAT64:
+        return "%.6g" % value
+    return str (value)
+
+
+def main (argv):
+    if len (argv) != 2:
+        sys.stderr.write ("Usage: %s <binary-trace>\n" % argv[0])
+        return 1
+
+    columns = read_columns (argv[1])
+    out = sys.stdout
+    out.write ("\t".join (name for name, type, values in columns) + "\n")
+    rows = len (columns[0][2]) if columns else 0
+    for row in range (rows):
+        out.write ("\t".join (_format (type, values[row]) for name, type, values in columns) + "\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit (main (sys.argv))
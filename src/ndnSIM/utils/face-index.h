@@ -0,0 +1,116 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FACE_INDEX_H_
+#define FACE_INDEX_H_
+
+#include <boost/intrusive/list.hpp>
+#include <boost/cstdint.hpp>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+
+/**
+ * @brief Hook that has to be a member of every item stored in face_index
+ *
+ * Item is automatically removed from the index when destroyed
+ */
+typedef boost::intrusive::list_member_hook< boost::intrusive::link_mode<boost::intrusive::auto_unlink> >
+face_index_hook;
+
+/**
+ * @brief Reverse index from faces to items (PIT entries, FIB next hops) that reference them
+ *
+ * For every face ID the index keeps an intrusive list of items, so linking, unlinking and
+ * enumerating all items of a face cost O(1) per item, independent of the table size.
+ * Face IDs are small consecutive numbers assigned by L3Protocol, lists are kept in a vector.
+ *
+ * @tparam Item  type of items
+ * @tparam Hook  pointer to face_index_hook member of Item
+ */
+template<class Item, face_index_hook Item::*Hook>
+class face_index
+{
+public:
+  typedef boost::intrusive::list< Item,
+                                  boost::intrusive::member_hook< Item, face_index_hook, Hook >,
+                                  boost::intrusive::constant_time_size<false>
+                                  > list_type;
+
+  face_index ()
+  {
+  }
+
+  ~face_index ()
+  {
+    for (typename std::vector<list_type*>::iterator list = lists_.begin (); list != lists_.end (); list++)
+      delete *list;
+  }
+
+  /**
+   * @brief Link item into the list of face faceId (item is relinked if it is already in some list)
+   */
+  void
+  insert (uint32_t faceId, Item &item)
+  {
+    if ((item.*Hook).is_linked ())
+      (item.*Hook).unlink ();
+
+    if (lists_.size () <= faceId)
+      lists_.resize (faceId + 1, 0);
+    if (lists_[faceId] == 0)
+      lists_[faceId] = new list_type ();
+
+    lists_[faceId]->push_back (item);
+  }
+
+  /**
+   * @brief Unlink item from the index
+   */
+  static void
+  erase (Item &item)
+  {
+    if ((item.*Hook).is_linked ())
+      (item.*Hook).unlink ();
+  }
+
+  /**
+   * @brief Get list of items that reference face faceId, or 0 if there are no items
+   */
+  list_type *
+  find (uint32_t faceId)
+  {
+    if (lists_.size () <= faceId || lists_[faceId] == 0 || lists_[faceId]->empty ())
+      return 0;
+    else
+      return lists_[faceId];
+  }
+
+private:
+  face_index (const face_index &);
+  face_index &operator= (const face_index &);
+
+private:
+  std::vector<list_type*> lists_;
+};
+
+} // ndnSIM
+} // ndn
+} // ns3
+
+#endif // FACE_INDEX_H_
@@ -23,6 +23,8 @@
 namespace ns3 {
 namespace ndn {
 
+NS_OBJECT_ENSURE_REGISTERED (FwHopCountTag);
+
 TypeId
 FwHopCountTag::GetTypeId ()
 {
@@ -21,6 +21,8 @@
 namespace ns3 {
 namespace ndn {
 
+NS_OBJECT_ENSURE_REGISTERED (FwPminTag);
+
 TypeId
 FwPminTag::GetTypeId ()
 {
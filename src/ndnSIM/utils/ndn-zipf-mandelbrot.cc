@@ -0,0 +1,162 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ndn-zipf-mandelbrot.h"
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#endif
+
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
+
+#include <cmath>
+#include <map>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.ZipfMandelbrot");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+typedef boost::tuple<uint32_t, double, double> ZipfParameters;
+typedef std::map<ZipfParameters, ZipfMandelbrot*> ZipfCache;
+
+/**
+ * @brief Distributions that are currently in use (distribution removes itself when destroyed)
+ */
+ZipfCache &
+GetCache ()
+{
+  static ZipfCache cache;
+  return cache;
+}
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * @brief Protects the cache, distributions can be requested and released by events that are executed in parallel
+ */
+SystemMutex g_cacheMutex;
+#endif
+
+} // namespace
+
+Ptr<const ZipfMandelbrot>
+ZipfMandelbrot::Get (uint32_t numberOfContents, double q, double s)
+{
+  ZipfMandelbrot *zipf = 0;
+  {
+#ifdef HAVE_PTHREAD_H
+    // reference is taken under the lock, so the distribution cannot be destroyed meanwhile
+    CriticalSection lock (g_cacheMutex);
+#endif
+    ZipfCache &cache = GetCache ();
+    ZipfCache::iterator item = cache.find (ZipfParameters (numberOfContents, q, s));
+    if (item != cache.end ())
+      {
+        zipf = item->second;
+        zipf->Ref ();
+      }
+    else
+      {
+        zipf = new ZipfMandelbrot (numberOfContents, q, s);
+        cache.insert (std::make_pair (ZipfParameters (numberOfContents, q, s), zipf));
+      }
+  }
+  return Ptr<const ZipfMandelbrot> (zipf, false);
+}
+
+void
+ZipfMandelbrot::Ref () const
+{
+  __sync_fetch_and_add (&m_count, 1);
+}
+
+void
+ZipfMandelbrot::Unref () const
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_cacheMutex);
+#endif
+  if (__sync_sub_and_fetch (&m_count, 1) == 0)
+    {
+      GetCache ().erase (ZipfParameters (m_N, m_q, m_s));
+      delete this;
+    }
+}
+
+ZipfMandelbrot::ZipfMandelbrot (uint32_t numberOfContents, double q, double s)
+  : m_count (1)
+  , m_N (numberOfContents)
+  , m_q (q)
+  , m_s (s)
+{
+  NS_LOG_FUNCTION (this << m_N << m_q << m_s);
+  NS_ASSERT_MSG (m_N > 0, "Number of contents should be positive");
+
+  m_Pcum = std::vector<double> (m_N + 1);
+
+  m_Pcum[0] = 0.0;
+  for (uint32_t i=1; i<=m_N; i++)
+    {
+      m_Pcum[i] = m_Pcum[i-1] + 1.0 / std::pow(i+m_q, m_s);
+    }
+
+  for (uint32_t i=1; i<=m_N; i++)
+    {
+      m_Pcum[i] = m_Pcum[i] / m_Pcum[m_N];
+      NS_LOG_LOGIC ("Cumulative probability [" << i << "]=" << m_Pcum[i]);
+    }
+
+  m_guide = std::vector<uint32_t> (m_N);
+  uint32_t rank = 1;
+  for (uint32_t j = 0; j < m_N; j++)
+    {
+      while (rank < m_N && m_Pcum[rank] < static_cast<double> (j) / m_N)
+        rank ++;
+      m_guide[j] = rank;
+    }
+}
+
+ZipfMandelbrot::~ZipfMandelbrot ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+ZipfMandelbrot::GetRank (double p) const
+{
+  uint32_t bucket = std::min<uint32_t> (static_cast<uint32_t> (p * m_N), m_N - 1);
+  uint32_t rank = m_guide[bucket];
+
+  // guide is only a starting point: correct for rounding at the bucket boundary and scan forward
+  while (rank > 1 && p <= m_Pcum[rank-1])
+    rank --;
+  while (rank <= m_N && p > m_Pcum[rank])
+    rank ++;
+
+  if (rank > m_N)
+    return 1; // same as for linear scan, should not happen
+
+  return rank;
+}
+
+} // namespace ndn
+} // namespace ns3
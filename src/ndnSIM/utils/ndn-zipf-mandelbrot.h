@@ -0,0 +1,88 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NDN_ZIPF_MANDELBROT_H
+#define NDN_ZIPF_MANDELBROT_H
+
+#include "ns3/ptr.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Zipf-Mandelbrot distribution of content ranks, p(k) ~ 1/(k+q)^s, k in [1, N]
+ *
+ * Ranks are sampled by inversion of the cumulative distribution, which starts from a guide
+ * table of N equally sized probability buckets, so sampling takes O(1) expected time and
+ * returns exactly the same rank as a linear scan of the cumulative distribution.
+ *
+ * Distribution is immutable, and all users that request distribution with the same
+ * parameters share a single instance.  Consumers can request and release distributions
+ * from events that are executed in parallel (see MultithreadedSimulatorImpl), so the
+ * reference count is atomic and the set of shared instances is protected by a mutex.
+ */
+class ZipfMandelbrot
+{
+public:
+  /**
+   * @brief Get (create if necessary) distribution with the specified parameters
+   * @param numberOfContents total number of contents, N
+   * @param q                q in (k+q)^s
+   * @param s                s in (k+q)^s
+   */
+  static Ptr<const ZipfMandelbrot>
+  Get (uint32_t numberOfContents, double q, double s);
+
+  /**
+   * @brief Increment reference count (used by Ptr)
+   */
+  void
+  Ref () const;
+
+  /**
+   * @brief Decrement reference count and destroy the distribution when it is not used anymore (used by Ptr)
+   */
+  void
+  Unref () const;
+
+  /**
+   * @brief Map uniformly distributed value into content rank
+   * @param p value in range (0, 1]
+   * @returns rank in range [1, N]
+   */
+  uint32_t
+  GetRank (double p) const;
+
+private:
+  ZipfMandelbrot (uint32_t numberOfContents, double q, double s);
+  ~ZipfMandelbrot ();
+
+private:
+  mutable uint32_t m_count;
+  uint32_t m_N;
+  double m_q;
+  double m_s;
+
+  std::vector<double> m_Pcum;    ///< @brief cumulative probability, m_Pcum[k] = p(1) + ... + p(k)
+  std::vector<uint32_t> m_guide; ///< @brief m_guide[j] is the smallest rank k with m_Pcum[k] >= j/N
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_ZIPF_MANDELBROT_H
@@ -0,0 +1,209 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SEQ_WINDOW_H_
+#define SEQ_WINDOW_H_
+
+#include "ns3/assert.h"
+
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+
+/**
+ * @brief Sliding window of values indexed by sequence number
+ *
+ * Values are kept in a contiguous ring buffer that spans sequence numbers from the lowest
+ * stored one to the highest stored one, so lookup, insertion and removal are O(1) as long as
+ * stored sequence numbers are close to each other (e.g., sequence numbers in flight).  The
+ * buffer grows (doubling) when the span does not fit, and is never shrunk.
+ */
+template<class T>
+class seq_window
+{
+public:
+  seq_window ()
+    : base_ (0)
+    , top_ (0)
+    , head_ (0)
+    , size_ (0)
+  {
+  }
+
+  /**
+   * @brief Find value stored for the sequence number
+   * @returns 0 if nothing is stored for the sequence number
+   */
+  T *
+  find (uint32_t seq)
+  {
+    if (size_ == 0 || seq < base_ || seq > top_)
+      return 0;
+
+    slot &s = slots_[index (seq)];
+    return s.used ? &s.value : 0;
+  }
+
+  const T *
+  find (uint32_t seq) const
+  {
+    return const_cast<seq_window *> (this)->find (seq);
+  }
+
+  /**
+   * @brief Get value stored for the sequence number, default-constructed value is stored if necessary
+   */
+  T &
+  operator[] (uint32_t seq)
+  {
+    if (size_ == 0)
+      {
+        if (slots_.empty ())
+          slots_.resize (16);
+        base_ = top_ = seq;
+        head_ = 0;
+      }
+    else if (seq < base_)
+      {
+        grow (top_ - seq + 1);
+        head_ = (head_ - (base_ - seq)) & mask ();
+        base_ = seq;
+      }
+    else if (seq > top_)
+      {
+        grow (seq - base_ + 1);
+        top_ = seq;
+      }
+
+    slot &s = slots_[index (seq)];
+    if (!s.used)
+      {
+        s.used = true;
+        size_ ++;
+      }
+    return s.value;
+  }
+
+  /**
+   * @brief Remove value stored for the sequence number (no-op if nothing is stored)
+   */
+  void
+  erase (uint32_t seq)
+  {
+    if (size_ == 0 || seq < base_ || seq > top_)
+      return;
+
+    slot &s = slots_[index (seq)];
+    if (!s.used)
+      return;
+
+    s.used = false;
+    s.value = T ();
+    size_ --;
+
+    if (size_ == 0)
+      return;
+
+    // slide the window, so base always refers to the lowest stored sequence number
+    while (!slots_[head_].used)
+      {
+        head_ = (head_ + 1) & mask ();
+        base_ ++;
+      }
+  }
+
+  /**
+   * @brief Remove all values
+   */
+  void
+  clear ()
+  {
+    slots_.clear ();
+    size_ = 0;
+  }
+
+  /**
+   * @brief Number of stored values
+   */
+  std::size_t
+  size () const
+  {
+    return size_;
+  }
+
+  bool
+  empty () const
+  {
+    return size_ == 0;
+  }
+
+private:
+  struct slot
+  {
+    slot () : value (), used (false) { }
+
+    T value;
+    bool used;
+  };
+
+  std::size_t
+  mask () const
+  {
+    return slots_.size () - 1;
+  }
+
+  std::size_t
+  index (uint32_t seq) const
+  {
+    return (head_ + (seq - base_)) & mask ();
+  }
+
+  void
+  grow (std::size_t span)
+  {
+    if (span <= slots_.size ())
+      return;
+
+    std::size_t capacity = slots_.size ();
+    while (capacity < span)
+      capacity *= 2;
+
+    // unroll the ring, so base is at the beginning of the new buffer
+    std::vector<slot> slots (capacity);
+    for (std::size_t i = 0; i <= static_cast<std::size_t> (top_ - base_); i++)
+      slots[i] = slots_[(head_ + i) & mask ()];
+
+    slots_.swap (slots);
+    head_ = 0;
+  }
+
+private:
+  std::vector<slot> slots_; ///< @brief ring buffer, size is always a power of two
+  uint32_t base_;           ///< @brief lowest stored sequence number
+  uint32_t top_;            ///< @brief upper bound of stored sequence numbers
+  std::size_t head_;        ///< @brief index of the slot that stores base_
+  std::size_t size_;        ///< @brief number of stored values
+};
+
+} // namespace ndnSIM
+} // namespace ndn
+} // namespace ns3
+
+#endif // SEQ_WINDOW_H_
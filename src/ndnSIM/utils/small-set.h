@@ -0,0 +1,115 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SMALL_SET_H_
+#define SMALL_SET_H_
+
+#include "small-vector.h"
+
+#include <functional>
+#include <utility>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+
+/**
+ * @brief Ordered set of unique elements stored in a small_vector
+ *
+ * Lookups are linear, which for a handful of elements is faster than walking a tree.
+ * Iteration order is the same as of std::set with the same comparison.  Elements are
+ * immutable through iterators (as in std::set), iterators are invalidated by insert and erase.
+ */
+template<class T, std::size_t N, class Compare = std::less<T> >
+class small_set
+{
+public:
+  typedef small_vector<T, N> storage_type;
+  typedef T                  value_type;
+  typedef const T*           iterator;
+  typedef const T*           const_iterator;
+  typedef std::size_t        size_type;
+
+  const_iterator begin () const { return elements_.begin (); }
+  const_iterator end () const { return elements_.end (); }
+
+  size_type size () const { return elements_.size (); }
+  bool empty () const { return elements_.empty (); }
+
+  const_iterator
+  find (const T &value) const
+  {
+    const_iterator item = lower_bound (value);
+    if (item != end () && !compare_ (value, *item))
+      return item;
+    else
+      return end ();
+  }
+
+  std::pair<iterator, bool>
+  insert (const T &value)
+  {
+    const_iterator item = lower_bound (value);
+    if (item != end () && !compare_ (value, *item))
+      return std::make_pair (item, false);
+
+    typename storage_type::iterator pos = elements_.begin () + (item - begin ());
+    return std::make_pair (const_iterator (elements_.insert (pos, value)), true);
+  }
+
+  void
+  erase (iterator item)
+  {
+    elements_.erase (elements_.begin () + (item - begin ()));
+  }
+
+  size_type
+  erase (const T &value)
+  {
+    const_iterator item = find (value);
+    if (item == end ())
+      return 0;
+
+    erase (item);
+    return 1;
+  }
+
+  void
+  clear ()
+  {
+    elements_.clear ();
+  }
+
+private:
+  const_iterator
+  lower_bound (const T &value) const
+  {
+    const_iterator item = begin ();
+    while (item != end () && compare_ (*item, value))
+      item ++;
+    return item;
+  }
+
+private:
+  storage_type elements_;
+  Compare compare_;
+};
+
+} // ndnSIM
+} // ndn
+} // ns3
+
+#endif // SMALL_SET_H_
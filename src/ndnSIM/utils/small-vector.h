@@ -0,0 +1,225 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SMALL_VECTOR_H_
+#define SMALL_VECTOR_H_
+
+#include "ns3/assert.h"
+
+#include <cstddef>
+#include <new>
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+
+/**
+ * @brief Vector that keeps up to N elements inline and switches to heap storage only when
+ * it grows beyond that
+ *
+ * Interface is a subset of std::vector.  Iterators are plain pointers and are invalidated
+ * by any operation that changes the size of the container.
+ */
+template<class T, std::size_t N>
+class small_vector
+{
+public:
+  typedef T           value_type;
+  typedef T*          iterator;
+  typedef const T*    const_iterator;
+  typedef T&          reference;
+  typedef const T&    const_reference;
+  typedef std::size_t size_type;
+
+  small_vector ()
+    : data_ (inline_data ())
+    , size_ (0)
+    , capacity_ (N)
+  {
+  }
+
+  small_vector (const small_vector &other)
+    : data_ (inline_data ())
+    , size_ (0)
+    , capacity_ (N)
+  {
+    assign (other.begin (), other.end ());
+  }
+
+  ~small_vector ()
+  {
+    clear ();
+    if (data_ != inline_data ())
+      ::operator delete (data_);
+  }
+
+  small_vector &
+  operator= (const small_vector &other)
+  {
+    if (this != &other)
+      assign (other.begin (), other.end ());
+    return *this;
+  }
+
+  template<class InputIterator>
+  void
+  assign (InputIterator first, InputIterator last)
+  {
+    clear ();
+    for (; first != last; first++)
+      push_back (*first);
+  }
+
+  iterator begin () { return data_; }
+  const_iterator begin () const { return data_; }
+  iterator end () { return data_ + size_; }
+  const_iterator end () const { return data_ + size_; }
+
+  size_type size () const { return size_; }
+  size_type capacity () const { return capacity_; }
+  bool empty () const { return size_ == 0; }
+
+  reference operator[] (size_type i) { NS_ASSERT (i < size_); return data_[i]; }
+  const_reference operator[] (size_type i) const { NS_ASSERT (i < size_); return data_[i]; }
+
+  reference front () { NS_ASSERT (size_ > 0); return data_[0]; }
+  const_reference front () const { NS_ASSERT (size_ > 0); return data_[0]; }
+  reference back () { NS_ASSERT (size_ > 0); return data_[size_ - 1]; }
+  const_reference back () const { NS_ASSERT (size_ > 0); return data_[size_ - 1]; }
+
+  void
+  reserve (size_type capacity)
+  {
+    if (capacity <= capacity_)
+      return;
+
+    T *data = static_cast<T*> (::operator new (capacity * sizeof (T)));
+    for (size_type i = 0; i < size_; i++)
+      {
+        new (data + i) T (data_[i]);
+        data_[i].~T ();
+      }
+
+    if (data_ != inline_data ())
+      ::operator delete (data_);
+
+    data_ = data;
+    capacity_ = capacity;
+  }
+
+  void
+  push_back (const T &value)
+  {
+    if (size_ == capacity_)
+      {
+        T copy (value); // value may refer to an element of this container
+        reserve (2 * capacity_);
+        new (data_ + size_) T (copy);
+      }
+    else
+      new (data_ + size_) T (value);
+    size_ ++;
+  }
+
+  void
+  pop_back ()
+  {
+    NS_ASSERT (size_ > 0);
+    size_ --;
+    data_[size_].~T ();
+  }
+
+  /**
+   * @brief Resize container, new elements are copies of value
+   */
+  void
+  resize (size_type size, const T &value = T ())
+  {
+    while (size_ > size)
+      pop_back ();
+    reserve (size);
+    while (size_ < size)
+      push_back (value);
+  }
+
+  /**
+   * @brief Insert element before pos, preserving order of the other elements
+   */
+  iterator
+  insert (iterator pos, const T &value)
+  {
+    NS_ASSERT (pos >= begin () && pos <= end ());
+    size_type offset = pos - begin ();
+    if (offset == size_)
+      {
+        push_back (value);
+        return begin () + offset;
+      }
+
+    T copy (value); // value may refer to an element of this container
+    push_back (back ());
+    std::copy_backward (begin () + offset, end () - 2, end () - 1);
+    data_[offset] = copy;
+    return begin () + offset;
+  }
+
+  /**
+   * @brief Erase element, preserving order of the remaining elements
+   */
+  iterator
+  erase (iterator item)
+  {
+    NS_ASSERT (item >= begin () && item < end ());
+    std::copy (item + 1, end (), item);
+    pop_back ();
+    return item;
+  }
+
+  void
+  clear ()
+  {
+    while (size_ > 0)
+      pop_back ();
+  }
+
+private:
+  T *
+  inline_data ()
+  {
+    return reinterpret_cast<T*> (inline_.buffer);
+  }
+
+private:
+  T *data_;
+  size_type size_;
+  size_type capacity_;
+
+  union
+  {
+    char buffer [N * sizeof (T)];
+    // members below only force proper alignment of the inline buffer
+    long double align_ld;
+    void *align_ptr;
+    long long align_ll;
+  } inline_;
+};
+
+} // ndnSIM
+} // ndn
+} // ns3
+
+#endif // SMALL_VECTOR_H_
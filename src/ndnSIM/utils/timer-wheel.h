@@ -0,0 +1,365 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include "ns3/assert.h"
+
+#include <boost/intrusive/list.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+
+/**
+ * @brief Hook that has to be a member of every item stored in timer_wheel
+ *
+ * Item has to be erased from the wheel before it is destroyed (asserted in debug builds)
+ */
+typedef boost::intrusive::list_member_hook< boost::intrusive::link_mode<boost::intrusive::safe_link> >
+timer_wheel_hook;
+
+/**
+ * @brief Hierarchical timing wheel of intrusively linked items
+ *
+ * Time is measured in abstract ticks.  Items are placed into one of 256 slots of the
+ * first level if they expire within the next 256 ticks, or into one of 64 slots of the
+ * three coarser levels otherwise.  Slots of the coarser levels are cascaded down when the
+ * wheel crosses their boundary (same scheme as the classical Linux kernel timer wheel),
+ * so insertion and removal are O(1) regardless of the number of items.
+ *
+ * @tparam Item       type of items
+ * @tparam HookOption boost::intrusive hook option (member_hook, function_hook, ...) of a list hook
+ * @tparam TickOf     functor returning tick at which the item expires
+ */
+template<class Item, class HookOption, class TickOf>
+class basic_timer_wheel
+{
+public:
+  typedef boost::intrusive::list< Item,
+                                  HookOption,
+                                  boost::intrusive::constant_time_size<false>
+                                  > slot_type;
+
+  static const uint64_t NONE;
+
+  basic_timer_wheel (const TickOf &tickOf = TickOf ())
+    : tickOf_ (tickOf)
+    , base_ (0)
+    , size_ (0)
+  {
+  }
+
+  ~basic_timer_wheel ()
+  {
+    clear ();
+  }
+
+  /**
+   * @brief Change functor that maps items to ticks (only allowed when the wheel is empty)
+   */
+  void
+  set_tick_of (const TickOf &tickOf)
+  {
+    NS_ASSERT (size_ == 0);
+    tickOf_ = tickOf;
+  }
+
+  const TickOf &
+  tick_of () const
+  {
+    return tickOf_;
+  }
+
+  /**
+   * @brief Place item into the wheel (item is relinked if it is already in the wheel)
+   * @param now current tick, used to fast-forward wheel that has been idle
+   * @returns tick at which item is going to be expired by advance ()
+   */
+  uint64_t
+  insert (Item &item, uint64_t now)
+  {
+    erase (item);
+
+    if (size_ == 0 && base_ < now)
+      base_ = now;
+
+    size_ ++;
+    return place (item);
+  }
+
+  /**
+   * @brief Remove item from the wheel (no-op if item is not in the wheel)
+   */
+  void
+  erase (Item &item)
+  {
+    typename slot_type::node_ptr node = slot_type::value_traits::to_node_ptr (item);
+    if (!slot_type::node_algorithms::unique (node))
+      {
+        slot_type::node_algorithms::unlink (node);
+        slot_type::node_algorithms::init (node);
+        size_ --;
+      }
+  }
+
+  std::size_t
+  size () const
+  {
+    return size_;
+  }
+
+  bool
+  empty () const
+  {
+    return size_ == 0;
+  }
+
+  /**
+   * @brief Unlink all items
+   */
+  void
+  clear ()
+  {
+    for (int level = 0; level < LEVELS; level++)
+      for (uint32_t slot = 0; slot < slots (level); slot++)
+        slot_at (level, slot).clear ();
+    size_ = 0;
+  }
+
+  /**
+   * @brief Process all ticks up to (and including) target, calling expire (item) for
+   * each expired item
+   *
+   * Items are unlinked from the wheel before the callback is called.  The callback may
+   * freely insert or remove other items (or reinsert the same one).
+   */
+  template<class Callback>
+  void
+  advance (uint64_t target, Callback expire)
+  {
+    while (size_ > 0)
+      {
+        // skip ticks at which there is nothing to expire or cascade
+        uint64_t tick = next_tick ();
+        if (tick > target)
+          break;
+        base_ = tick;
+
+        uint32_t index = tick & LEVEL0_MASK;
+        if (index == 0)
+          {
+            // cascade coarser levels, finer first until a level is not at its boundary
+            for (int level = 1; level < LEVELS; level++)
+              {
+                uint32_t slot = level_index (tick, level);
+                cascade (level, slot);
+                if (slot != 0)
+                  break;
+              }
+          }
+
+        slot_type batch;
+        batch.swap (level0_[index]);
+        while (!batch.empty ())
+          {
+            Item &item = batch.front ();
+            batch.pop_front ();
+            size_ --;
+
+            if (tickOf_ (item) > tick) // could have been clamped at the coarsest level
+              {
+                size_ ++;
+                base_ = tick + 1;
+                place (item);
+                base_ = tick;
+                continue;
+              }
+
+            base_ = tick + 1; // items (re)inserted by the callback go to future slots
+            expire (item);
+            base_ = tick;
+          }
+        base_ = tick + 1;
+      }
+
+    if (size_ == 0 && base_ <= target)
+      base_ = target + 1;
+  }
+
+  /**
+   * @brief Earliest tick at which advance () has something to do, or NONE if the wheel is empty
+   *
+   * Returned tick can be either expiration tick of the earliest item or the tick at which
+   * coarser levels need to be cascaded.
+   */
+  uint64_t
+  next_tick () const
+  {
+    if (size_ == 0)
+      return NONE;
+
+    uint64_t next = NONE;
+    for (uint64_t tick = base_; tick < base_ + LEVEL0_SIZE; tick++)
+      if (!level0_[tick & LEVEL0_MASK].empty ())
+        {
+          next = tick;
+          break;
+        }
+
+    for (int level = 1; level < LEVELS; level++)
+      {
+        // first tick not earlier than base_ that is aligned to the slot size of the level
+        int shift = level_shift (level);
+        uint64_t block = (base_ + (static_cast<uint64_t> (1) << shift) - 1) >> shift;
+        for (uint32_t offset = 0; offset < LEVELN_SIZE; offset++)
+          {
+            if (!levels_[level - 1][(block + offset) & LEVELN_MASK].empty ())
+              {
+                next = std::min (next, (block + offset) << shift);
+                break;
+              }
+          }
+      }
+
+    NS_ASSERT_MSG (next != NONE, "Inconsistent state of the timer wheel");
+    return next;
+  }
+
+private:
+  basic_timer_wheel (const basic_timer_wheel &);
+  basic_timer_wheel &operator= (const basic_timer_wheel &);
+
+  static const int LEVELS = 4;
+  static const int LEVEL0_BITS = 8;
+  static const int LEVELN_BITS = 6;
+  static const uint32_t LEVEL0_SIZE = 1 << LEVEL0_BITS;
+  static const uint32_t LEVELN_SIZE = 1 << LEVELN_BITS;
+  static const uint32_t LEVEL0_MASK = LEVEL0_SIZE - 1;
+  static const uint32_t LEVELN_MASK = LEVELN_SIZE - 1;
+
+  static uint32_t
+  slots (int level)
+  {
+    return level == 0 ? LEVEL0_SIZE : LEVELN_SIZE;
+  }
+
+  static int
+  level_shift (int level)
+  {
+    return LEVEL0_BITS + (level - 1) * LEVELN_BITS;
+  }
+
+  static uint32_t
+  level_index (uint64_t tick, int level)
+  {
+    return (tick >> level_shift (level)) & LEVELN_MASK;
+  }
+
+  slot_type &
+  slot_at (int level, uint32_t slot)
+  {
+    return level == 0 ? level0_[slot] : levels_[level - 1][slot];
+  }
+
+  const slot_type &
+  slot_at (int level, uint32_t slot) const
+  {
+    return level == 0 ? level0_[slot] : levels_[level - 1][slot];
+  }
+
+  uint64_t
+  place (Item &item)
+  {
+    uint64_t tick = tickOf_ (item);
+    if (tick < base_)
+      tick = base_; // already expired, process at the next tick
+
+    uint64_t delta = tick - base_;
+    if (delta < LEVEL0_SIZE)
+      {
+        level0_[tick & LEVEL0_MASK].push_back (item);
+        return tick;
+      }
+
+    for (int level = 1; level < LEVELS; level++)
+      {
+        if (delta < (static_cast<uint64_t> (1) << (level_shift (level) + LEVELN_BITS)))
+          {
+            levels_[level - 1][level_index (tick, level)].push_back (item);
+            return tick;
+          }
+      }
+
+    // beyond the range of the wheel, park in the farthest slot and re-place when cascaded
+    uint64_t parked = base_ + (static_cast<uint64_t> (1) << level_shift (LEVELS)) - 1;
+    levels_[LEVELS - 2][level_index (parked, LEVELS - 1)].push_back (item);
+    return tick;
+  }
+
+  void
+  cascade (int level, uint32_t slot)
+  {
+    slot_type batch;
+    batch.swap (levels_[level - 1][slot]);
+    while (!batch.empty ())
+      {
+        Item &item = batch.front ();
+        batch.pop_front ();
+        place (item);
+      }
+  }
+
+private:
+  TickOf tickOf_;
+  uint64_t base_; ///< @brief next tick to be processed
+  std::size_t size_;
+
+  slot_type level0_[LEVEL0_SIZE];
+  slot_type levels_[LEVELS - 1][LEVELN_SIZE];
+};
+
+template<class Item, class HookOption, class TickOf>
+const uint64_t basic_timer_wheel<Item, HookOption, TickOf>::NONE = std::numeric_limits<uint64_t>::max ();
+
+/**
+ * @brief Timing wheel of items linked through a timer_wheel_hook member
+ *
+ * @tparam Item     type of items
+ * @tparam Hook     pointer to timer_wheel_hook member of Item
+ * @tparam TickOf   functor returning tick at which the item expires
+ */
+template<class Item, timer_wheel_hook Item::*Hook, class TickOf>
+class timer_wheel
+  : public basic_timer_wheel< Item, boost::intrusive::member_hook< Item, timer_wheel_hook, Hook >, TickOf >
+{
+public:
+  timer_wheel (const TickOf &tickOf = TickOf ())
+    : basic_timer_wheel< Item, boost::intrusive::member_hook< Item, timer_wheel_hook, Hook >, TickOf > (tickOf)
+  {
+  }
+};
+
+} // ndnSIM
+} // ndn
+} // ns3
+
+#endif // TIMER_WHEEL_H_
@@ -0,0 +1,259 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace-writer.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <boost/functional/hash.hpp>
+
+#include <cstring>
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceWriter");
+
+namespace ns3 {
+
+namespace {
+
+const char MAGIC[8] = { 'N', 'D', 'N', 'T', 'R', 'A', 'C', 'E' };
+const uint32_t VERSION = 1;
+
+struct CStringHash
+{
+  std::size_t
+  operator() (const char *value) const
+  {
+    return boost::hash_range (value, value + std::strlen (value));
+  }
+};
+
+struct CStringEqual
+{
+  bool
+  operator() (const char *a, const std::string &b) const
+  {
+    return b == a;
+  }
+};
+
+/**
+ * @brief Append value in little-endian byte order
+ */
+template<class T>
+void
+AppendLittleEndian (std::vector<char> &buffer, T value)
+{
+  for (uint32_t i = 0; i < sizeof (T); i++)
+    {
+      buffer.push_back (static_cast<char> (value & 0xFF));
+      value >>= 8;
+    }
+}
+
+} // namespace
+
+BinaryTraceWriter::BinaryTraceWriter (boost::shared_ptr<std::ostream> os, uint32_t blockRows/* = 4096*/)
+  : m_os (os)
+  , m_blockRows (blockRows)
+  , m_nextColumn (0)
+  , m_rows (0)
+  , m_headerWritten (false)
+{
+  NS_ASSERT_MSG (m_blockRows > 0, "Block should contain at least one row");
+}
+
+BinaryTraceWriter::~BinaryTraceWriter ()
+{
+  Flush ();
+}
+
+void
+BinaryTraceWriter::AddColumn (const std::string &name, ColumnType type)
+{
+  NS_ASSERT_MSG (!m_headerWritten && m_rows == 0 && m_nextColumn == 0,
+                 "Columns can be added only before the first row");
+
+  Column column;
+  column.m_name = name;
+  column.m_type = type;
+  column.m_last = 0;
+  m_columns.push_back (column);
+}
+
+uint32_t
+BinaryTraceWriter::GetStringId (const std::string &value)
+{
+  Dictionary::iterator item = m_dictionary.find (value);
+  if (item != m_dictionary.end ())
+    return item->second;
+
+  uint32_t id = m_dictionary.size ();
+  m_dictionary.insert (std::make_pair (value, id));
+  m_newStrings.push_back (value);
+  return id;
+}
+
+uint32_t
+BinaryTraceWriter::GetStringId (const char *value)
+{
+  Dictionary::iterator item = m_dictionary.find (value, CStringHash (), CStringEqual ());
+  if (item != m_dictionary.end ())
+    return item->second;
+
+  return GetStringId (std::string (value));
+}
+
+BinaryTraceWriter::Column &
+BinaryTraceWriter::NextColumn (ColumnType type)
+{
+  NS_ASSERT_MSG (m_nextColumn < m_columns.size (), "Too many values in the row");
+
+  Column &column = m_columns[m_nextColumn ++];
+  NS_ASSERT_MSG (column.m_type == type, "Wrong type of value for column " << column.m_name);
+  return column;
+}
+
+template<class T>
+void
+BinaryTraceWriter::PutValue (Column &column, T value)
+{
+  if (m_rows % 8 == 0)
+    column.m_changed.push_back (0);
+
+  if (m_rows > 0 && column.m_last == value)
+    return;
+
+  column.m_changed.back () |= static_cast<char> (1 << (m_rows % 8));
+  column.m_last = value;
+  AppendLittleEndian<T> (column.m_values, value);
+}
+
+BinaryTraceWriter &
+BinaryTraceWriter::PutFloat (double value)
+{
+  // IEEE 754 double is assumed to have the same byte order as integers
+  uint64_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  PutValue<uint64_t> (NextColumn (FLOAT64), bits);
+  return *this;
+}
+
+BinaryTraceWriter &
+BinaryTraceWriter::PutInt (int64_t value)
+{
+  PutValue<uint64_t> (NextColumn (INT64), static_cast<uint64_t> (value));
+  return *this;
+}
+
+BinaryTraceWriter &
+BinaryTraceWriter::PutString (uint32_t id)
+{
+  NS_ASSERT_MSG (id < m_dictionary.size (), "Unknown string ID");
+  PutValue<uint32_t> (NextColumn (STRING), id);
+  return *this;
+}
+
+BinaryTraceWriter &
+BinaryTraceWriter::PutString (const std::string &value)
+{
+  return PutString (GetStringId (value));
+}
+
+void
+BinaryTraceWriter::EndRow ()
+{
+  NS_ASSERT_MSG (m_nextColumn == m_columns.size (), "Not all values of the row are specified");
+
+  m_nextColumn = 0;
+  m_rows ++;
+
+  if (m_rows >= m_blockRows)
+    Flush ();
+}
+
+void
+BinaryTraceWriter::Flush ()
+{
+  if (!m_headerWritten)
+    WriteHeader ();
+
+  if (m_rows == 0)
+    return;
+
+  NS_LOG_DEBUG ("Writing block of " << m_rows << " rows");
+
+  std::vector<char> buffer;
+  AppendLittleEndian<uint32_t> (buffer, m_rows);
+  AppendLittleEndian<uint32_t> (buffer, m_newStrings.size ());
+  m_os->write (&buffer[0], buffer.size ());
+
+  for (std::vector<std::string>::const_iterator value = m_newStrings.begin ();
+       value != m_newStrings.end ();
+       value++)
+    {
+      WriteString (*value);
+    }
+  m_newStrings.clear ();
+
+  for (std::vector<Column>::iterator column = m_columns.begin ();
+       column != m_columns.end ();
+       column++)
+    {
+      m_os->write (&column->m_changed[0], column->m_changed.size ());
+      if (!column->m_values.empty ()) // values are stored only for changed rows
+        m_os->write (&column->m_values[0], column->m_values.size ());
+      column->m_changed.clear ();
+      column->m_values.clear ();
+    }
+
+  m_rows = 0;
+}
+
+void
+BinaryTraceWriter::WriteHeader ()
+{
+  m_os->write (MAGIC, sizeof (MAGIC));
+  WriteU32 (VERSION);
+  WriteU32 (m_columns.size ());
+  for (std::vector<Column>::const_iterator column = m_columns.begin ();
+       column != m_columns.end ();
+       column++)
+    {
+      char type = static_cast<char> (column->m_type);
+      m_os->write (&type, 1);
+      WriteString (column->m_name);
+    }
+
+  m_headerWritten = true;
+}
+
+void
+BinaryTraceWriter::WriteU32 (uint32_t value)
+{
+  std::vector<char> buffer;
+  AppendLittleEndian<uint32_t> (buffer, value);
+  m_os->write (&buffer[0], buffer.size ());
+}
+
+void
+BinaryTraceWriter::WriteString (const std::string &value)
+{
+  WriteU32 (value.size ());
+  m_os->write (value.data (), value.size ());
+}
+
+} // namespace ns3
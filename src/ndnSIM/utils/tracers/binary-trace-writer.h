@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_WRITER_H
+#define BINARY_TRACE_WRITER_H
+
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/cstdint.hpp>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @brief Output format of tracers
+ */
+enum TraceFormat
+  {
+    TRACE_FORMAT_TEXT,   ///< @brief tab-separated text with a header line
+    TRACE_FORMAT_BINARY  ///< @brief binary columnar records, see BinaryTraceWriter
+  };
+
+/**
+ * @ingroup ndn
+ * @brief Writer of binary columnar trace files
+ *
+ * Rows are buffered column-wise and written in blocks, so a trace file consists of a header with
+ * the schema followed by a sequence of blocks (all integers are little-endian):
+ *
+ * - header: magic "NDNTRACE", uint32 version (1), uint32 number of columns, and for every column
+ *   uint8 type (0 = float64, 1 = int64, 2 = string) and length-prefixed (uint32) column name
+ * - block: uint32 number of rows, uint32 number of new strings followed by length-prefixed (uint32)
+ *   strings, then values of every column: bitmap of rows where the value differs from the value in the
+ *   previous row (ceil (rows / 8) bytes, least significant bit first, the first row of the block is
+ *   always marked) followed by the marked values only (8-byte values for float64 and int64 columns,
+ *   uint32 string IDs for string columns)
+ *
+ * Repeated values (e.g., time, node, face, and zero counters) are therefore stored only once, making
+ * binary traces several times smaller than the equivalent text traces.
+ *
+ * String values are stored in a dictionary: every new string gets the next ID (starting from 0) and
+ * is written in the block where it appears for the first time.
+ *
+ * tools/ndn-binary-trace.py can load such files (e.g., into a pandas DataFrame) or convert them to text.
+ */
+class BinaryTraceWriter
+{
+public:
+  enum ColumnType
+    {
+      FLOAT64 = 0,
+      INT64 = 1,
+      STRING = 2
+    };
+
+  /**
+   * @brief Create writer on top of output stream (stream should be opened in binary mode)
+   * @param os        output stream
+   * @param blockRows number of rows buffered before the block is written out
+   */
+  BinaryTraceWriter (boost::shared_ptr<std::ostream> os, uint32_t blockRows = 4096);
+
+  /**
+   * @brief Destructor, writes out all buffered rows
+   */
+  ~BinaryTraceWriter ();
+
+  /**
+   * @brief Add column to the schema (only allowed before the first row)
+   */
+  void
+  AddColumn (const std::string &name, ColumnType type);
+
+  /**
+   * @brief Get ID of the string in the dictionary (string is added to the dictionary if necessary)
+   *
+   * IDs can be cached by callers and used with PutString (uint32_t)
+   */
+  uint32_t
+  GetStringId (const std::string &value);
+
+  uint32_t
+  GetStringId (const char *value);
+
+  BinaryTraceWriter &
+  PutFloat (double value);
+
+  BinaryTraceWriter &
+  PutInt (int64_t value);
+
+  BinaryTraceWriter &
+  PutString (uint32_t id);
+
+  BinaryTraceWriter &
+  PutString (const std::string &value);
+
+  /**
+   * @brief Finish the row (values for all columns should have been put)
+   */
+  void
+  EndRow ();
+
+  /**
+   * @brief Write out all buffered rows as a block
+   */
+  void
+  Flush ();
+
+  /**
+   * @brief Get underlying output stream
+   */
+  boost::shared_ptr<std::ostream>
+  GetStream () const
+  {
+    return m_os;
+  }
+
+private:
+  struct Column;
+
+  /**
+   * @brief Get the column of the next value in the current row
+   */
+  Column &
+  NextColumn (ColumnType type);
+
+  /**
+   * @brief Buffer value (bytes of little-endian integer or IEEE 754 double) unless it repeats the value in the previous row
+   */
+  template<class T>
+  void
+  PutValue (Column &column, T value);
+
+  void
+  WriteHeader ();
+
+  void
+  WriteU32 (uint32_t value);
+
+  void
+  WriteString (const std::string &value);
+
+private:
+  struct Column
+  {
+    std::string m_name;
+    ColumnType m_type;
+    std::vector<char> m_values;    ///< @brief buffered values that differ from the value in the previous row
+    std::vector<char> m_changed;   ///< @brief bitmap of rows with buffered values
+    uint64_t m_last;               ///< @brief value in the previous row
+  };
+
+  typedef boost::unordered_map<std::string, uint32_t> Dictionary;
+
+  boost::shared_ptr<std::ostream> m_os;
+  uint32_t m_blockRows;
+
+  std::vector<Column> m_columns;
+  uint32_t m_nextColumn;  ///< @brief column of the next value in the current row
+  uint32_t m_rows;        ///< @brief number of buffered rows
+  bool m_headerWritten;
+
+  Dictionary m_dictionary;
+  std::vector<std::string> m_newStrings; ///< @brief strings added to the dictionary since the last block
+};
+
+} // namespace ns3
+
+#endif // BINARY_TRACE_WRITER_H
@@ -39,27 +39,42 @@ NS_LOG_COMPONENT_DEFINE ("L2RateTracer");
 namespace ns3 {
 
 boost::tuple< boost::shared_ptr<std::ostream>, std::list<Ptr<L2RateTracer> > >
-L2RateTracer::InstallAll (const std::string &file, Time averagingPeriod/* = Seconds (0.5)*/)
+L2RateTracer::InstallAll (const std::string &file, Time averagingPeriod/* = Seconds (0.5)*/,
+                          TraceFormat format/* = TRACE_FORMAT_TEXT*/)
 {
   std::list<Ptr<L2RateTracer> > tracers;
   boost::shared_ptr<std::ofstream> outputStream (new std::ofstream ());
-  outputStream->open (file.c_str (), std::ios_base::out | std::ios_base::trunc);
+  std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+  if (format == TRACE_FORMAT_BINARY)
+    mode |= std::ios_base::binary;
+  outputStream->open (file.c_str (), mode);
 
   if (!outputStream->is_open ())
     return boost::make_tuple (outputStream, tracers);
 
+  boost::shared_ptr<BinaryTraceWriter> writer;
+  if (format == TRACE_FORMAT_BINARY)
+    {
+      writer.reset (new BinaryTraceWriter (outputStream));
+      AddColumns (*writer);
+    }
+
   for (NodeList::Iterator node = NodeList::Begin ();
        node != NodeList::End ();
        node++)
     {
       NS_LOG_DEBUG ("Node: " << lexical_cast<string> ((*node)->GetId ()));
 
-      Ptr<L2RateTracer> trace = Create<L2RateTracer> (outputStream, *node);
+      Ptr<L2RateTracer> trace;
+      if (writer)
+        trace = Create<L2RateTracer> (writer, *node);
+      else
+        trace = Create<L2RateTracer> (outputStream, *node);
       trace->SetAveragingPeriod (averagingPeriod);
       tracers.push_back (trace);
     }
 
-  if (tracers.size () > 0)
+  if (!writer && tracers.size () > 0)
     {
       // *m_l3RateTrace << "# "; // not necessary for R's read.table
       tracers.front ()->PrintHeader (*outputStream);
@@ -73,6 +88,16 @@ L2RateTracer::InstallAll (const std::string &file, Time averagingPeriod/* = Seco
 L2RateTracer::L2RateTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node)
   : L2Tracer (node)
   , m_os (os)
+  , m_nodeStringId (0)
+{
+  SetAveragingPeriod (Seconds (1.0));
+}
+
+L2RateTracer::L2RateTracer (boost::shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node)
+  : L2Tracer (node)
+  , m_os (writer->GetStream ())
+  , m_writer (writer)
+  , m_nodeStringId (writer->GetStringId (m_node))
 {
   SetAveragingPeriod (Seconds (1.0));
 }
@@ -93,7 +118,10 @@ L2RateTracer::SetAveragingPeriod (const Time &period)
 void
 L2RateTracer::PeriodicPrinter ()
 {
-  Print (*m_os);
+  if (m_writer)
+    Write (*m_writer);
+  else
+    Print (*m_os);
   Reset ();
 
   m_printEvent = Simulator::Schedule (m_period, &L2RateTracer::PeriodicPrinter, this);
@@ -114,6 +142,21 @@ L2RateTracer::PrintHeader (std::ostream &os) const
      << "KilobytesRaw";
 }
 
+void
+L2RateTracer::AddColumns (BinaryTraceWriter &writer)
+{
+  writer.AddColumn ("Time",         BinaryTraceWriter::FLOAT64);
+
+  writer.AddColumn ("Node",         BinaryTraceWriter::STRING);
+  writer.AddColumn ("Interface",    BinaryTraceWriter::STRING);
+
+  writer.AddColumn ("Type",         BinaryTraceWriter::STRING);
+  writer.AddColumn ("Packets",      BinaryTraceWriter::FLOAT64);
+  writer.AddColumn ("Kilobytes",    BinaryTraceWriter::FLOAT64);
+  writer.AddColumn ("PacketsRaw",   BinaryTraceWriter::FLOAT64);
+  writer.AddColumn ("KilobytesRaw", BinaryTraceWriter::FLOAT64);
+}
+
 void
 L2RateTracer::Reset ()
 {
@@ -126,9 +169,12 @@ const double alpha = 0.8;
 #define STATS(INDEX) m_stats.get<INDEX> ()
 #define RATE(INDEX, fieldName) STATS(INDEX).fieldName / m_period.ToDouble (Time::S)
 
-#define PRINTER(printName, fieldName, interface)                        \
+#define UPDATE(fieldName)                                               \
 STATS(2).fieldName = /*new value*/alpha * RATE(0, fieldName) + /*old value*/(1-alpha) * STATS(2).fieldName; \
-STATS(3).fieldName = /*new value*/alpha * RATE(1, fieldName) / 1024.0 + /*old value*/(1-alpha) * STATS(3).fieldName; \
+STATS(3).fieldName = /*new value*/alpha * RATE(1, fieldName) / 1024.0 + /*old value*/(1-alpha) * STATS(3).fieldName;
+
+#define PRINTER(printName, fieldName, interface)                        \
+ UPDATE(fieldName)                                                      \
                                                                         \
  os << time.ToDouble (Time::S) << "\t"                                  \
  << m_node << "\t"                                                      \
@@ -139,6 +185,19 @@ STATS(3).fieldName = /*new value*/alpha * RATE(1, fieldName) / 1024.0 + /*old va
  << STATS(0).fieldName << "\t"                                         \
  << STATS(1).fieldName / 1024.0 << "\n";
 
+#define WRITER(printName, fieldName, interface)                         \
+ UPDATE(fieldName)                                                      \
+                                                                        \
+ writer.PutFloat (time.ToDouble (Time::S))                              \
+   .PutString (m_nodeStringId)                                          \
+   .PutString (writer.GetStringId (interface))                          \
+   .PutString (writer.GetStringId (printName))                          \
+   .PutFloat (STATS(2).fieldName)                                       \
+   .PutFloat (STATS(3).fieldName)                                       \
+   .PutFloat (STATS(0).fieldName)                                       \
+   .PutFloat (STATS(1).fieldName / 1024.0)                              \
+   .EndRow ();
+
 void
 L2RateTracer::Print (std::ostream &os) const
 {
@@ -147,6 +206,14 @@ L2RateTracer::Print (std::ostream &os) const
   PRINTER ("Drop", m_drop, "combined");
 }
 
+void
+L2RateTracer::Write (BinaryTraceWriter &writer) const
+{
+  Time time = Simulator::Now ();
+
+  WRITER ("Drop", m_drop, "combined");
+}
+
 void
 L2RateTracer::Drop (Ptr<const Packet> packet)
 {
@@ -22,6 +22,7 @@
 #define L2_RATE_TRACER_H
 
 #include "l2-tracer.h"
+#include "binary-trace-writer.h"
 
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
@@ -42,6 +43,11 @@ public:
    * @brief Network layer tracer constructor
    */
   L2RateTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node);
+
+  /**
+   * @brief Network layer tracer constructor that writes binary trace
+   */
+  L2RateTracer (boost::shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node);
   virtual ~L2RateTracer ();
 
   /**
@@ -50,13 +56,21 @@ public:
    * @param file File to which traces will be written
    * @param averagingPeriod Defines averaging period for the rate calculation,
    *        as well as how often data will be written into the trace file (default, every half second)
+   * @param format Format of the trace file (text by default)
    *
    * @returns a tuple of reference to output stream and list of tracers. !!! Attention !!! This tuple needs to be preserved
    *          for the lifetime of simulation, otherwise SEGFAULTs are inevitable
    *
    */
   static boost::tuple< boost::shared_ptr<std::ostream>, std::list<Ptr<L2RateTracer> > >
-  InstallAll (const std::string &file, Time averagingPeriod = Seconds (0.5));
+  InstallAll (const std::string &file, Time averagingPeriod = Seconds (0.5),
+              TraceFormat format = TRACE_FORMAT_TEXT);
+
+  /**
+   * @brief Add columns of the trace to the binary trace writer (counterpart of PrintHeader)
+   */
+  static void
+  AddColumns (BinaryTraceWriter &writer);
 
   void
   SetAveragingPeriod (const Time &period);
@@ -67,6 +81,12 @@ public:
   virtual void
   Print (std::ostream &os) const;
 
+  /**
+   * @brief Write current trace data to the binary trace writer (counterpart of Print)
+   */
+  void
+  Write (BinaryTraceWriter &writer) const;
+
   virtual void
   Drop (Ptr<const Packet>);
 
@@ -79,6 +99,8 @@ private:
 
 private:
   boost::shared_ptr<std::ostream> m_os;
+  boost::shared_ptr<BinaryTraceWriter> m_writer;
+  uint32_t m_nodeStringId; ///< @brief ID of m_node in the dictionary of the binary trace
   Time m_period;
   EventId m_printEvent;
 
@@ -20,7 +20,9 @@
 
 #include "l2-tracer.h"
 #include "ns3/node.h"
-#include "ns3/config.h"
+#include "ns3/net-device.h"
+#include "ns3/queue.h"
+#include "ns3/pointer.h"
 #include "ns3/names.h"
 #include "ns3/callback.h"
 
@@ -47,8 +49,17 @@ L2Tracer::L2Tracer (Ptr<Node> node)
 void
 L2Tracer::Connect ()
 {
-  Config::ConnectWithoutContext ("/NodeList/"+m_node+"/DeviceList/*/TxQueue/Drop",
-                                 MakeCallback (&L2Tracer::Drop, this));
+  // devices without transmission queue are silently skipped
+  for (uint32_t i = 0; i < m_nodePtr->GetNDevices (); i++)
+    {
+      PointerValue txQueue;
+      if (!m_nodePtr->GetDevice (i)->GetAttributeFailSafe ("TxQueue", txQueue))
+        continue;
+
+      Ptr<Queue> queue = txQueue.Get<Queue> ();
+      if (queue != 0)
+        queue->TraceConnectWithoutContext ("Drop", MakeCallback (&L2Tracer::Drop, this));
+    }
 }
 
 } // namespace ns3
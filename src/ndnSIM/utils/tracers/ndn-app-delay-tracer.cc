@@ -19,9 +19,9 @@
  */
 
 #include "ndn-app-delay-tracer.h"
+#include "ndn-tracer-node.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
-#include "ns3/config.h"
 #include "ns3/names.h"
 #include "ns3/callback.h"
 
@@ -31,6 +31,10 @@
 #include "ns3/simulator.h"
 #include "ns3/node-list.h"
 #include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#endif
 
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
@@ -44,9 +48,17 @@ using namespace std;
 namespace ns3 {
 namespace ndn {
 
+#ifdef HAVE_PTHREAD_H
+/**
+ * @brief Serializes rows of all tracers, delays can be traced by events that are executed in parallel
+ * (see MultithreadedSimulatorImpl)
+ */
+static SystemMutex g_outputMutex;
+#endif
+
 
 boost::tuple< boost::shared_ptr<std::ostream>, std::list<Ptr<AppDelayTracer> > >
-AppDelayTracer::InstallAll (const std::string &file)
+AppDelayTracer::InstallAll (const std::string &file, TraceFormat format/* = TRACE_FORMAT_TEXT*/)
 {
   using namespace boost;
   using namespace std;
@@ -54,21 +66,35 @@ AppDelayTracer::InstallAll (const std::string &file)
   std::list<Ptr<AppDelayTracer> > tracers;
   boost::shared_ptr<std::ofstream> outputStream = make_shared<std::ofstream> ();
 
-  outputStream->open (file.c_str (), std::ios_base::out | std::ios_base::trunc);
+  std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+  if (format == TRACE_FORMAT_BINARY)
+    mode |= std::ios_base::binary;
+  outputStream->open (file.c_str (), mode);
   if (!outputStream->is_open ())
     return boost::make_tuple (outputStream, tracers);
 
+  boost::shared_ptr<BinaryTraceWriter> writer;
+  if (format == TRACE_FORMAT_BINARY)
+    {
+      writer = make_shared<BinaryTraceWriter> (outputStream);
+      AddColumns (*writer);
+    }
+
   for (NodeList::Iterator node = NodeList::Begin ();
        node != NodeList::End ();
        node++)
     {
       NS_LOG_DEBUG ("Node: " << (*node)->GetId ());
 
-      Ptr<AppDelayTracer> trace = Create<AppDelayTracer> (outputStream, *node);
+      Ptr<AppDelayTracer> trace;
+      if (writer)
+        trace = Create<AppDelayTracer> (writer, *node);
+      else
+        trace = Create<AppDelayTracer> (outputStream, *node);
       tracers.push_back (trace);
     }
 
-  if (tracers.size () > 0)
+  if (!writer && tracers.size () > 0)
     {
       // *m_l3RateTrace << "# "; // not necessary for R's read.table
       tracers.front ()->PrintHeader (*outputStream);
@@ -85,6 +111,7 @@ AppDelayTracer::InstallAll (const std::string &file)
 AppDelayTracer::AppDelayTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node)
 : m_nodePtr (node)
 , m_os (os)
+, m_nodeStringId (0)
 {
   m_node = boost::lexical_cast<string> (m_nodePtr->GetId ());
 
@@ -100,8 +127,29 @@ AppDelayTracer::AppDelayTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> no
 AppDelayTracer::AppDelayTracer (boost::shared_ptr<std::ostream> os, const std::string &node)
 : m_node (node)
 , m_os (os)
+, m_nodeStringId (0)
+{
+  m_nodePtr = FindTracedNode (m_node);
+
+  Connect ();
+}
+
+AppDelayTracer::AppDelayTracer (boost::shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node)
+: m_nodePtr (node)
+, m_os (writer->GetStream ())
+, m_writer (writer)
 {
+  m_node = boost::lexical_cast<string> (m_nodePtr->GetId ());
+
   Connect ();
+
+  string name = Names::FindName (node);
+  if (!name.empty ())
+    {
+      m_node = name;
+    }
+
+  m_nodeStringId = m_writer->GetStringId (m_node);
 }
 
 AppDelayTracer::~AppDelayTracer ()
@@ -112,11 +160,15 @@ AppDelayTracer::~AppDelayTracer ()
 void
 AppDelayTracer::Connect ()
 {
-  Config::ConnectWithoutContext ("/NodeList/"+m_node+"/ApplicationList/*/LastRetransmittedInterestDataDelay",
-                                 MakeCallback (&AppDelayTracer::LastRetransmittedInterestDataDelay, this));
-
-  Config::ConnectWithoutContext ("/NodeList/"+m_node+"/ApplicationList/*/FirstInterestDataDelay",
-                                 MakeCallback (&AppDelayTracer::FirstInterestDataDelay, this));
+  // applications that do not provide the trace sources are silently skipped
+  for (uint32_t i = 0; i < m_nodePtr->GetNApplications (); i++)
+    {
+      Ptr<Application> app = m_nodePtr->GetApplication (i);
+      app->TraceConnectWithoutContext ("LastRetransmittedInterestDataDelay",
+                                       MakeCallback (&AppDelayTracer::LastRetransmittedInterestDataDelay, this));
+      app->TraceConnectWithoutContext ("FirstInterestDataDelay",
+                                       MakeCallback (&AppDelayTracer::FirstInterestDataDelay, this));
+    }
 }
 
 void
@@ -134,9 +186,43 @@ AppDelayTracer::PrintHeader (std::ostream &os) const
      << "HopCount"  << "";
 }
 
+void
+AppDelayTracer::AddColumns (BinaryTraceWriter &writer)
+{
+  writer.AddColumn ("Time",      BinaryTraceWriter::FLOAT64);
+  writer.AddColumn ("Node",      BinaryTraceWriter::STRING);
+  writer.AddColumn ("AppId",     BinaryTraceWriter::INT64);
+  writer.AddColumn ("SeqNo",     BinaryTraceWriter::INT64);
+
+  writer.AddColumn ("Type",      BinaryTraceWriter::STRING);
+  writer.AddColumn ("DelayS",    BinaryTraceWriter::FLOAT64);
+  writer.AddColumn ("DelayUS",   BinaryTraceWriter::FLOAT64);
+  writer.AddColumn ("RetxCount", BinaryTraceWriter::INT64);
+  writer.AddColumn ("HopCount",  BinaryTraceWriter::INT64);
+}
+
 void
 AppDelayTracer::LastRetransmittedInterestDataDelay (Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount)
 {
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_outputMutex);
+#endif
+
+  if (m_writer)
+    {
+      m_writer->PutFloat (Simulator::Now ().ToDouble (Time::S))
+        .PutString (m_nodeStringId)
+        .PutInt (app->GetId ())
+        .PutInt (seqno)
+        .PutString (m_writer->GetStringId ("LastDelay"))
+        .PutFloat (delay.ToDouble (Time::S))
+        .PutFloat (delay.ToDouble (Time::US))
+        .PutInt (1)
+        .PutInt (hopCount)
+        .EndRow ();
+      return;
+    }
+
   *m_os << Simulator::Now ().ToDouble (Time::S) << "\t"
         << m_node << "\t"
         << app->GetId () << "\t"
@@ -151,6 +237,25 @@ AppDelayTracer::LastRetransmittedInterestDataDelay (Ptr<App> app, uint32_t seqno
 void
 AppDelayTracer::FirstInterestDataDelay (Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount)
 {
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_outputMutex);
+#endif
+
+  if (m_writer)
+    {
+      m_writer->PutFloat (Simulator::Now ().ToDouble (Time::S))
+        .PutString (m_nodeStringId)
+        .PutInt (app->GetId ())
+        .PutInt (seqno)
+        .PutString (m_writer->GetStringId ("FullDelay"))
+        .PutFloat (delay.ToDouble (Time::S))
+        .PutFloat (delay.ToDouble (Time::US))
+        .PutInt (retxCount)
+        .PutInt (hopCount)
+        .EndRow ();
+      return;
+    }
+
   *m_os << Simulator::Now ().ToDouble (Time::S) << "\t"
         << m_node << "\t"
         << app->GetId () << "\t"
@@ -23,6 +23,7 @@
 
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "binary-trace-writer.h"
 #include <ns3/nstime.h>
 #include <ns3/event-id.h>
 
@@ -50,14 +51,14 @@ public:
    * @brief Helper method to install tracers on all simulation nodes
    *
    * @param file File to which traces will be written
-   * @param averagingPeriod How often data will be written into the trace file (default, every half second)
+   * @param format Format of the trace file (text by default)
    *
    * @returns a tuple of reference to output stream and list of tracers. !!! Attention !!! This tuple needs to be preserved
    *          for the lifetime of simulation, otherwise SEGFAULTs are inevitable
    * 
    */
   static boost::tuple< boost::shared_ptr<std::ostream>, std::list<Ptr<AppDelayTracer> > >
-  InstallAll (const std::string &file);
+  InstallAll (const std::string &file, TraceFormat format = TRACE_FORMAT_TEXT);
 
   /**
    * @brief Trace constructor that attaches to all applications on the node using node's pointer
@@ -73,6 +74,13 @@ public:
    */
   AppDelayTracer (boost::shared_ptr<std::ostream> os, const std::string &node);
 
+  /**
+   * @brief Trace constructor that attaches to all applications on the node using node's pointer and writes binary trace
+   * @param writer binary trace writer (columns should be already added using AddColumns)
+   * @param node   pointer to the node
+   */
+  AppDelayTracer (boost::shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node);
+
   /**
    * @brief Destructor
    */
@@ -85,6 +93,12 @@ public:
    */
   void
   PrintHeader (std::ostream &os) const;
+
+  /**
+   * @brief Add columns of the trace to the binary trace writer (counterpart of PrintHeader)
+   */
+  static void
+  AddColumns (BinaryTraceWriter &writer);
   
 private:
   void
@@ -101,6 +115,8 @@ private:
   Ptr<Node> m_nodePtr;
 
   boost::shared_ptr<std::ostream> m_os;
+  boost::shared_ptr<BinaryTraceWriter> m_writer;
+  uint32_t m_nodeStringId; ///< @brief ID of m_node in the dictionary of the binary trace
 };
 
 } // namespace ndn
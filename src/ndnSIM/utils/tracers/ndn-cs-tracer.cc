@@ -20,15 +20,16 @@
  */
 
 #include "ndn-cs-tracer.h"
+#include "ndn-tracer-node.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
-#include "ns3/config.h"
 #include "ns3/names.h"
 #include "ns3/callback.h"
 
 #include "ns3/ndn-app.h"
 #include "ns3/ndn-interest.h"
 #include "ns3/ndn-content-object.h"
+#include "ns3/ndn-content-store.h"
 #include "ns3/simulator.h"
 #include "ns3/node-list.h"
 #include "ns3/log.h"
@@ -46,30 +47,45 @@ namespace ndn {
 
 
 boost::tuple< boost::shared_ptr<std::ostream>, std::list<Ptr<CsTracer> > >
-CsTracer::InstallAll (const std::string &file, Time averagingPeriod/* = Seconds (0.5)*/)
+CsTracer::InstallAll (const std::string &file, Time averagingPeriod/* = Seconds (0.5)*/,
+                      TraceFormat format/* = TRACE_FORMAT_TEXT*/)
 {
   using namespace boost;
   using namespace std;
   
   std::list<Ptr<CsTracer> > tracers;
   boost::shared_ptr<std::ofstream> outputStream (new std::ofstream ());
-  outputStream->open (file.c_str (), std::ios_base::out | std::ios_base::trunc);
+  std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+  if (format == TRACE_FORMAT_BINARY)
+    mode |= std::ios_base::binary;
+  outputStream->open (file.c_str (), mode);
 
   if (!outputStream->is_open ())
     return boost::make_tuple (outputStream, tracers);
 
+  boost::shared_ptr<BinaryTraceWriter> writer;
+  if (format == TRACE_FORMAT_BINARY)
+    {
+      writer.reset (new BinaryTraceWriter (outputStream));
+      AddColumns (*writer);
+    }
+
   for (NodeList::Iterator node = NodeList::Begin ();
        node != NodeList::End ();
        node++)
     {
       NS_LOG_DEBUG ("Node: " << (*node)->GetId ());
 
-      Ptr<CsTracer> trace = Create<CsTracer> (outputStream, *node);
+      Ptr<CsTracer> trace;
+      if (writer)
+        trace = Create<CsTracer> (writer, *node);
+      else
+        trace = Create<CsTracer> (outputStream, *node);
       trace->SetAveragingPeriod (averagingPeriod);
       tracers.push_back (trace);
     }
 
-  if (tracers.size () > 0)
+  if (!writer && tracers.size () > 0)
     {
       // *m_l3RateTrace << "# "; // not necessary for R's read.table
       tracers.front ()->PrintHeader (*outputStream);
@@ -86,6 +102,7 @@ CsTracer::InstallAll (const std::string &file, Time averagingPeriod/* = Seconds
 CsTracer::CsTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node)
 : m_nodePtr (node)
 , m_os (os)
+, m_nodeStringId (0)
 {
   m_node = boost::lexical_cast<string> (m_nodePtr->GetId ());
 
@@ -101,10 +118,31 @@ CsTracer::CsTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node)
 CsTracer::CsTracer (boost::shared_ptr<std::ostream> os, const std::string &node)
 : m_node (node)
 , m_os (os)
+, m_nodeStringId (0)
 {
+  m_nodePtr = FindTracedNode (m_node);
+
   Connect ();
 }
 
+CsTracer::CsTracer (boost::shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node)
+: m_nodePtr (node)
+, m_os (writer->GetStream ())
+, m_writer (writer)
+{
+  m_node = boost::lexical_cast<string> (m_nodePtr->GetId ());
+
+  Connect ();
+
+  string name = Names::FindName (node);
+  if (!name.empty ())
+    {
+      m_node = name;
+    }
+
+  m_nodeStringId = m_writer->GetStringId (m_node);
+}
+
 CsTracer::~CsTracer ()
 {
 };
@@ -113,10 +151,12 @@ CsTracer::~CsTracer ()
 void
 CsTracer::Connect ()
 {
-  Config::ConnectWithoutContext ("/NodeList/"+m_node+"/$ns3::ndn::ContentStore/CacheHits",
-                                 MakeCallback (&CsTracer::CacheHits, this));
-  Config::ConnectWithoutContext ("/NodeList/"+m_node+"/$ns3::ndn::ContentStore/CacheMisses",
-                                 MakeCallback (&CsTracer::CacheMisses, this));
+  Ptr<ContentStore> cs = m_nodePtr->GetObject<ContentStore> ();
+  if (cs != 0)
+    {
+      cs->TraceConnectWithoutContext ("CacheHits",   MakeCallback (&CsTracer::CacheHits, this));
+      cs->TraceConnectWithoutContext ("CacheMisses", MakeCallback (&CsTracer::CacheMisses, this));
+    }
 
   Reset ();  
 }
@@ -133,7 +173,10 @@ CsTracer::SetAveragingPeriod (const Time &period)
 void
 CsTracer::PeriodicPrinter ()
 {
-  Print (*m_os);
+  if (m_writer)
+    Write (*m_writer);
+  else
+    Print (*m_os);
   Reset ();
   
   m_printEvent = Simulator::Schedule (m_period, &CsTracer::PeriodicPrinter, this);
@@ -150,6 +193,17 @@ CsTracer::PrintHeader (std::ostream &os) const
      << "Packets" << "\t";
 }
 
+void
+CsTracer::AddColumns (BinaryTraceWriter &writer)
+{
+  writer.AddColumn ("Time",    BinaryTraceWriter::FLOAT64);
+
+  writer.AddColumn ("Node",    BinaryTraceWriter::STRING);
+
+  writer.AddColumn ("Type",    BinaryTraceWriter::STRING);
+  writer.AddColumn ("Packets", BinaryTraceWriter::FLOAT64);
+}
+
 void
 CsTracer::Reset ()
 {
@@ -162,6 +216,13 @@ CsTracer::Reset ()
   << printName << "\t"                          \
   << m_stats.fieldName << "\n";
 
+#define WRITER(typeName, fieldName)                     \
+  writer.PutFloat (time.ToDouble (Time::S))             \
+    .PutString (m_nodeStringId)                         \
+    .PutString (writer.GetStringId (typeName))          \
+    .PutFloat (m_stats.fieldName)                       \
+    .EndRow ();
+
 
 void
 CsTracer::Print (std::ostream &os) const
@@ -172,6 +233,15 @@ CsTracer::Print (std::ostream &os) const
   PRINTER ("CacheMisses", m_cacheMisses);
 }
 
+void
+CsTracer::Write (BinaryTraceWriter &writer) const
+{
+  Time time = Simulator::Now ();
+
+  WRITER ("CacheHits",   m_cacheHits);
+  WRITER ("CacheMisses", m_cacheMisses);
+}
+
 void 
 CsTracer::CacheHits (Ptr<const Interest>, Ptr<const ContentObject>)
 {
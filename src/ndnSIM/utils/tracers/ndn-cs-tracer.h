@@ -24,6 +24,7 @@
 
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "binary-trace-writer.h"
 #include <ns3/nstime.h>
 #include <ns3/event-id.h>
 
@@ -72,13 +73,15 @@ public:
    *
    * @param file File to which traces will be written
    * @param averagingPeriod How often data will be written into the trace file (default, every half second)
+   * @param format Format of the trace file (text by default)
    *
    * @returns a tuple of reference to output stream and list of tracers. !!! Attention !!! This tuple needs to be preserved
    *          for the lifetime of simulation, otherwise SEGFAULTs are inevitable
    * 
    */
   static boost::tuple< boost::shared_ptr<std::ostream>, std::list<Ptr<CsTracer> > >
-  InstallAll (const std::string &file, Time averagingPeriod = Seconds (0.5));
+  InstallAll (const std::string &file, Time averagingPeriod = Seconds (0.5),
+              TraceFormat format = TRACE_FORMAT_TEXT);
 
   /**
    * @brief Trace constructor that attaches to the node using node pointer
@@ -94,6 +97,13 @@ public:
    */
   CsTracer (boost::shared_ptr<std::ostream> os, const std::string &node);
 
+  /**
+   * @brief Trace constructor that attaches to the node using node pointer and writes binary trace
+   * @param writer binary trace writer (columns should be already added using AddColumns)
+   * @param node   pointer to the node
+   */
+  CsTracer (boost::shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node);
+
   /**
    * @brief Destructor
    */
@@ -114,6 +124,18 @@ public:
    */
   void
   Print (std::ostream &os) const;
+
+  /**
+   * @brief Add columns of the trace to the binary trace writer (counterpart of PrintHeader)
+   */
+  static void
+  AddColumns (BinaryTraceWriter &writer);
+
+  /**
+   * @brief Write current trace data to the binary trace writer (counterpart of Print)
+   */
+  void
+  Write (BinaryTraceWriter &writer) const;
   
 private:
   void
@@ -140,6 +162,8 @@ private:
   Ptr<Node> m_nodePtr;
 
   boost::shared_ptr<std::ostream> m_os;
+  boost::shared_ptr<BinaryTraceWriter> m_writer;
+  uint32_t m_nodeStringId; ///< @brief ID of m_node in the dictionary of the binary trace
 
   Time m_period;
   EventId m_printEvent;
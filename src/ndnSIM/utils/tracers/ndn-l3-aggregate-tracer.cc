@@ -42,30 +42,45 @@ namespace ns3 {
 namespace ndn {
 
 boost::tuple< boost::shared_ptr<std::ostream>, std::list<Ptr<L3AggregateTracer> > >
-L3AggregateTracer::InstallAll (const std::string &file, Time averagingPeriod/* = Seconds (0.5)*/)
+L3AggregateTracer::InstallAll (const std::string &file, Time averagingPeriod/* = Seconds (0.5)*/,
+                               TraceFormat format/* = TRACE_FORMAT_TEXT*/)
 {
   using namespace boost;
   using namespace std;
 
   std::list<Ptr<L3AggregateTracer> > tracers;
   boost::shared_ptr<std::ofstream> outputStream (new std::ofstream ());
-  outputStream->open (file.c_str (), std::ios_base::out | std::ios_base::trunc);
+  std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+  if (format == TRACE_FORMAT_BINARY)
+    mode |= std::ios_base::binary;
+  outputStream->open (file.c_str (), mode);
 
   if (!outputStream->is_open ())
     return boost::make_tuple (outputStream, tracers);
 
+  boost::shared_ptr<BinaryTraceWriter> writer;
+  if (format == TRACE_FORMAT_BINARY)
+    {
+      writer.reset (new BinaryTraceWriter (outputStream));
+      AddColumns (*writer);
+    }
+
   for (NodeList::Iterator node = NodeList::Begin ();
        node != NodeList::End ();
        node++)
     {
       NS_LOG_DEBUG ("Node: " << (*node)->GetId ());
 
-      Ptr<L3AggregateTracer> trace = Create<L3AggregateTracer> (outputStream, *node);
+      Ptr<L3AggregateTracer> trace;
+      if (writer)
+        trace = Create<L3AggregateTracer> (writer, *node);
+      else
+        trace = Create<L3AggregateTracer> (outputStream, *node);
       trace->SetAveragingPeriod (averagingPeriod);
       tracers.push_back (trace);
     }
 
-  if (tracers.size () > 0)
+  if (!writer && tracers.size () > 0)
     {
       // *m_l3RateTrace << "# "; // not necessary for R's read.table
       tracers.front ()->PrintHeader (*outputStream);
@@ -80,6 +95,7 @@ L3AggregateTracer::InstallAll (const std::string &file, Time averagingPeriod/* =
 L3AggregateTracer::L3AggregateTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node)
   : L3Tracer (node)
   , m_os (os)
+  , m_nodeStringId (0)
 {
   Reset ();
 }
@@ -87,6 +103,16 @@ L3AggregateTracer::L3AggregateTracer (boost::shared_ptr<std::ostream> os, Ptr<No
 L3AggregateTracer::L3AggregateTracer (boost::shared_ptr<std::ostream> os, const std::string &node)
   : L3Tracer (node)
   , m_os (os)
+  , m_nodeStringId (0)
+{
+  Reset ();
+}
+
+L3AggregateTracer::L3AggregateTracer (boost::shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node)
+  : L3Tracer (node)
+  , m_os (writer->GetStream ())
+  , m_writer (writer)
+  , m_nodeStringId (writer->GetStringId (m_node))
 {
   Reset ();
 }
@@ -106,7 +132,10 @@ L3AggregateTracer::SetAveragingPeriod (const Time &period)
 void
 L3AggregateTracer::PeriodicPrinter ()
 {
-  Print (*m_os);
+  if (m_writer)
+    Write (*m_writer);
+  else
+    Print (*m_os);
   Reset ();
 
   m_printEvent = Simulator::Schedule (m_period, &L3AggregateTracer::PeriodicPrinter, this);
@@ -126,6 +155,20 @@ L3AggregateTracer::PrintHeader (std::ostream &os) const
      << "Kilobytes";
 }
 
+void
+L3AggregateTracer::AddColumns (BinaryTraceWriter &writer)
+{
+  writer.AddColumn ("Time",      BinaryTraceWriter::FLOAT64);
+
+  writer.AddColumn ("Node",      BinaryTraceWriter::STRING);
+  writer.AddColumn ("FaceId",    BinaryTraceWriter::INT64);
+  writer.AddColumn ("FaceDescr", BinaryTraceWriter::STRING);
+
+  writer.AddColumn ("Type",      BinaryTraceWriter::STRING);
+  writer.AddColumn ("Packets",   BinaryTraceWriter::FLOAT64);
+  writer.AddColumn ("Kilobytes", BinaryTraceWriter::FLOAT64);
+}
+
 void
 L3AggregateTracer::Reset ()
 {
@@ -159,6 +202,25 @@ L3AggregateTracer::Reset ()
   << STATS(0).fieldName << "\t"                                         \
   << STATS(1).fieldName / 1024.0 << "\n";
 
+#define WRITER(typeName, fieldName) \
+  writer.PutFloat (time.ToDouble (Time::S))                             \
+    .PutString (m_nodeStringId);                                        \
+  if (stats->first)                                                     \
+    {                                                                   \
+      writer                                                            \
+        .PutInt (stats->first->GetId ())                                \
+        .PutString (GetFaceDescrId (writer, stats->first));             \
+    }                                                                   \
+  else                                                                  \
+    {                                                                   \
+      writer.PutInt (-1).PutString ("all");                             \
+    }                                                                   \
+  writer                                                                \
+    .PutString (writer.GetStringId (typeName))                          \
+    .PutFloat (STATS(0).fieldName)                                      \
+    .PutFloat (STATS(1).fieldName / 1024.0)                             \
+    .EndRow ();
+
 
 void
 L3AggregateTracer::Print (std::ostream &os) const
@@ -194,58 +256,85 @@ L3AggregateTracer::Print (std::ostream &os) const
       }
   }
 }
+void
+L3AggregateTracer::Write (BinaryTraceWriter &writer) const
+{
+  Time time = Simulator::Now ();
+
+  for (std::map<Ptr<const Face>, boost::tuple<Stats, Stats> >::iterator stats = m_stats.begin ();
+       stats != m_stats.end ();
+       stats++)
+    {
+      if (!stats->first)
+        continue;
+
+      WRITER ("InInterests",   m_inInterests);
+      WRITER ("OutInterests",  m_outInterests);
+      WRITER ("DropInterests", m_dropInterests);
+
+      WRITER ("InNacks",   m_inNacks);
+      WRITER ("OutNacks",  m_outNacks);
+      WRITER ("DropNacks", m_dropNacks);
+
+      WRITER ("InData",   m_inData);
+      WRITER ("OutData",  m_outData);
+      WRITER ("DropData", m_dropData);
+    }
+
+  {
+    std::map<Ptr<const Face>, boost::tuple<Stats, Stats> >::iterator stats = m_stats.find (Ptr<const Face> (0));
+    if (stats != m_stats.end ())
+      {
+        WRITER ("SatisfiedInterests", m_satisfiedInterests);
+        WRITER ("TimedOutInterests", m_timedOutInterests);
+      }
+  }
+}
 
 void
-L3AggregateTracer::OutInterests  (std::string context,
-                                  Ptr<const Interest> header, Ptr<const Face> face)
+L3AggregateTracer::OutInterests  (Ptr<const Interest> header, Ptr<const Face> face)
 {
   m_stats[face].get<0> ().m_outInterests ++;
   m_stats[face].get<1> ().m_outInterests += header->GetSerializedSize ();
 }
 
 void
-L3AggregateTracer::InInterests   (std::string context,
-                                  Ptr<const Interest> header, Ptr<const Face> face)
+L3AggregateTracer::InInterests   (Ptr<const Interest> header, Ptr<const Face> face)
 {
   m_stats[face].get<0> ().m_inInterests ++;
   m_stats[face].get<1> ().m_inInterests += header->GetSerializedSize ();
 }
 
 void
-L3AggregateTracer::DropInterests (std::string context,
-                                  Ptr<const Interest> header, Ptr<const Face> face)
+L3AggregateTracer::DropInterests (Ptr<const Interest> header, Ptr<const Face> face)
 {
   m_stats[face].get<0> ().m_dropInterests ++;
   m_stats[face].get<1> ().m_dropInterests += header->GetSerializedSize ();
 }
 
 void
-L3AggregateTracer::OutNacks  (std::string context,
-                              Ptr<const Interest> header, Ptr<const Face> face)
+L3AggregateTracer::OutNacks  (Ptr<const Interest> header, Ptr<const Face> face)
 {
   m_stats[face].get<0> ().m_outNacks ++;
   m_stats[face].get<1> ().m_outNacks += header->GetSerializedSize ();
 }
 
 void
-L3AggregateTracer::InNacks   (std::string context,
-                              Ptr<const Interest> header, Ptr<const Face> face)
+L3AggregateTracer::InNacks   (Ptr<const Interest> header, Ptr<const Face> face)
 {
   m_stats[face].get<0> ().m_inNacks ++;
   m_stats[face].get<1> ().m_inNacks += header->GetSerializedSize ();
 }
 
 void
-L3AggregateTracer::DropNacks (std::string context,
-                              Ptr<const Interest> header, Ptr<const Face> face)
+L3AggregateTracer::DropNacks (Ptr<const Interest> header, Ptr<const Face> face)
 {
   m_stats[face].get<0> ().m_dropNacks ++;
   m_stats[face].get<1> ().m_dropNacks += header->GetSerializedSize ();
 }
 
 void
-L3AggregateTracer::OutData  (std::string context,
-                             Ptr<const ContentObject> header, Ptr<const Packet> payload,
+L3AggregateTracer::OutData  (Ptr<const ContentObject> header, Ptr<const Packet> payload,
                              bool fromCache, Ptr<const Face> face)
 {
   m_stats[face].get<0> ().m_outData ++;
@@ -253,8 +342,7 @@ L3AggregateTracer::OutData  (std::string context,
 }
 
 void
-L3AggregateTracer::InData   (std::string context,
-                             Ptr<const ContentObject> header, Ptr<const Packet> payload,
+L3AggregateTracer::InData   (Ptr<const ContentObject> header, Ptr<const Packet> payload,
                              Ptr<const Face> face)
 {
   m_stats[face].get<0> ().m_inData ++;
@@ -262,8 +350,7 @@ L3AggregateTracer::InData   (std::string context,
 }
 
 void
-L3AggregateTracer::DropData (std::string context,
-                             Ptr<const ContentObject> header, Ptr<const Packet> payload,
+L3AggregateTracer::DropData (Ptr<const ContentObject> header, Ptr<const Packet> payload,
                              Ptr<const Face> face)
 {
   m_stats[face].get<0> ().m_dropData ++;
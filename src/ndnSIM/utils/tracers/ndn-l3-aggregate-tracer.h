@@ -22,6 +22,7 @@
 #define NDN_L3_AGGREGATE_TRACER_H
 
 #include "ndn-l3-tracer.h"
+#include "binary-trace-writer.h"
 
 #include <ns3/nstime.h>
 #include <ns3/event-id.h>
@@ -55,6 +56,13 @@ public:
    */
   L3AggregateTracer (boost::shared_ptr<std::ostream> os, const std::string &nodeName);
 
+  /**
+   * @brief Trace constructor that attaches to the node using node pointer and writes binary trace
+   * @param writer binary trace writer (columns should be already added using AddColumns)
+   * @param node   pointer to the node
+   */
+  L3AggregateTracer (boost::shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node);
+
   /**
    * @brief Destructor
    */
@@ -65,13 +73,21 @@ public:
    *
    * @param file File to which traces will be written
    * @param averagingPeriod How often data will be written into the trace file (default, every half second)
+   * @param format Format of the trace file (text by default)
    *
    * @returns a tuple of reference to output stream and list of tracers. !!! Attention !!! This tuple needs to be preserved
    *          for the lifetime of simulation, otherwise SEGFAULTs are inevitable
    *
    */
   static boost::tuple< boost::shared_ptr<std::ostream>, std::list<Ptr<L3AggregateTracer> > >
-  InstallAll (const std::string &file, Time averagingPeriod = Seconds (0.5));
+  InstallAll (const std::string &file, Time averagingPeriod = Seconds (0.5),
+              TraceFormat format = TRACE_FORMAT_TEXT);
+
+  /**
+   * @brief Add columns of the trace to the binary trace writer (counterpart of PrintHeader)
+   */
+  static void
+  AddColumns (BinaryTraceWriter &writer);
 
 protected:
   // from L3Tracer
@@ -81,41 +97,38 @@ protected:
   virtual void
   Print (std::ostream &os) const;
 
+  /**
+   * @brief Write current trace data to the binary trace writer (counterpart of Print)
+   */
+  void
+  Write (BinaryTraceWriter &writer) const;
+
   virtual void
-  OutInterests  (std::string context,
-                 Ptr<const Interest>, Ptr<const Face>);
+  OutInterests  (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  InInterests   (std::string context,
-                 Ptr<const Interest>, Ptr<const Face>);
+  InInterests   (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  DropInterests (std::string context,
-                 Ptr<const Interest>, Ptr<const Face>);
+  DropInterests (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  OutNacks  (std::string context,
-             Ptr<const Interest>, Ptr<const Face>);
+  OutNacks  (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  InNacks   (std::string context,
-             Ptr<const Interest>, Ptr<const Face>);
+  InNacks   (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  DropNacks (std::string context,
-             Ptr<const Interest>, Ptr<const Face>);
+  DropNacks (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  OutData  (std::string context,
-            Ptr<const ContentObject>, Ptr<const Packet>, bool fromCache, Ptr<const Face>);
+  OutData  (Ptr<const ContentObject>, Ptr<const Packet>, bool fromCache, Ptr<const Face>);
 
   virtual void
-  InData   (std::string context,
-            Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>);
+  InData   (Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>);
 
   virtual void
-  DropData (std::string context,
-            Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>);
+  DropData (Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>);
 
 
   virtual void
@@ -136,6 +149,8 @@ protected:
 
 protected:
   boost::shared_ptr<std::ostream> m_os;
+  boost::shared_ptr<BinaryTraceWriter> m_writer;
+  uint32_t m_nodeStringId; ///< @brief ID of m_node in the dictionary of the binary trace
 
   Time m_period;
   EventId m_printEvent;
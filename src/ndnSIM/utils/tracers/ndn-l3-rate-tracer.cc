@@ -34,6 +34,7 @@
 #include "ns3/ndn-pit-entry.h"
 
 #include <fstream>
+#include <cstdio>
 #include <boost/lexical_cast.hpp>
 
 using namespace boost;
@@ -46,27 +47,42 @@ namespace ndn {
 
 
 boost::tuple< boost::shared_ptr<std::ostream>, std::list<Ptr<L3RateTracer> > >
-L3RateTracer::InstallAll (const std::string &file, Time averagingPeriod/* = Seconds (0.5)*/)
+L3RateTracer::InstallAll (const std::string &file, Time averagingPeriod/* = Seconds (0.5)*/,
+                          TraceFormat format/* = TRACE_FORMAT_TEXT*/)
 {
   std::list<Ptr<L3RateTracer> > tracers;
   boost::shared_ptr<std::ofstream> outputStream (new std::ofstream ());
-  outputStream->open (file.c_str (), std::ios_base::out | std::ios_base::trunc);
+  std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+  if (format == TRACE_FORMAT_BINARY)
+    mode |= std::ios_base::binary;
+  outputStream->open (file.c_str (), mode);
 
   if (!outputStream->is_open ())
     return boost::make_tuple (outputStream, tracers);
 
+  boost::shared_ptr<BinaryTraceWriter> writer;
+  if (format == TRACE_FORMAT_BINARY)
+    {
+      writer.reset (new BinaryTraceWriter (outputStream));
+      AddColumns (*writer);
+    }
+
   for (NodeList::Iterator node = NodeList::Begin ();
        node != NodeList::End ();
        node++)
     {
       NS_LOG_DEBUG ("Node: " << lexical_cast<string> ((*node)->GetId ()));
 
-      Ptr<L3RateTracer> trace = Create<L3RateTracer> (outputStream, *node);
+      Ptr<L3RateTracer> trace;
+      if (writer)
+        trace = Create<L3RateTracer> (writer, *node);
+      else
+        trace = Create<L3RateTracer> (outputStream, *node);
       trace->SetAveragingPeriod (averagingPeriod);
       tracers.push_back (trace);
     }
 
-  if (tracers.size () > 0)
+  if (!writer && tracers.size () > 0)
     {
       // *m_l3RateTrace << "# "; // not necessary for R's read.table
       tracers.front ()->PrintHeader (*outputStream);
@@ -80,6 +96,9 @@ L3RateTracer::InstallAll (const std::string &file, Time averagingPeriod/* = Seco
 L3RateTracer::L3RateTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node)
   : L3Tracer (node)
   , m_os (os)
+  , m_nodeStringId (0)
+  , m_hasNodeStats (false)
+  , m_priorityTypes (Interest::PRIORITY3 + 1)
 {
   SetAveragingPeriod (Seconds (1.0));
 }
@@ -87,6 +106,20 @@ L3RateTracer::L3RateTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node)
 L3RateTracer::L3RateTracer (boost::shared_ptr<std::ostream> os, const std::string &node)
   : L3Tracer (node)
   , m_os (os)
+  , m_nodeStringId (0)
+  , m_hasNodeStats (false)
+  , m_priorityTypes (Interest::PRIORITY3 + 1)
+{
+  SetAveragingPeriod (Seconds (1.0));
+}
+
+L3RateTracer::L3RateTracer (boost::shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node)
+  : L3Tracer (node)
+  , m_os (writer->GetStream ())
+  , m_writer (writer)
+  , m_nodeStringId (writer->GetStringId (m_node))
+  , m_hasNodeStats (false)
+  , m_priorityTypes (Interest::PRIORITY3 + 1)
 {
   SetAveragingPeriod (Seconds (1.0));
 }
@@ -107,7 +140,10 @@ L3RateTracer::SetAveragingPeriod (const Time &period)
 void
 L3RateTracer::PeriodicPrinter ()
 {
-  Print (*m_os);
+  if (m_writer)
+    Write (*m_writer);
+  else
+    Print (*m_os);
   Reset ();
 
   m_printEvent = Simulator::Schedule (m_period, &L3RateTracer::PeriodicPrinter, this);
@@ -129,34 +165,75 @@ L3RateTracer::PrintHeader (std::ostream &os) const
      << "KilobytesRaw";
 }
 
+void
+L3RateTracer::AddColumns (BinaryTraceWriter &writer)
+{
+  writer.AddColumn ("Time",         BinaryTraceWriter::FLOAT64);
+
+  writer.AddColumn ("Node",         BinaryTraceWriter::STRING);
+  writer.AddColumn ("FaceId",       BinaryTraceWriter::INT64);
+  writer.AddColumn ("FaceDescr",    BinaryTraceWriter::STRING);
+
+  writer.AddColumn ("Type",         BinaryTraceWriter::STRING);
+  writer.AddColumn ("Packets",      BinaryTraceWriter::FLOAT64);
+  writer.AddColumn ("Kilobytes",    BinaryTraceWriter::FLOAT64);
+  writer.AddColumn ("PacketRaw",    BinaryTraceWriter::FLOAT64);
+  writer.AddColumn ("KilobytesRaw", BinaryTraceWriter::FLOAT64);
+}
+
+void
+L3RateTracer::UpdatePriorityTypes (uint8_t priority)
+{
+  if (priority >= m_priorityTypes)
+    m_priorityTypes = priority + 1;
+}
+
 void
 L3RateTracer::Reset ()
 {
-  for (std::map<Ptr<const Face>, boost::tuple<Stats, Stats, Stats, Stats> >::iterator stats = m_stats.begin ();
-       stats != m_stats.end ();
+  for (std::vector<FaceStats>::iterator stats = m_faceStats.begin ();
+       stats != m_faceStats.end ();
        stats++)
     {
-      stats->second.get<0> ().Reset ();
-      stats->second.get<1> ().Reset ();
+      stats->m_raw = RawStats ();
     }
+  m_nodeStats.m_raw = RawStats ();
+}
+
+inline L3RateTracer::FaceStats &
+L3RateTracer::GetFaceStats (const Ptr<const Face> &face)
+{
+  uint32_t id = face->GetId ();
+  NS_ASSERT_MSG (id != static_cast<uint32_t> (-1), "Face is not added to the NDN stack");
+
+  if (id >= m_faceStats.size ())
+    m_faceStats.resize (id + 1);
+
+  FaceStats &stats = m_faceStats[id];
+  if (stats.m_face == 0)
+    stats.m_face = face;
+  return stats;
 }
 
 const double alpha = 0.8;
 
-#define STATS(INDEX) stats->second.get<INDEX> ()
-#define RATE(INDEX, fieldName) STATS(INDEX).fieldName / m_period.ToDouble (Time::S)
+#define RAW(fieldName, counter) stats->m_raw.fieldName.counter
+#define RATE(fieldName, counter) RAW(fieldName, counter) / m_period.ToDouble (Time::S)
+
+#define UPDATE(fieldName) \
+  stats->m_packetRate.fieldName = /*new value*/alpha * RATE(fieldName, m_packets) + /*old value*/(1-alpha) * stats->m_packetRate.fieldName; \
+  stats->m_byteRate.fieldName = /*new value*/alpha * RATE(fieldName, m_bytes) / 1024.0 + /*old value*/(1-alpha) * stats->m_byteRate.fieldName;
 
 #define PRINTER(printName, fieldName) \
-  STATS(2).fieldName = /*new value*/alpha * RATE(0, fieldName) + /*old value*/(1-alpha) * STATS(2).fieldName; \
-  STATS(3).fieldName = /*new value*/alpha * RATE(1, fieldName) / 1024.0 + /*old value*/(1-alpha) * STATS(3).fieldName; \
+  UPDATE(fieldName)                                                     \
                                                                         \
   os << time.ToDouble (Time::S) << "\t"                                 \
   << m_node << "\t";                                                    \
-  if (stats->first)                                                     \
+  if (stats->m_face)                                                    \
     {                                                                   \
       os                                                                \
-        << stats->first->GetId () << "\t"                               \
-        << *stats->first << "\t";                                       \
+        << stats->m_face->GetId () << "\t"                              \
+        << *stats->m_face << "\t";                                      \
     }                                                                   \
   else                                                                  \
     {                                                                   \
@@ -164,21 +241,44 @@ const double alpha = 0.8;
     }                                                                   \
   os                                                                    \
   << printName << "\t"                                                  \
-  << STATS(2).fieldName << "\t"                                         \
-  << STATS(3).fieldName << "\t"                                         \
-  << STATS(0).fieldName << "\t"                                         \
-  << STATS(1).fieldName / 1024.0 << "\n";
+  << stats->m_packetRate.fieldName << "\t"                              \
+  << stats->m_byteRate.fieldName << "\t"                                \
+  << RAW(fieldName, m_packets) << "\t"                                  \
+  << RAW(fieldName, m_bytes) / 1024.0 << "\n";
+
+#define WRITER(typeId, fieldName) \
+  UPDATE(fieldName)                                                     \
+                                                                        \
+  writer.PutFloat (time.ToDouble (Time::S))                             \
+    .PutString (m_nodeStringId);                                        \
+  if (stats->m_face)                                                    \
+    {                                                                   \
+      writer                                                            \
+        .PutInt (stats->m_face->GetId ())                               \
+        .PutString (GetFaceDescrId (writer, stats->m_face));            \
+    }                                                                   \
+  else                                                                  \
+    {                                                                   \
+      writer.PutInt (-1).PutString ("all");                             \
+    }                                                                   \
+  writer                                                                \
+    .PutString (typeId)                                                 \
+    .PutFloat (stats->m_packetRate.fieldName)                           \
+    .PutFloat (stats->m_byteRate.fieldName)                             \
+    .PutFloat (RAW(fieldName, m_packets))                               \
+    .PutFloat (RAW(fieldName, m_bytes) / 1024.0)                        \
+    .EndRow ();
 
 void
 L3RateTracer::Print (std::ostream &os) const
 {
   Time time = Simulator::Now ();
 
-  for (std::map<Ptr<const Face>, boost::tuple<Stats, Stats, Stats, Stats> >::iterator stats = m_stats.begin ();
-       stats != m_stats.end ();
+  for (std::vector<FaceStats>::iterator stats = m_faceStats.begin ();
+       stats != m_faceStats.end ();
        stats++)
     {
-      if (!stats->first)
+      if (!stats->m_face)
         continue;
 
       PRINTER ("InInterests",   m_inInterests);
@@ -195,118 +295,154 @@ L3RateTracer::Print (std::ostream &os) const
 
       // JRO
       uint8_t priority;
-      for(priority=0; priority<4; priority++) {
+      for(priority=0; priority<m_priorityTypes; priority++) {
         PRINTER ("InInterestPriority"<<+priority, m_InInterestsPriority[priority]);
         PRINTER ("OutInterestPriority"<<+priority, m_OutInterestsPriority[priority]);
         PRINTER ("DropInterestPriority"<<+priority, m_DropInterestsPriority[priority]);
       }
     }
 
-  {
-    std::map<Ptr<const Face>, boost::tuple<Stats, Stats, Stats, Stats> >::iterator stats = m_stats.find (Ptr<const Face> (0));
-    if (stats != m_stats.end ())
-      {
-        PRINTER ("SatisfiedInterests", m_satisfiedInterests);
-        PRINTER ("TimedOutInterests", m_timedOutInterests);
-      }
-  }
+  if (m_hasNodeStats)
+    {
+      FaceStats *stats = &m_nodeStats;
+      PRINTER ("SatisfiedInterests", m_satisfiedInterests);
+      PRINTER ("TimedOutInterests", m_timedOutInterests);
+    }
 }
 
+void
+L3RateTracer::Write (BinaryTraceWriter &writer) const
+{
+  Time time = Simulator::Now ();
+  char typeName[32];
+
+  for (std::vector<FaceStats>::iterator stats = m_faceStats.begin ();
+       stats != m_faceStats.end ();
+       stats++)
+    {
+      if (!stats->m_face)
+        continue;
+
+      WRITER (writer.GetStringId ("InInterests"),   m_inInterests);
+      WRITER (writer.GetStringId ("OutInterests"),  m_outInterests);
+      WRITER (writer.GetStringId ("DropInterests"), m_dropInterests);
+
+      WRITER (writer.GetStringId ("InNacks"),   m_inNacks);
+      WRITER (writer.GetStringId ("OutNacks"),  m_outNacks);
+      WRITER (writer.GetStringId ("DropNacks"), m_dropNacks);
+
+      WRITER (writer.GetStringId ("InData"),   m_inData);
+      WRITER (writer.GetStringId ("OutData"),  m_outData);
+      WRITER (writer.GetStringId ("DropData"), m_dropData);
+
+      for (uint8_t priority = 0; priority < m_priorityTypes; priority++)
+        {
+          std::sprintf (typeName, "InInterestPriority%u", priority);
+          WRITER (writer.GetStringId (typeName), m_InInterestsPriority[priority]);
+          std::sprintf (typeName, "OutInterestPriority%u", priority);
+          WRITER (writer.GetStringId (typeName), m_OutInterestsPriority[priority]);
+          std::sprintf (typeName, "DropInterestPriority%u", priority);
+          WRITER (writer.GetStringId (typeName), m_DropInterestsPriority[priority]);
+        }
+    }
+
+  if (m_hasNodeStats)
+    {
+      FaceStats *stats = &m_nodeStats;
+      WRITER (writer.GetStringId ("SatisfiedInterests"), m_satisfiedInterests);
+      WRITER (writer.GetStringId ("TimedOutInterests"), m_timedOutInterests);
+    }
+}
 
 void
-L3RateTracer::OutInterests  (std::string context,
-                             Ptr<const Interest> header, Ptr<const Face> face)
+L3RateTracer::OutInterests  (Ptr<const Interest> header, Ptr<const Face> face)
 {
-  m_stats[face].get<0> ().m_outInterests ++;
-  m_stats[face].get<1> ().m_outInterests += header->GetSerializedSize ();
-  m_stats[face].get<0> ().m_OutInterestsPriority[header->GetPriority()] ++;
-  m_stats[face].get<1> ().m_OutInterestsPriority[header->GetPriority()] += header->GetSerializedSize();
+  uint32_t size = header->GetSerializedSize ();
+  uint8_t priority = header->GetPriority ();
+  UpdatePriorityTypes (priority);
+
+  RawStats &stats = GetFaceStats (face).m_raw;
+  stats.m_outInterests.Add (size);
+  stats.m_OutInterestsPriority[priority].Add (size);
 }
 
 void
-L3RateTracer::InInterests   (std::string context,
-                             Ptr<const Interest> header, Ptr<const Face> face)
+L3RateTracer::InInterests   (Ptr<const Interest> header, Ptr<const Face> face)
 {
-  m_stats[face].get<0> ().m_inInterests ++;
-  m_stats[face].get<1> ().m_inInterests += header->GetSerializedSize ();
+  uint32_t size = header->GetSerializedSize ();
+  uint8_t priority = header->GetPriority ();
   // JRO
-  m_stats[face].get<0> ().m_InInterestsPriority[header->GetPriority()] ++;
-  m_stats[face].get<1> ().m_InInterestsPriority[header->GetPriority()] += header->GetSerializedSize();
+  UpdatePriorityTypes (priority);
 
+  RawStats &stats = GetFaceStats (face).m_raw;
+  stats.m_inInterests.Add (size);
+  stats.m_InInterestsPriority[priority].Add (size);
 }
 
 void
-L3RateTracer::DropInterests (std::string context,
-                             Ptr<const Interest> header, Ptr<const Face> face)
+L3RateTracer::DropInterests (Ptr<const Interest> header, Ptr<const Face> face)
 {
-  m_stats[face].get<0> ().m_dropInterests ++;
-  m_stats[face].get<1> ().m_dropInterests += header->GetSerializedSize ();
-  m_stats[face].get<0> ().m_DropInterestsPriority[header->GetPriority()] ++;
-  m_stats[face].get<1> ().m_DropInterestsPriority[header->GetPriority()] += header->GetSerializedSize();
+  uint32_t size = header->GetSerializedSize ();
+  uint8_t priority = header->GetPriority ();
+  UpdatePriorityTypes (priority);
+
+  RawStats &stats = GetFaceStats (face).m_raw;
+  stats.m_dropInterests.Add (size);
+  stats.m_DropInterestsPriority[priority].Add (size);
 }
 
 void
-L3RateTracer::OutNacks  (std::string context,
-                         Ptr<const Interest> header, Ptr<const Face> face)
+L3RateTracer::OutNacks  (Ptr<const Interest> header, Ptr<const Face> face)
 {
-  m_stats[face].get<0> ().m_outNacks ++;
-  m_stats[face].get<1> ().m_outNacks += header->GetSerializedSize ();
+  GetFaceStats (face).m_raw.m_outNacks.Add (header->GetSerializedSize ());
 }
 
 void
-L3RateTracer::InNacks   (std::string context,
-                         Ptr<const Interest> header, Ptr<const Face> face)
+L3RateTracer::InNacks   (Ptr<const Interest> header, Ptr<const Face> face)
 {
-  m_stats[face].get<0> ().m_inNacks ++;
-  m_stats[face].get<1> ().m_inNacks += header->GetSerializedSize ();
+  GetFaceStats (face).m_raw.m_inNacks.Add (header->GetSerializedSize ());
 }
 
 void
-L3RateTracer::DropNacks (std::string context,
-                         Ptr<const Interest> header, Ptr<const Face> face)
+L3RateTracer::DropNacks (Ptr<const Interest> header, Ptr<const Face> face)
 {
-  m_stats[face].get<0> ().m_dropNacks ++;
-  m_stats[face].get<1> ().m_dropNacks += header->GetSerializedSize ();
+  GetFaceStats (face).m_raw.m_dropNacks.Add (header->GetSerializedSize ());
 }
 
 void
-L3RateTracer::OutData  (std::string context,
-                        Ptr<const ContentObject> header, Ptr<const Packet> payload,
+L3RateTracer::OutData  (Ptr<const ContentObject> header, Ptr<const Packet> payload,
                         bool fromCache, Ptr<const Face> face)
 {
-  m_stats[face].get<0> ().m_outData ++;
-  m_stats[face].get<1> ().m_outData += header->GetSerializedSize () + payload->GetSize ();
+  GetFaceStats (face).m_raw.m_outData.Add (header->GetSerializedSize () + payload->GetSize ());
 }
 
 void
-L3RateTracer::InData   (std::string context,
-                        Ptr<const ContentObject> header, Ptr<const Packet> payload,
+L3RateTracer::InData   (Ptr<const ContentObject> header, Ptr<const Packet> payload,
                         Ptr<const Face> face)
 {
-  m_stats[face].get<0> ().m_inData ++;
-  m_stats[face].get<1> ().m_inData += header->GetSerializedSize () + payload->GetSize ();
+  GetFaceStats (face).m_raw.m_inData.Add (header->GetSerializedSize () + payload->GetSize ());
 }
 
 void
-L3RateTracer::DropData (std::string context,
-                        Ptr<const ContentObject> header, Ptr<const Packet> payload,
+L3RateTracer::DropData (Ptr<const ContentObject> header, Ptr<const Packet> payload,
                         Ptr<const Face> face)
 {
-  m_stats[face].get<0> ().m_dropData ++;
-  m_stats[face].get<1> ().m_dropData += header->GetSerializedSize () + payload->GetSize ();
+  GetFaceStats (face).m_raw.m_dropData.Add (header->GetSerializedSize () + payload->GetSize ());
 }
 
 void
 L3RateTracer::SatisfiedInterests (Ptr<const pit::Entry>)
 {
-  m_stats[0].get<0> ().m_satisfiedInterests ++;
+  m_hasNodeStats = true;
+  m_nodeStats.m_raw.m_satisfiedInterests.m_packets ++;
   // no "size" stats
 }
 
 void
 L3RateTracer::TimedOutInterests (Ptr<const pit::Entry>)
 {
-  m_stats[0].get<0> ().m_timedOutInterests ++;
+  m_hasNodeStats = true;
+  m_nodeStats.m_raw.m_timedOutInterests.m_packets ++;
   // no "size" stats
 }
 
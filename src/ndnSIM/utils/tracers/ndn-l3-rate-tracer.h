@@ -22,13 +22,14 @@
 #define CCNX_RATE_L3_TRACER_H
 
 #include "ndn-l3-tracer.h"
+#include "binary-trace-writer.h"
 
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 
 #include <boost/tuple/tuple.hpp>
 #include <boost/shared_ptr.hpp>
-#include <map>
+#include <vector>
 #include <list>
 
 namespace ns3 {
@@ -55,6 +56,13 @@ public:
    */
   L3RateTracer (boost::shared_ptr<std::ostream> os, const std::string &node);
 
+  /**
+   * @brief Trace constructor that attaches to the node using node pointer and writes binary trace
+   * @param writer binary trace writer (columns should be already added using AddColumns)
+   * @param node   pointer to the node
+   */
+  L3RateTracer (boost::shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node);
+
   /**
    * @brief Destructor
    */
@@ -66,13 +74,27 @@ public:
    * @param file File to which traces will be written
    * @param averagingPeriod Defines averaging period for the rate calculation,
    *        as well as how often data will be written into the trace file (default, every half second)
+   * @param format Format of the trace file (text by default)
    *
    * @returns a tuple of reference to output stream and list of tracers. !!! Attention !!! This tuple needs to be preserved
    *          for the lifetime of simulation, otherwise SEGFAULTs are inevitable
    *
    */
   static boost::tuple< boost::shared_ptr<std::ostream>, std::list<Ptr<L3RateTracer> > >
-  InstallAll (const std::string &file, Time averagingPeriod = Seconds (0.5));
+  InstallAll (const std::string &file, Time averagingPeriod = Seconds (0.5),
+              TraceFormat format = TRACE_FORMAT_TEXT);
+
+  /**
+   * @brief Add columns of the trace to the binary trace writer (counterpart of PrintHeader)
+   */
+  static void
+  AddColumns (BinaryTraceWriter &writer);
+
+  /**
+   * @brief Write current trace data to the binary trace writer (counterpart of Print)
+   */
+  void
+  Write (BinaryTraceWriter &writer) const;
 
   // from L3Tracer
   virtual void
@@ -84,40 +106,31 @@ public:
 protected:
   // from L3Tracer
   virtual void
-  OutInterests  (std::string context,
-                 Ptr<const Interest>, Ptr<const Face>);
+  OutInterests  (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  InInterests   (std::string context,
-                 Ptr<const Interest>, Ptr<const Face>);
+  InInterests   (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  DropInterests (std::string context,
-                 Ptr<const Interest>, Ptr<const Face>);
+  DropInterests (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  OutNacks  (std::string context,
-             Ptr<const Interest>, Ptr<const Face>);
+  OutNacks  (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  InNacks   (std::string context,
-             Ptr<const Interest>, Ptr<const Face>);
+  InNacks   (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  DropNacks (std::string context,
-             Ptr<const Interest>, Ptr<const Face>);
+  DropNacks (Ptr<const Interest>, Ptr<const Face>);
 
   virtual void
-  OutData  (std::string context,
-            Ptr<const ContentObject>, Ptr<const Packet>, bool fromCache, Ptr<const Face>);
+  OutData  (Ptr<const ContentObject>, Ptr<const Packet>, bool fromCache, Ptr<const Face>);
 
   virtual void
-  InData   (std::string context,
-            Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>);
+  InData   (Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>);
 
   virtual void
-  DropData (std::string context,
-            Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>);
+  DropData (Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>);
 
   virtual void
   SatisfiedInterests (Ptr<const pit::Entry>);
@@ -135,12 +148,87 @@ private:
   void
   Reset ();
 
+  /**
+   * @brief Make sure per-priority stats are printed for all priority types seen so far
+   */
+  void
+  UpdatePriorityTypes (uint8_t priority);
+
+  /**
+   * @brief Number of packets and bytes
+   */
+  struct Counter
+  {
+    double m_packets;
+    double m_bytes;
+
+    inline void
+    Add (uint32_t bytes)
+    {
+      m_packets ++;
+      m_bytes += bytes;
+    }
+  };
+
+  /**
+   * @brief Raw counters of the current averaging period
+   *
+   * Every per-priority array immediately follows the corresponding aggregate counter, so an update
+   * of both usually touches the same cache line
+   */
+  struct RawStats
+  {
+    Counter m_inInterests;
+    Counter m_InInterestsPriority[Interest::MAX_PRIORITY_TYPES];
+    Counter m_outInterests;
+    Counter m_OutInterestsPriority[Interest::MAX_PRIORITY_TYPES];
+    Counter m_dropInterests;
+    Counter m_DropInterestsPriority[Interest::MAX_PRIORITY_TYPES];
+    Counter m_inNacks;
+    Counter m_outNacks;
+    Counter m_dropNacks;
+    Counter m_inData;
+    Counter m_outData;
+    Counter m_dropData;
+    Counter m_satisfiedInterests;
+    Counter m_timedOutInterests;
+  };
+
+  /**
+   * @brief Raw counters and smoothed rates of one face (or of the whole node)
+   */
+  struct FaceStats
+  {
+    FaceStats ()
+      : m_raw () // all counters are zero
+    {
+      m_packetRate.Reset ();
+      m_byteRate.Reset ();
+    }
+
+    Ptr<const Face> m_face; ///< @brief face (0 for node-wide stats or for unused entry)
+    RawStats m_raw;
+    Stats m_packetRate;     ///< @brief smoothed packet rates
+    Stats m_byteRate;       ///< @brief smoothed rates in kilobytes
+  };
+
+  /**
+   * @brief Get stats of the face, creating them if necessary
+   */
+  inline FaceStats &
+  GetFaceStats (const Ptr<const Face> &face);
+
 private:
   boost::shared_ptr<std::ostream> m_os;
+  boost::shared_ptr<BinaryTraceWriter> m_writer;
+  uint32_t m_nodeStringId; ///< @brief ID of m_node in the dictionary of the binary trace
   Time m_period;
   EventId m_printEvent;
 
-  mutable std::map<Ptr<const Face>, boost::tuple<Stats, Stats, Stats, Stats> > m_stats;
+  mutable std::vector<FaceStats> m_faceStats; ///< @brief stats indexed by face ID
+  mutable FaceStats m_nodeStats;              ///< @brief node-wide stats (satisfied and timed out interests)
+  bool m_hasNodeStats;
+  uint8_t m_priorityTypes; ///< @brief Number of priority types to print (at least 4)
 };
 
 } // namespace ndn
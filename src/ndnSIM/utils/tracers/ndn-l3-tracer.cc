@@ -20,8 +20,8 @@
 
 #include "ndn-l3-tracer.h"
 #include "ns3/node.h"
+#include "ns3/node-list.h"
 #include "ns3/packet.h"
-#include "ns3/config.h"
 #include "ns3/names.h"
 #include "ns3/callback.h"
 
@@ -31,6 +31,12 @@
 #include "ns3/ndn-interest.h"
 #include "ns3/ndn-content-object.h"
 #include "ns3/ndn-pit-entry.h"
+#include "ns3/ndn-forwarding-strategy.h"
+
+#include "binary-trace-writer.h"
+#include "ndn-tracer-node.h"
+
+#include <sstream>
 
 using namespace std;
 
@@ -54,6 +60,8 @@ L3Tracer::L3Tracer (Ptr<Node> node)
 L3Tracer::L3Tracer (const std::string &node)
 : m_node (node)
 {
+  m_nodePtr = FindTracedNode (m_node);
+
   Connect ();
 }
 
@@ -65,33 +73,41 @@ L3Tracer::~L3Tracer ()
 void
 L3Tracer::Connect ()
 {
-  Config::Connect ("/NodeList/"+m_node+"/$ns3::ndn::ForwardingStrategy/OutInterests",
-                   MakeCallback (&L3Tracer::OutInterests, this));
-  Config::Connect ("/NodeList/"+m_node+"/$ns3::ndn::ForwardingStrategy/InInterests",
-                   MakeCallback (&L3Tracer::InInterests, this));
-  Config::Connect ("/NodeList/"+m_node+"/$ns3::ndn::ForwardingStrategy/DropInterests",
-                   MakeCallback (&L3Tracer::DropInterests, this));
-
-  Config::Connect ("/NodeList/"+m_node+"/$ns3::ndn::ForwardingStrategy/OutData",
-                   MakeCallback (&L3Tracer::OutData, this));
-  Config::Connect ("/NodeList/"+m_node+"/$ns3::ndn::ForwardingStrategy/InData",
-                   MakeCallback (&L3Tracer::InData, this));
-  Config::Connect ("/NodeList/"+m_node+"/$ns3::ndn::ForwardingStrategy/DropData",
-                   MakeCallback (&L3Tracer::DropData, this));
+  // trace sources are connected directly, without resolving configuration paths and without trace context
+  Ptr<ForwardingStrategy> fw = m_nodePtr->GetObject<ForwardingStrategy> ();
+  if (fw == 0)
+    return; // NDN stack is not installed on the node
+
+  fw->TraceConnectWithoutContext ("OutInterests",  MakeCallback (&L3Tracer::OutInterests, this));
+  fw->TraceConnectWithoutContext ("InInterests",   MakeCallback (&L3Tracer::InInterests, this));
+  fw->TraceConnectWithoutContext ("DropInterests", MakeCallback (&L3Tracer::DropInterests, this));
+
+  fw->TraceConnectWithoutContext ("OutData",  MakeCallback (&L3Tracer::OutData, this));
+  fw->TraceConnectWithoutContext ("InData",   MakeCallback (&L3Tracer::InData, this));
+  fw->TraceConnectWithoutContext ("DropData", MakeCallback (&L3Tracer::DropData, this));
 
   // only for some strategies
-  Config::Connect ("/NodeList/"+m_node+"/$ns3::ndn::ForwardingStrategy/OutNacks",
-                   MakeCallback (&L3Tracer::OutNacks, this));
-  Config::Connect ("/NodeList/"+m_node+"/$ns3::ndn::ForwardingStrategy/InNacks",
-                   MakeCallback (&L3Tracer::InNacks, this));
-  Config::Connect ("/NodeList/"+m_node+"/$ns3::ndn::ForwardingStrategy/DropNacks",
-                   MakeCallback (&L3Tracer::DropNacks, this));
+  fw->TraceConnectWithoutContext ("OutNacks",  MakeCallback (&L3Tracer::OutNacks, this));
+  fw->TraceConnectWithoutContext ("InNacks",   MakeCallback (&L3Tracer::InNacks, this));
+  fw->TraceConnectWithoutContext ("DropNacks", MakeCallback (&L3Tracer::DropNacks, this));
 
   // satisfied/timed out PIs
-  Config::ConnectWithoutContext ("/NodeList/"+m_node+"/$ns3::ndn::ForwardingStrategy/SatisfiedInterests",
-                                 MakeCallback (&L3Tracer::SatisfiedInterests, this));
-  Config::ConnectWithoutContext ("/NodeList/"+m_node+"/$ns3::ndn::ForwardingStrategy/TimedOutInterests",
-                                 MakeCallback (&L3Tracer::TimedOutInterests, this));
+  fw->TraceConnectWithoutContext ("SatisfiedInterests", MakeCallback (&L3Tracer::SatisfiedInterests, this));
+  fw->TraceConnectWithoutContext ("TimedOutInterests",  MakeCallback (&L3Tracer::TimedOutInterests, this));
+}
+
+uint32_t
+L3Tracer::GetFaceDescrId (BinaryTraceWriter &writer, Ptr<const Face> face) const
+{
+  std::map<Ptr<const Face>, uint32_t>::iterator id = m_faceDescrIds.find (face);
+  if (id != m_faceDescrIds.end ())
+    return id->second;
+
+  std::ostringstream os;
+  os << *face;
+  uint32_t descrId = writer.GetStringId (os.str ());
+  m_faceDescrIds.insert (std::make_pair (face, descrId));
+  return descrId;
 }
 
 } // namespace ndn
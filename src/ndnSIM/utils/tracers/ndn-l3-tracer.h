@@ -23,11 +23,15 @@
 
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "ns3/ndn-interest.h"
+
+#include <map>
 
 namespace ns3 {
 
 class Node;
 class Packet;
+class BinaryTraceWriter;
 
 namespace ndn {
 
@@ -87,41 +91,32 @@ protected:
   Connect ();
 
   virtual void
-  OutInterests  (std::string context,
-                 Ptr<const Interest>, Ptr<const Face>) = 0;
+  OutInterests  (Ptr<const Interest>, Ptr<const Face>) = 0;
 
   virtual void
-  InInterests   (std::string context,
-                 Ptr<const Interest>, Ptr<const Face>) = 0;
+  InInterests   (Ptr<const Interest>, Ptr<const Face>) = 0;
 
   virtual void
-  DropInterests (std::string context,
-                 Ptr<const Interest>, Ptr<const Face>) = 0;
+  DropInterests (Ptr<const Interest>, Ptr<const Face>) = 0;
 
   virtual void
-  OutNacks  (std::string context,
-             Ptr<const Interest>, Ptr<const Face>) = 0;
+  OutNacks  (Ptr<const Interest>, Ptr<const Face>) = 0;
 
   virtual void
-  InNacks   (std::string context,
-             Ptr<const Interest>, Ptr<const Face>) = 0;
+  InNacks   (Ptr<const Interest>, Ptr<const Face>) = 0;
 
   virtual void
-  DropNacks (std::string context,
-             Ptr<const Interest>, Ptr<const Face>) = 0;
+  DropNacks (Ptr<const Interest>, Ptr<const Face>) = 0;
 
 
   virtual void
-  OutData  (std::string context,
-            Ptr<const ContentObject>, Ptr<const Packet>, bool fromCache, Ptr<const Face>) = 0;
+  OutData  (Ptr<const ContentObject>, Ptr<const Packet>, bool fromCache, Ptr<const Face>) = 0;
 
   virtual void
-  InData   (std::string context,
-            Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>) = 0;
+  InData   (Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>) = 0;
 
   virtual void
-  DropData (std::string context,
-            Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>) = 0;
+  DropData (Ptr<const ContentObject>, Ptr<const Packet>, Ptr<const Face>) = 0;
 
   virtual void
   SatisfiedInterests (Ptr<const pit::Entry>) = 0;
@@ -129,10 +124,20 @@ protected:
   virtual void
   TimedOutInterests (Ptr<const pit::Entry>) = 0;
 
+  /**
+   * @brief Get ID of the face description in the dictionary of the binary trace
+   *
+   * Description of every face is formatted only once
+   */
+  uint32_t
+  GetFaceDescrId (BinaryTraceWriter &writer, Ptr<const Face> face) const;
+
 protected:
   std::string m_node;
   Ptr<Node> m_nodePtr;
 
+  mutable std::map<Ptr<const Face>, uint32_t> m_faceDescrIds; ///< @brief cached IDs of face descriptions in binary trace
+
   struct Stats
   {
     inline void Reset ()
@@ -149,18 +154,12 @@ protected:
       m_satisfiedInterests = 0;
       m_timedOutInterests = 0;
       // JRO
-      m_InInterestsPriority[0] = 0;
-      m_InInterestsPriority[1] = 0;
-      m_InInterestsPriority[2] = 0;
-      m_InInterestsPriority[3] = 0;
-      m_OutInterestsPriority[0] = 0;
-      m_OutInterestsPriority[1] = 0;
-      m_OutInterestsPriority[2] = 0;
-      m_OutInterestsPriority[3] = 0;
-      m_DropInterestsPriority[0] = 0;
-      m_DropInterestsPriority[1] = 0;
-      m_DropInterestsPriority[2] = 0;
-      m_DropInterestsPriority[3] = 0;
+      for (uint8_t priority = 0; priority < Interest::MAX_PRIORITY_TYPES; priority++)
+        {
+          m_InInterestsPriority[priority] = 0;
+          m_OutInterestsPriority[priority] = 0;
+          m_DropInterestsPriority[priority] = 0;
+        }
     }
 
     double m_inInterests;
@@ -175,9 +174,9 @@ protected:
     double m_satisfiedInterests;
     double m_timedOutInterests;
     // JRO
-    double m_InInterestsPriority[4];
-    double m_OutInterestsPriority[4];
-    double m_DropInterestsPriority[4];
+    double m_InInterestsPriority[Interest::MAX_PRIORITY_TYPES];
+    double m_OutInterestsPriority[Interest::MAX_PRIORITY_TYPES];
+    double m_DropInterestsPriority[Interest::MAX_PRIORITY_TYPES];
   };
 };
 
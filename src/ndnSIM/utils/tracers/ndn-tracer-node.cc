@@ -0,0 +1,55 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ndn-tracer-node.h"
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/names.h"
+#include "ns3/fatal-error.h"
+
+#include <boost/lexical_cast.hpp>
+
+namespace ns3 {
+namespace ndn {
+
+Ptr<Node>
+FindTracedNode (const std::string &node)
+{
+  Ptr<Node> nodePtr = Names::Find<Node> (node);
+  if (nodePtr != 0)
+    return nodePtr;
+
+  uint32_t id = 0;
+  try
+    {
+      id = boost::lexical_cast<uint32_t> (node);
+    }
+  catch (boost::bad_lexical_cast &)
+    {
+      NS_FATAL_ERROR ("Node [" << node << "] does not exist");
+    }
+
+  if (id >= NodeList::GetNNodes ())
+    {
+      NS_FATAL_ERROR ("Node [" << node << "] does not exist");
+    }
+
+  return NodeList::GetNode (id);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,42 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NDN_TRACER_NODE_H
+#define NDN_TRACER_NODE_H
+
+#include "ns3/ptr.h"
+
+#include <string>
+
+namespace ns3 {
+
+class Node;
+
+namespace ndn {
+
+/**
+ * @brief Find the node to be traced
+ * @param node name of the node (see ns3::Names) or its id in ns3::NodeList
+ *
+ * Aborts the simulation if there is no such node
+ */
+Ptr<Node>
+FindTracedNode (const std::string &node);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_TRACER_NODE_H
@@ -0,0 +1,207 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef ARC_POLICY_H_
+#define ARC_POLICY_H_
+
+#include "detail/segmented-list.h"
+#include "detail/ghost-list.h"
+
+#include <boost/intrusive/options.hpp>
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+
+/**
+ * @brief Traits for Adaptive Replacement Cache (ARC) policy
+ *
+ * Resident items are split into T1 (seen once recently) and T2 (seen at least twice), both
+ * LRU.  Ghost lists B1 and B2 remember hashes of items recently evicted from T1 and T2.  A
+ * hit in a ghost list adapts the target size of T1, balancing recency and frequency
+ * (Megiddo and Modha, FAST 2003).
+ */
+struct arc_policy_traits
+{
+  /// @brief Name that can be used to identify the policy (for NS-3 object model and logging)
+  static std::string GetName () { return "Arc"; }
+
+  typedef detail::segmented_list_hook policy_hook_type;
+
+  template<class Container>
+  struct container_hook
+  {
+    typedef boost::intrusive::member_hook< Container,
+                                           policy_hook_type,
+                                           &Container::policy_hook_ > type;
+  };
+
+  template<class Base,
+           class Container,
+           class Hook>
+  struct policy
+  {
+    typedef detail::segmented_list< Container, Hook > policy_container;
+
+    // could be just typedef
+    class type : public policy_container
+    {
+    public:
+      typedef Container parent_trie;
+
+      type (Base &base)
+        : base_ (base)
+        , max_size_ (100)
+        , p_ (0)
+      {
+      }
+
+      inline void
+      update (typename parent_trie::iterator item)
+      {
+        // do nothing
+      }
+
+      inline bool
+      insert (typename parent_trie::iterator item)
+      {
+        if (max_size_ == 0)
+          {
+            policy_container::push_cold (*item);
+            return true;
+          }
+
+        std::size_t hash = hash_value (*item);
+        if (b1_.erase (hash))
+          {
+            // recently evicted from T1: favour recency
+            p_ = std::min (max_size_, p_ + std::max<size_t> (b2_.size () / (b1_.size () + 1), 1));
+            if (policy_container::size () >= max_size_)
+              replace (false);
+            policy_container::push_hot (*item);
+          }
+        else if (b2_.erase (hash))
+          {
+            // recently evicted from T2: favour frequency
+            size_t delta = std::max<size_t> (b1_.size () / (b2_.size () + 1), 1);
+            p_ = p_ > delta ? p_ - delta : 0;
+            if (policy_container::size () >= max_size_)
+              replace (true);
+            policy_container::push_hot (*item);
+          }
+        else
+          {
+            size_t t1 = policy_container::cold_size ();
+            if (t1 + b1_.size () >= max_size_)
+              {
+                if (t1 < max_size_)
+                  {
+                    b1_.pop_front ();
+                    if (policy_container::size () >= max_size_)
+                      replace (false);
+                  }
+                else
+                  base_.erase (&policy_container::cold_front ());
+              }
+            else if (policy_container::size () + b1_.size () + b2_.size () >= max_size_)
+              {
+                if (policy_container::size () + b1_.size () + b2_.size () >= 2 * max_size_)
+                  b2_.pop_front ();
+                if (policy_container::size () >= max_size_)
+                  replace (false);
+              }
+            policy_container::push_cold (*item);
+          }
+        return true;
+      }
+
+      inline void
+      lookup (typename parent_trie::iterator item)
+      {
+        // hit in T1 or T2 moves item to the MRU position of T2
+        policy_container::touch_hot (*item);
+      }
+
+      inline void
+      erase (typename parent_trie::iterator item)
+      {
+        policy_container::remove (*item);
+      }
+
+      inline void
+      clear ()
+      {
+        policy_container::clear ();
+        b1_.clear ();
+        b2_.clear ();
+        p_ = 0;
+      }
+
+      inline void
+      set_max_size (size_t max_size)
+      {
+        max_size_ = max_size;
+        p_ = std::min (p_, max_size_);
+      }
+
+      inline size_t
+      get_max_size () const
+      {
+        return max_size_;
+      }
+
+    private:
+      type () : base_(*((Base*)0)) { };
+
+      /**
+       * @brief Evict LRU item of T1 or T2 (depending on the target size of T1) into a ghost list
+       */
+      void
+      replace (bool inB2)
+      {
+        size_t t1 = policy_container::cold_size ();
+        if (t1 > 0 &&
+            (t1 > p_ || (inB2 && t1 == p_) || policy_container::hot_size () == 0))
+          {
+            Container &victim = policy_container::cold_front ();
+            b1_.push_back (hash_value (victim));
+            base_.erase (&victim);
+          }
+        else
+          {
+            Container &victim = policy_container::hot_front ();
+            b2_.push_back (hash_value (victim));
+            base_.erase (&victim);
+          }
+      }
+
+    private:
+      Base &base_;
+      size_t max_size_;
+      size_t p_;                 ///< @brief target size of T1
+      detail::ghost_list b1_;    ///< @brief ghosts of items evicted from T1
+      detail::ghost_list b2_;    ///< @brief ghosts of items evicted from T2
+    };
+  };
+};
+
+} // ndnSIM
+} // ndn
+} // ns3
+
+#endif // ARC_POLICY_H_
@@ -0,0 +1,135 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef TRIE_FREQUENCY_SKETCH_H_
+#define TRIE_FREQUENCY_SKETCH_H_
+
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+namespace detail {
+
+/**
+ * @brief Count-min sketch of 4-bit counters that estimates how often a key was seen
+ *
+ * Four counters per key, sixteen counters packed into each 64-bit word.  When the number of
+ * recorded events reaches ten times the expected number of distinct keys, all counters are
+ * halved, so the sketch tracks recent popularity (TinyLFU "reset" operation).
+ */
+class frequency_sketch
+{
+public:
+  frequency_sketch (std::size_t expectedKeys = 100)
+  {
+    resize (expectedKeys);
+  }
+
+  /**
+   * @brief Reset the sketch and size it for the expected number of distinct keys
+   */
+  void
+  resize (std::size_t expectedKeys)
+  {
+    std::size_t width = 16;
+    while (width < expectedKeys)
+      width <<= 1;
+
+    mask_ = width - 1;
+    table_.assign (ROWS * width / COUNTERS_PER_WORD, 0);
+    sampleSize_ = 10 * (expectedKeys > 0 ? expectedKeys : width);
+    additions_ = 0;
+  }
+
+  /**
+   * @brief Record one occurrence of the key
+   */
+  void
+  increment (std::size_t hash)
+  {
+    bool added = false;
+    for (int row = 0; row < ROWS; row++)
+      {
+        std::size_t index = counter_index (row, hash);
+        uint64_t &word = table_[index / COUNTERS_PER_WORD];
+        int shift = (index % COUNTERS_PER_WORD) * 4;
+        if (((word >> shift) & 0xF) < 0xF)
+          {
+            word += static_cast<uint64_t> (1) << shift;
+            added = true;
+          }
+      }
+
+    if (added && ++additions_ >= sampleSize_)
+      halve ();
+  }
+
+  /**
+   * @brief Estimated number of occurrences of the key (saturates at 15)
+   */
+  uint32_t
+  estimate (std::size_t hash) const
+  {
+    uint32_t frequency = 0xF;
+    for (int row = 0; row < ROWS; row++)
+      {
+        std::size_t index = counter_index (row, hash);
+        uint32_t counter = (table_[index / COUNTERS_PER_WORD] >> ((index % COUNTERS_PER_WORD) * 4)) & 0xF;
+        if (counter < frequency)
+          frequency = counter;
+      }
+    return frequency;
+  }
+
+private:
+  static const int ROWS = 4;
+  static const std::size_t COUNTERS_PER_WORD = 16;
+
+  std::size_t
+  counter_index (int row, std::size_t hash) const
+  {
+    static const uint64_t seeds[ROWS] = { 0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+                                          0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL };
+    uint64_t h = (static_cast<uint64_t> (hash) + seeds[row]) * seeds[(row + 1) % ROWS];
+    h ^= h >> 32;
+    return row * (mask_ + 1) + (static_cast<std::size_t> (h) & mask_);
+  }
+
+  void
+  halve ()
+  {
+    for (std::vector<uint64_t>::iterator word = table_.begin (); word != table_.end (); word++)
+      *word = (*word >> 1) & 0x7777777777777777ULL;
+    additions_ /= 2;
+  }
+
+private:
+  std::vector<uint64_t> table_;
+  std::size_t mask_;
+  std::size_t sampleSize_;
+  std::size_t additions_;
+};
+
+} // detail
+} // ndnSIM
+} // ndn
+} // ns3
+
+#endif // TRIE_FREQUENCY_SKETCH_H_
@@ -0,0 +1,104 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef TRIE_GHOST_LIST_H_
+#define TRIE_GHOST_LIST_H_
+
+#include <boost/unordered_map.hpp>
+#include <cstddef>
+#include <list>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+namespace detail {
+
+/**
+ * @brief Ordered list of hashes of recently evicted items (ghost entries of 2Q and ARC)
+ *
+ * Only hashes of the keys are kept, so a ghost entry costs a few words regardless of the
+ * size of the evicted item.  Membership test and removal are O(1).
+ */
+class ghost_list
+{
+public:
+  bool
+  contains (std::size_t hash) const
+  {
+    return index_.find (hash) != index_.end ();
+  }
+
+  /**
+   * @brief Add hash as the most recent entry (moved to the back if already present)
+   */
+  void
+  push_back (std::size_t hash)
+  {
+    erase (hash);
+    index_[hash] = order_.insert (order_.end (), hash);
+  }
+
+  /**
+   * @brief Remove the oldest entry
+   */
+  void
+  pop_front ()
+  {
+    if (order_.empty ())
+      return;
+    index_.erase (order_.front ());
+    order_.pop_front ();
+  }
+
+  bool
+  erase (std::size_t hash)
+  {
+    index_type::iterator item = index_.find (hash);
+    if (item == index_.end ())
+      return false;
+
+    order_.erase (item->second);
+    index_.erase (item);
+    return true;
+  }
+
+  std::size_t
+  size () const
+  {
+    return index_.size ();
+  }
+
+  void
+  clear ()
+  {
+    index_.clear ();
+    order_.clear ();
+  }
+
+private:
+  typedef boost::unordered_map<std::size_t, std::list<std::size_t>::iterator> index_type;
+
+  std::list<std::size_t> order_;
+  index_type index_;
+};
+
+} // detail
+} // ndnSIM
+} // ndn
+} // ns3
+
+#endif // TRIE_GHOST_LIST_H_
@@ -0,0 +1,164 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef TRIE_SEGMENTED_LIST_H_
+#define TRIE_SEGMENTED_LIST_H_
+
+#include <boost/intrusive/list.hpp>
+#include <cstddef>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+namespace detail {
+
+/**
+ * @brief Hook of items stored in segmented_list
+ */
+struct segmented_list_hook : public boost::intrusive::list_member_hook<>
+{
+  bool hot; ///< @brief true if the item is in the hot segment
+};
+
+/**
+ * @brief Intrusive list split into a "cold" segment (front) and a "hot" segment (back)
+ *
+ * Used by policies that keep two resident queues (2Q, ARC).  Both queues share one list,
+ * so the policy can still be iterated from begin () to end () and size () counts all items.
+ * New cold items are placed at the end of the cold segment, hot items at the end of the list.
+ */
+template<class Container, class Hook>
+class segmented_list : public boost::intrusive::list< Container, Hook >
+{
+public:
+  typedef boost::intrusive::list< Container, Hook > base_type;
+  typedef typename base_type::iterator iterator;
+
+  segmented_list ()
+    : hot_begin_ (base_type::end ())
+    , cold_size_ (0)
+  {
+  }
+
+  static bool &
+  is_hot (Container &item)
+  {
+    return static_cast<segmented_list_hook*> (base_type::value_traits::to_node_ptr (item))->hot;
+  }
+
+  std::size_t
+  cold_size () const
+  {
+    return cold_size_;
+  }
+
+  std::size_t
+  hot_size () const
+  {
+    return base_type::size () - cold_size_;
+  }
+
+  /**
+   * @brief Least recently added cold item
+   */
+  Container &
+  cold_front ()
+  {
+    return base_type::front ();
+  }
+
+  /**
+   * @brief Least recently used hot item
+   */
+  Container &
+  hot_front ()
+  {
+    return *hot_begin_;
+  }
+
+  void
+  push_cold (Container &item)
+  {
+    base_type::insert (hot_begin_, item);
+    is_hot (item) = false;
+    cold_size_ ++;
+  }
+
+  void
+  push_hot (Container &item)
+  {
+    base_type::push_back (item);
+    is_hot (item) = true;
+    if (hot_begin_ == base_type::end ())
+      hot_begin_ = base_type::s_iterator_to (item);
+  }
+
+  /**
+   * @brief Move item (cold or hot) to the most recently used position of the hot segment
+   */
+  void
+  touch_hot (Container &item)
+  {
+    iterator position = base_type::s_iterator_to (item);
+    if (is_hot (item))
+      {
+        if (position == hot_begin_)
+          hot_begin_ ++;
+      }
+    else
+      cold_size_ --;
+
+    base_type::splice (base_type::end (), *this, position);
+    is_hot (item) = true;
+    if (hot_begin_ == base_type::end ())
+      hot_begin_ = position;
+  }
+
+  void
+  remove (Container &item)
+  {
+    iterator position = base_type::s_iterator_to (item);
+    if (position == hot_begin_)
+      hot_begin_ ++;
+    if (!is_hot (item))
+      cold_size_ --;
+    base_type::erase (position);
+  }
+
+  void
+  clear ()
+  {
+    base_type::clear ();
+    hot_begin_ = base_type::end ();
+    cold_size_ = 0;
+  }
+
+private:
+  segmented_list (const segmented_list &);
+  segmented_list &operator= (const segmented_list &);
+
+private:
+  iterator hot_begin_; ///< @brief first item of the hot segment, or end ()
+  std::size_t cold_size_;
+};
+
+} // detail
+} // ndnSIM
+} // ndn
+} // ns3
+
+#endif // TRIE_SEGMENTED_LIST_H_
@@ -21,22 +21,48 @@
 #ifndef LFU_POLICY_H_
 #define LFU_POLICY_H_
 
+#include "node-allocator.h"
+
 #include <boost/intrusive/options.hpp>
-#include <boost/intrusive/set.hpp>
+#include <boost/intrusive/list.hpp>
+#include <boost/cstdint.hpp>
 
 namespace ns3 {
 namespace ndn {
 namespace ndnSIM {
 
+namespace detail {
+
 /**
- * @brief Traits for LFU replacement policy
+ * @brief Group of LFU policy items that have the same frequency
+ *
+ * Items of the policy are kept in one list ordered by frequency.  Buckets form a
+ * separate list ordered the same way and point to the first item of their group.
  */
-struct lfu_policy_traits
+struct lfu_bucket
 {
-  /// @brief Name that can be used to identify the policy (for NS-3 object model and logging)
-  static std::string GetName () { return "Lfu"; }
+  uint64_t frequency;
+  std::size_t count;
+  void *first;
+  lfu_bucket *prev;
+  lfu_bucket *next;
+};
 
-  struct policy_hook_type : public boost::intrusive::set_member_hook<> { double frequency; };
+/**
+ * @brief Implementation of constant-time LFU replacement policies
+ *
+ * Every lookup moves item from its frequency bucket to the next one and eviction takes the
+ * first item of the lowest frequency bucket, all in O(1).  Items with the same frequency
+ * are evicted in the order they reached that frequency.
+ *
+ * @tparam Aging if true, new items start with frequency of the last evicted item rather
+ *         than with zero (LFU with dynamic aging), so items that were popular long ago do
+ *         not stay in the cache forever
+ */
+template<bool Aging>
+struct lfu_policy_traits_base
+{
+  struct policy_hook_type : public boost::intrusive::list_member_hook<> { lfu_bucket *bucket; };
 
   template<class Container>
   struct container_hook
@@ -51,31 +77,24 @@ struct lfu_policy_traits
            class Hook>
   struct policy
   {
-    static double& get_order (typename Container::iterator item)
+    typedef typename boost::intrusive::list< Container, Hook > policy_container;
+
+    static lfu_bucket *&
+    get_bucket (typename Container::const_iterator item)
     {
       return static_cast<policy_hook_type*>
-        (policy_container::value_traits::to_node_ptr(*item))->frequency;
+        (policy_container::value_traits::to_node_ptr(const_cast<Container&> (*item)))->bucket;
     }
 
-    static const double& get_order (typename Container::const_iterator item)
+    /**
+     * @brief Get current frequency of the item
+     */
+    static uint64_t
+    get_order (typename Container::const_iterator item)
     {
-      return static_cast<const policy_hook_type*>
-        (policy_container::value_traits::to_node_ptr(*item))->frequency;
+      return get_bucket (item)->frequency;
     }
 
-    template<class Key>
-    struct MemberHookLess
-    {
-      bool operator () (const Key &a, const Key &b) const
-      {
-        return get_order (&a) < get_order (&b);
-      }
-    };
-
-    typedef boost::intrusive::multiset< Container,
-                                   boost::intrusive::compare< MemberHookLess< Container > >,
-                                   Hook > policy_container;
-
     // could be just typedef
     class type : public policy_container
     {
@@ -86,50 +105,62 @@ struct lfu_policy_traits
       type (Base &base)
         : base_ (base)
         , max_size_ (100)
+        , age_ (0)
+        , head_ (0)
+        , buckets_ (sizeof (lfu_bucket))
+      {
+      }
+
+      ~type ()
       {
+        policy_container::clear ();
       }
 
       inline void
       update (typename parent_trie::iterator item)
       {
-        policy_container::erase (policy_container::s_iterator_to (*item));
-        get_order (item) += 1;
-        policy_container::insert (*item);
+        promote (item);
       }
 
       inline bool
       insert (typename parent_trie::iterator item)
       {
-        get_order (item) = 0;
-
         if (max_size_ != 0 && policy_container::size () >= max_size_)
           {
             // this erases the "least frequently used item" from cache
+            if (Aging)
+              age_ = head_->frequency;
             base_.erase (&(*policy_container::begin ()));
           }
 
-        policy_container::insert (*item);
+        uint64_t frequency = Aging ? age_ : 0;
+        NS_ASSERT (head_ == 0 || head_->frequency >= frequency);
+
+        if (head_ != 0 && head_->frequency == frequency)
+          link (item, head_);
+        else
+          link (item, new_bucket (frequency, 0, head_));
         return true;
       }
 
       inline void
       lookup (typename parent_trie::iterator item)
       {
-        policy_container::erase (policy_container::s_iterator_to (*item));
-        get_order (item) += 1;
-        policy_container::insert (*item);
+        promote (item);
       }
 
       inline void
       erase (typename parent_trie::iterator item)
       {
-        policy_container::erase (policy_container::s_iterator_to (*item));
+        unlink (item);
       }
 
       inline void
       clear ()
       {
         policy_container::clear ();
+        while (head_ != 0)
+          free_bucket (head_);
       }
 
       inline void
@@ -145,15 +176,124 @@ struct lfu_policy_traits
       }
 
     private:
-      type () : base_(*((Base*)0)) { };
+      type () : base_(*((Base*)0)), buckets_ (sizeof (lfu_bucket)) { };
+
+      /**
+       * @brief Move item to the bucket with the next frequency
+       */
+      void
+      promote (typename parent_trie::iterator item)
+      {
+        lfu_bucket *bucket = get_bucket (item);
+        uint64_t frequency = bucket->frequency + 1;
+        lfu_bucket *next = bucket->next;
+        lfu_bucket *prev = bucket->count > 1 ? bucket : bucket->prev; // bucket disappears with its last item
+
+        unlink (item);
+        if (next != 0 && next->frequency == frequency)
+          link (item, next);
+        else
+          link (item, new_bucket (frequency, prev, next));
+      }
+
+      /**
+       * @brief Put item at the end of the bucket's group
+       */
+      void
+      link (typename parent_trie::iterator item, lfu_bucket *bucket)
+      {
+        typename policy_container::iterator position = policy_container::end ();
+        if (bucket->next != 0)
+          position = policy_container::s_iterator_to (*static_cast<Container*> (bucket->next->first));
+
+        policy_container::insert (position, *item);
+        get_bucket (item) = bucket;
+        if (bucket->count == 0)
+          bucket->first = &(*item);
+        bucket->count ++;
+      }
+
+      void
+      unlink (typename parent_trie::iterator item)
+      {
+        lfu_bucket *bucket = get_bucket (item);
+        typename policy_container::iterator position = policy_container::s_iterator_to (*item);
+
+        bucket->count --;
+        if (bucket->count == 0)
+          free_bucket (bucket);
+        else if (bucket->first == &(*item))
+          {
+            typename policy_container::iterator next = position;
+            next ++;
+            bucket->first = &(*next);
+          }
+
+        policy_container::erase (position);
+      }
+
+      lfu_bucket *
+      new_bucket (uint64_t frequency, lfu_bucket *prev, lfu_bucket *next)
+      {
+        lfu_bucket *bucket = static_cast<lfu_bucket*> (buckets_.allocate ());
+        bucket->frequency = frequency;
+        bucket->count = 0;
+        bucket->first = 0;
+        bucket->prev = prev;
+        bucket->next = next;
+
+        if (prev != 0)
+          prev->next = bucket;
+        else
+          head_ = bucket;
+        if (next != 0)
+          next->prev = bucket;
+        return bucket;
+      }
+
+      void
+      free_bucket (lfu_bucket *bucket)
+      {
+        if (bucket->prev != 0)
+          bucket->prev->next = bucket->next;
+        else
+          head_ = bucket->next;
+        if (bucket->next != 0)
+          bucket->next->prev = bucket->prev;
+
+        buckets_.deallocate (bucket);
+      }
 
     private:
       Base &base_;
       size_t max_size_;
+      uint64_t age_;        ///< @brief frequency of the last evicted item (only with aging)
+      lfu_bucket *head_;    ///< @brief bucket with the lowest frequency
+      pool_allocator buckets_;
     };
   };
 };
 
+} // detail
+
+/**
+ * @brief Traits for LFU replacement policy
+ */
+struct lfu_policy_traits : public detail::lfu_policy_traits_base<false>
+{
+  /// @brief Name that can be used to identify the policy (for NS-3 object model and logging)
+  static std::string GetName () { return "Lfu"; }
+};
+
+/**
+ * @brief Traits for LFU replacement policy with dynamic aging (LFU-DA)
+ */
+struct lfu_aging_policy_traits : public detail::lfu_policy_traits_base<true>
+{
+  /// @brief Name that can be used to identify the policy (for NS-3 object model and logging)
+  static std::string GetName () { return "LfuAging"; }
+};
+
 } // ndnSIM
 } // ndn
 } // ns3
@@ -0,0 +1,173 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NODE_ALLOCATOR_H_
+#define NODE_ALLOCATOR_H_
+
+#include "ns3/assert.h"
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+
+/**
+ * @brief Allocator of trie nodes that recycles freed nodes through a free list
+ *
+ * Nodes are carved out of chunks of blocksPerChunk nodes, chunks are returned to the
+ * system only when the allocator is destroyed.  Each trie (PIT, FIB, CS) owns its own pool.
+ */
+class pool_allocator
+{
+public:
+  pool_allocator (std::size_t blockSize, std::size_t blocksPerChunk = 256)
+    : blockSize_ (blockSize < sizeof (free_block) ? sizeof (free_block) : blockSize)
+    , blocksPerChunk_ (blocksPerChunk)
+    , freeList_ (0)
+    , allocated_ (0)
+  {
+    NS_ASSERT (blocksPerChunk_ > 0);
+  }
+
+  ~pool_allocator ()
+  {
+    for (std::vector<char*>::iterator chunk = chunks_.begin (); chunk != chunks_.end (); chunk++)
+      ::operator delete (*chunk);
+  }
+
+  void *
+  allocate ()
+  {
+    if (freeList_ == 0)
+      allocate_chunk ();
+
+    free_block *block = freeList_;
+    freeList_ = block->next;
+    allocated_ ++;
+    return block;
+  }
+
+  void
+  deallocate (void *node)
+  {
+    NS_ASSERT (allocated_ > 0);
+
+    free_block *block = static_cast<free_block*> (node);
+    block->next = freeList_;
+    freeList_ = block;
+    allocated_ --;
+  }
+
+  /**
+   * @brief Number of nodes currently in use
+   */
+  std::size_t
+  allocated () const
+  {
+    return allocated_;
+  }
+
+  /**
+   * @brief Number of nodes that can be used without requesting memory from the system
+   */
+  std::size_t
+  capacity () const
+  {
+    return chunks_.size () * blocksPerChunk_;
+  }
+
+private:
+  pool_allocator (const pool_allocator &);
+  pool_allocator &operator= (const pool_allocator &);
+
+  struct free_block
+  {
+    free_block *next;
+  };
+
+  void
+  allocate_chunk ()
+  {
+    char *chunk = static_cast<char*> (::operator new (blockSize_ * blocksPerChunk_));
+    chunks_.push_back (chunk);
+
+    // thread blocks of the chunk in the free list, first block will be allocated first
+    for (std::size_t i = blocksPerChunk_; i > 0; i--)
+      {
+        free_block *block = reinterpret_cast<free_block*> (chunk + (i - 1) * blockSize_);
+        block->next = freeList_;
+        freeList_ = block;
+      }
+  }
+
+private:
+  std::size_t blockSize_;
+  std::size_t blocksPerChunk_;
+  free_block *freeList_;
+  std::size_t allocated_;
+  std::vector<char*> chunks_;
+};
+
+/**
+ * @brief Allocator of trie nodes that uses global operator new/delete for every node
+ */
+class heap_allocator
+{
+public:
+  heap_allocator (std::size_t blockSize)
+    : blockSize_ (blockSize)
+    , allocated_ (0)
+  {
+  }
+
+  void *
+  allocate ()
+  {
+    allocated_ ++;
+    return ::operator new (blockSize_);
+  }
+
+  void
+  deallocate (void *node)
+  {
+    NS_ASSERT (allocated_ > 0);
+    allocated_ --;
+    ::operator delete (node);
+  }
+
+  std::size_t
+  allocated () const
+  {
+    return allocated_;
+  }
+
+private:
+  heap_allocator (const heap_allocator &);
+  heap_allocator &operator= (const heap_allocator &);
+
+private:
+  std::size_t blockSize_;
+  std::size_t allocated_;
+};
+
+} // ndnSIM
+} // ndn
+} // ns3
+
+#endif // NODE_ALLOCATOR_H_
@@ -29,20 +29,22 @@ namespace ndnSIM {
 
 template<typename FullKey,
          typename PayloadTraits,
-         typename PolicyTraits
+         typename PolicyTraits,
+         typename Allocator = pool_allocator
          >
 class trie_with_policy
 {
 public:
   typedef trie< FullKey,
                 PayloadTraits,
-                typename PolicyTraits::policy_hook_type > parent_trie;
+                typename PolicyTraits::policy_hook_type,
+                Allocator > parent_trie;
 
   typedef typename parent_trie::iterator iterator;
   typedef typename parent_trie::const_iterator const_iterator;
 
   typedef typename PolicyTraits::template policy<
-    trie_with_policy<FullKey, PayloadTraits, PolicyTraits>,
+    trie_with_policy<FullKey, PayloadTraits, PolicyTraits, Allocator>,
     parent_trie,
     typename PolicyTraits::template container_hook<parent_trie>::type >::type policy_container;
 
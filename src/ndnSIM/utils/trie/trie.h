@@ -22,6 +22,7 @@
 #define TRIE_H_
 
 #include "ns3/ptr.h"
+#include "node-allocator.h"
 
 #include <boost/intrusive/unordered_set.hpp>
 #include <boost/intrusive/list.hpp>
@@ -105,22 +106,23 @@ non_pointer_traits<Payload, BasePayload>::empty_payload = Payload ();
 //
 template<typename FullKey,
          typename PayloadTraits,
-         typename PolicyHook >
+         typename PolicyHook,
+         typename Allocator = pool_allocator >
 class trie;
 
-template<typename FullKey, typename PayloadTraits, typename PolicyHook>
+template<typename FullKey, typename PayloadTraits, typename PolicyHook, typename Allocator>
 inline std::ostream&
 operator << (std::ostream &os,
-             const trie<FullKey, PayloadTraits, PolicyHook> &trie_node);
+             const trie<FullKey, PayloadTraits, PolicyHook, Allocator> &trie_node);
 
-template<typename FullKey, typename PayloadTraits, typename PolicyHook>
+template<typename FullKey, typename PayloadTraits, typename PolicyHook, typename Allocator>
 bool
-operator== (const trie<FullKey, PayloadTraits, PolicyHook> &a,
-            const trie<FullKey, PayloadTraits, PolicyHook> &b);
+operator== (const trie<FullKey, PayloadTraits, PolicyHook, Allocator> &a,
+            const trie<FullKey, PayloadTraits, PolicyHook, Allocator> &b);
 
-template<typename FullKey, typename PayloadTraits, typename PolicyHook >
+template<typename FullKey, typename PayloadTraits, typename PolicyHook, typename Allocator>
 std::size_t
-hash_value (const trie<FullKey, PayloadTraits, PolicyHook> &trie_node);
+hash_value (const trie<FullKey, PayloadTraits, PolicyHook, Allocator> &trie_node);
 
 ///////////////////////////////////////////////////
 // actual definition
@@ -131,9 +133,17 @@ class trie_iterator;
 template<class T>
 class trie_point_iterator;
 
+/**
+ * @brief Trie of names
+ *
+ * Nodes are allocated from an allocator owned by the root node (pool_allocator by default,
+ * so every trie has its own pool of recycled nodes).  Each node keeps a few inline hash buckets
+ * for its children, so leaves and small nodes do not allocate separate bucket arrays.
+ */
 template<typename FullKey,
 	 typename PayloadTraits,
-         typename PolicyHook >
+         typename PolicyHook,
+         typename Allocator >
 class trie
 {
 public:
@@ -149,18 +159,31 @@ public:
   typedef trie_point_iterator<const trie> const_point_iterator;
 
   typedef PayloadTraits payload_traits;
+  typedef Allocator allocator_type;
 
+  /**
+   * @brief Constructor
+   * @param key key of the node
+   * @param bucketSize size of the first bucket array allocated when children do not fit inline buckets
+   * @param bucketIncrement initial increment of the bucket array size
+   * @param allocator allocator for child nodes; if 0, the node creates its own allocator (root node)
+   */
   inline
-  trie (const Key &key, size_t bucketSize = 10, size_t bucketIncrement = 10)
+  trie (const Key &key, size_t bucketSize = 10, size_t bucketIncrement = 10, Allocator *allocator = 0)
     : key_ (key)
     , initialBucketSize_ (bucketSize)
     , bucketIncrement_ (bucketIncrement)
-    , bucketSize_ (initialBucketSize_)
-    , buckets_ (new bucket_type [bucketSize_]) //cannot use normal pointer, because lifetime of buckets should be larger than lifetime of the container
-    , children_ (bucket_traits (buckets_.get (), bucketSize_))
+    , bucketSize_ (INLINE_BUCKETS)
+    , children_ (bucket_traits (inlineBuckets_, INLINE_BUCKETS))
     , payload_ (PayloadTraits::empty_payload)
     , parent_ (0)
+    , allocator_ (allocator)
   {
+    if (allocator_ == 0)
+      {
+        ownAllocator_.reset (new Allocator (sizeof (trie)));
+        allocator_ = ownAllocator_.get ();
+      }
   }
 
   inline
@@ -176,6 +199,15 @@ public:
     children_.clear_and_dispose (trie_delete_disposer ());
   }
 
+  /**
+   * @brief Get allocator of the trie nodes
+   */
+  const Allocator &
+  allocator () const
+  {
+    return *allocator_;
+  }
+
   template<class Predicate>
   void
   clear_if (Predicate cond)
@@ -195,11 +227,11 @@ public:
 
   // actual entry
   friend bool
-  operator== <> (const trie<FullKey, PayloadTraits, PolicyHook> &a,
-                 const trie<FullKey, PayloadTraits, PolicyHook> &b);
+  operator== <> (const trie<FullKey, PayloadTraits, PolicyHook, Allocator> &a,
+                 const trie<FullKey, PayloadTraits, PolicyHook, Allocator> &b);
 
   friend std::size_t
-  hash_value <> (const trie<FullKey, PayloadTraits, PolicyHook> &trie_node);
+  hash_value <> (const trie<FullKey, PayloadTraits, PolicyHook, Allocator> &trie_node);
 
   inline std::pair<iterator, bool>
   insert (const FullKey &key,
@@ -207,23 +239,20 @@ public:
   {
     trie *trieNode = this;
 
-    BOOST_FOREACH (const Key &subkey, key)
+    for (typename FullKey::const_iterator subkey = key.begin ();
+         subkey != key.end ();
+         subkey++)
       {
-        typename unordered_set::iterator item = trieNode->children_.find (subkey);
+        typename unordered_set::iterator item = trieNode->children_.find (*subkey, subkey_hash (), subkey_equal ());
         if (item == trieNode->children_.end ())
           {
-            trie *newNode = new trie (subkey, initialBucketSize_, bucketIncrement_);
+            trie *newNode = new (allocator_->allocate ()) trie (Key (*subkey), initialBucketSize_, bucketIncrement_, allocator_);
             // std::cout << "new " << newNode << "\n";
             newNode->parent_ = trieNode;
 
             if (trieNode->children_.size () >= trieNode->bucketSize_)
               {
-                trieNode->bucketSize_ += trieNode->bucketIncrement_;
-                trieNode->bucketIncrement_ *= 2; // increase bucketIncrement exponentially
-
-                buckets_array newBuckets (new bucket_type [trieNode->bucketSize_]);
-                trieNode->children_.rehash (bucket_traits (newBuckets.get (), trieNode->bucketSize_));
-                trieNode->buckets_.swap (newBuckets);
+                trieNode->grow_buckets ();
               }
 
             std::pair< typename unordered_set::iterator, bool > ret =
@@ -308,9 +337,11 @@ public:
     iterator foundNode = (payload_ != PayloadTraits::empty_payload) ? this : 0;
     bool reachLast = true;
 
-    BOOST_FOREACH (const Key &subkey, key)
+    for (typename FullKey::const_iterator subkey = key.begin ();
+         subkey != key.end ();
+         subkey++)
       {
-        typename unordered_set::iterator item = trieNode->children_.find (subkey);
+        typename unordered_set::iterator item = trieNode->children_.find (*subkey, subkey_hash (), subkey_equal ());
         if (item == trieNode->children_.end ())
           {
             reachLast = false;
@@ -342,9 +373,11 @@ public:
     iterator foundNode = (payload_ != PayloadTraits::empty_payload) ? this : 0;
     bool reachLast = true;
 
-    BOOST_FOREACH (const Key &subkey, key)
+    for (typename FullKey::const_iterator subkey = key.begin ();
+         subkey != key.end ();
+         subkey++)
       {
-        typename unordered_set::iterator item = trieNode->children_.find (subkey);
+        typename unordered_set::iterator item = trieNode->children_.find (*subkey, subkey_hash (), subkey_equal ());
         if (item == trieNode->children_.end ())
           {
             reachLast = false;
@@ -375,7 +408,7 @@ public:
     if (payload_ != PayloadTraits::empty_payload)
       return this;
 
-    typedef trie<FullKey, PayloadTraits, PolicyHook> trie;
+    typedef trie<FullKey, PayloadTraits, PolicyHook, Allocator> trie;
     for (typename trie::unordered_set::iterator subnode = children_.begin ();
          subnode != children_.end ();
          subnode++ )
@@ -401,7 +434,7 @@ public:
     if (payload_ != PayloadTraits::empty_payload && pred (payload_))
       return this;
 
-    typedef trie<FullKey, PayloadTraits, PolicyHook> trie;
+    typedef trie<FullKey, PayloadTraits, PolicyHook, Allocator> trie;
     for (typename trie::unordered_set::iterator subnode = children_.begin ();
          subnode != children_.end ();
          subnode++ )
@@ -457,7 +490,55 @@ private:
   {
     void operator() (trie *delete_this)
     {
-      delete delete_this;
+      Allocator *allocator = delete_this->allocator_;
+      delete_this->~trie ();
+      allocator->deallocate (delete_this);
+    }
+  };
+
+  void
+  grow_buckets ()
+  {
+    if (buckets_.get () == 0) // children are in the inline buckets
+      {
+        if (initialBucketSize_ > bucketSize_)
+          bucketSize_ = initialBucketSize_;
+        else
+          bucketSize_ += bucketIncrement_;
+      }
+    else
+      {
+        bucketSize_ += bucketIncrement_;
+        bucketIncrement_ *= 2; // increase bucketIncrement exponentially
+      }
+
+    buckets_array newBuckets (new bucket_type [bucketSize_]);
+    children_.rehash (bucket_traits (newBuckets.get (), bucketSize_));
+    buckets_.swap (newBuckets);
+  }
+
+  // lookup of children using components of the full key, without constructing a temporary trie node
+  struct subkey_hash
+  {
+    template<class SubKey>
+    std::size_t operator() (const SubKey &subkey) const
+    {
+      return hash_value (subkey);
+    }
+  };
+
+  struct subkey_equal
+  {
+    template<class SubKey>
+    bool operator() (const SubKey &subkey, const trie &node) const
+    {
+      return subkey == node.key_;
+    }
+
+    template<class SubKey>
+    bool operator() (const trie &node, const SubKey &subkey) const
+    {
+      return subkey == node.key_;
     }
   };
 
@@ -470,6 +551,15 @@ private:
     }
   };
 
+  template<class D>
+  struct object_disposer
+  {
+    void operator() (D *object)
+    {
+      delete object;
+    }
+  };
+
   friend
   std::ostream&
   operator<< < > (std::ostream &os, const trie &trie_node);
@@ -505,24 +595,30 @@ private:
   size_t initialBucketSize_;
   size_t bucketIncrement_;
 
+  static const size_t INLINE_BUCKETS = 4; ///< buckets for the first children are stored inside the node
+
   size_t bucketSize_;
   typedef boost::interprocess::unique_ptr< bucket_type, array_disposer<bucket_type> > buckets_array;
-  buckets_array buckets_;
+  bucket_type inlineBuckets_[INLINE_BUCKETS];
+  buckets_array buckets_; // 0 while inline buckets are used
   unordered_set children_;
 
   typename PayloadTraits::storage_type payload_;
   trie *parent_; // to make cleaning effective
+
+  Allocator *allocator_;
+  boost::interprocess::unique_ptr< Allocator, object_disposer<Allocator> > ownAllocator_; // only in the root node
 };
 
 
 
 
-template<typename FullKey, typename PayloadTraits, typename PolicyHook>
+template<typename FullKey, typename PayloadTraits, typename PolicyHook, typename Allocator>
 inline std::ostream&
-operator << (std::ostream &os, const trie<FullKey, PayloadTraits, PolicyHook> &trie_node)
+operator << (std::ostream &os, const trie<FullKey, PayloadTraits, PolicyHook, Allocator> &trie_node)
 {
   os << "# " << trie_node.key_ << ((trie_node.payload_ != PayloadTraits::empty_payload)?"*":"") << std::endl;
-  typedef trie<FullKey, PayloadTraits, PolicyHook> trie;
+  typedef trie<FullKey, PayloadTraits, PolicyHook, Allocator> trie;
 
   for (typename trie::unordered_set::const_iterator subnode = trie_node.children_.begin ();
        subnode != trie_node.children_.end ();
@@ -539,9 +635,9 @@ operator << (std::ostream &os, const trie<FullKey, PayloadTraits, PolicyHook> &t
   return os;
 }
 
-template<typename FullKey, typename PayloadTraits, typename PolicyHook>
+template<typename FullKey, typename PayloadTraits, typename PolicyHook, typename Allocator>
 inline void
-trie<FullKey, PayloadTraits, PolicyHook>
+trie<FullKey, PayloadTraits, PolicyHook, Allocator>
 ::PrintStat (std::ostream &os) const
 {
   os << "# " << key_ << ((payload_ != PayloadTraits::empty_payload)?"*":"") << ": " << children_.size() << " children" << std::endl;
@@ -553,7 +649,7 @@ trie<FullKey, PayloadTraits, PolicyHook>
     }
   os << "\n";
 
-  typedef trie<FullKey, PayloadTraits, PolicyHook> trie;
+  typedef trie<FullKey, PayloadTraits, PolicyHook, Allocator> trie;
   for (typename trie::unordered_set::const_iterator subnode = children_.begin ();
        subnode != children_.end ();
        subnode++ )
@@ -564,19 +660,20 @@ trie<FullKey, PayloadTraits, PolicyHook>
 }
 
 
-template<typename FullKey, typename PayloadTraits, typename PolicyHook>
+template<typename FullKey, typename PayloadTraits, typename PolicyHook, typename Allocator>
 inline bool
-operator == (const trie<FullKey, PayloadTraits, PolicyHook> &a,
-             const trie<FullKey, PayloadTraits, PolicyHook> &b)
+operator == (const trie<FullKey, PayloadTraits, PolicyHook, Allocator> &a,
+             const trie<FullKey, PayloadTraits, PolicyHook, Allocator> &b)
 {
   return a.key_ == b.key_;
 }
 
-template<typename FullKey, typename PayloadTraits, typename PolicyHook>
+template<typename FullKey, typename PayloadTraits, typename PolicyHook, typename Allocator>
 inline std::size_t
-hash_value (const trie<FullKey, PayloadTraits, PolicyHook> &trie_node)
+hash_value (const trie<FullKey, PayloadTraits, PolicyHook, Allocator> &trie_node)
 {
-  return boost::hash_value (trie_node.key_);
+  using boost::hash_value;
+  return hash_value (trie_node.key_);
 }
 
 
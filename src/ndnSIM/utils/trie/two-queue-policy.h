@@ -0,0 +1,158 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef TWO_QUEUE_POLICY_H_
+#define TWO_QUEUE_POLICY_H_
+
+#include "detail/segmented-list.h"
+#include "detail/ghost-list.h"
+
+#include <boost/intrusive/options.hpp>
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+
+/**
+ * @brief Traits for 2Q replacement policy (full version with A1in, A1out and Am queues)
+ *
+ * New items go to the FIFO A1in queue (25% of the cache).  Items evicted from A1in are
+ * remembered in the A1out ghost queue (hashes only, 50% of the cache size).  Items that
+ * come back while remembered in A1out are placed into the LRU Am queue, so only items
+ * requested more than once compete for the main part of the cache.
+ */
+struct two_queue_policy_traits
+{
+  /// @brief Name that can be used to identify the policy (for NS-3 object model and logging)
+  static std::string GetName () { return "TwoQueue"; }
+
+  typedef detail::segmented_list_hook policy_hook_type;
+
+  template<class Container>
+  struct container_hook
+  {
+    typedef boost::intrusive::member_hook< Container,
+                                           policy_hook_type,
+                                           &Container::policy_hook_ > type;
+  };
+
+  template<class Base,
+           class Container,
+           class Hook>
+  struct policy
+  {
+    typedef detail::segmented_list< Container, Hook > policy_container;
+
+    // could be just typedef
+    class type : public policy_container
+    {
+    public:
+      typedef Container parent_trie;
+
+      type (Base &base)
+        : base_ (base)
+        , max_size_ (100)
+      {
+      }
+
+      inline void
+      update (typename parent_trie::iterator item)
+      {
+        // do nothing
+      }
+
+      inline bool
+      insert (typename parent_trie::iterator item)
+      {
+        if (max_size_ != 0 && policy_container::size () >= max_size_)
+          reclaim ();
+
+        if (a1out_.erase (hash_value (*item)))
+          policy_container::push_hot (*item);
+        else
+          policy_container::push_cold (*item);
+        return true;
+      }
+
+      inline void
+      lookup (typename parent_trie::iterator item)
+      {
+        // A1in is FIFO, only items in Am are relocated
+        if (policy_container::is_hot (*item))
+          policy_container::touch_hot (*item);
+      }
+
+      inline void
+      erase (typename parent_trie::iterator item)
+      {
+        policy_container::remove (*item);
+      }
+
+      inline void
+      clear ()
+      {
+        policy_container::clear ();
+        a1out_.clear ();
+      }
+
+      inline void
+      set_max_size (size_t max_size)
+      {
+        max_size_ = max_size;
+      }
+
+      inline size_t
+      get_max_size () const
+      {
+        return max_size_;
+      }
+
+    private:
+      type () : base_(*((Base*)0)) { };
+
+      void
+      reclaim ()
+      {
+        size_t kin = std::max<size_t> (max_size_ / 4, 1);
+        if (policy_container::cold_size () > 0 &&
+            (policy_container::cold_size () > kin || policy_container::hot_size () == 0))
+          {
+            Container &victim = policy_container::cold_front ();
+            a1out_.push_back (hash_value (victim));
+            if (a1out_.size () > std::max<size_t> (max_size_ / 2, 1))
+              a1out_.pop_front ();
+
+            base_.erase (&victim);
+          }
+        else
+          base_.erase (&policy_container::hot_front ());
+      }
+
+    private:
+      Base &base_;
+      size_t max_size_;
+      detail::ghost_list a1out_;
+    };
+  };
+};
+
+} // ndnSIM
+} // ndn
+} // ns3
+
+#endif // TWO_QUEUE_POLICY_H_
@@ -22,6 +22,10 @@
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#endif
 #include "packet-metadata.h"
 #include "buffer.h"
 #include "header.h"
@@ -38,6 +42,14 @@ uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
 PacketMetadata::DataFreeList PacketMetadata::m_freeList;
 
+#ifdef HAVE_PTHREAD_H
+/**
+ * Protects the free list, packets can be created and destroyed by events
+ * that are executed in parallel (see MultithreadedSimulatorImpl)
+ */
+static SystemMutex g_freeListMutex;
+#endif
+
 PacketMetadata::DataFreeList::~DataFreeList ()
 {
   NS_LOG_FUNCTION (this);
@@ -70,6 +82,13 @@ PacketMetadata::EnableChecking (void)
   m_enableChecking = true;
 }
 
+void
+PacketMetadata::DisableChecking (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_enableChecking = false;
+}
+
 void
 PacketMetadata::ReserveCopy (uint32_t size)
 {
@@ -582,6 +601,14 @@ struct PacketMetadata::Data *
 PacketMetadata::Create (uint32_t size)
 {
   NS_LOG_FUNCTION (size);
+  if (!m_enable)
+    {
+      // nothing is recycled when metadata is disabled
+      return PacketMetadata::Allocate (size);
+    }
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_freeListMutex);
+#endif
   NS_LOG_LOGIC ("create size="<<size<<", max="<<m_maxSize);
   if (size > m_maxSize)
     {
@@ -613,6 +640,9 @@ PacketMetadata::Recycle (struct PacketMetadata::Data *data)
       PacketMetadata::Deallocate (data);
       return;
     } 
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_freeListMutex);
+#endif
   NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<m_freeList.size ());
   NS_ASSERT (data->m_count == 0);
   if (m_freeList.size () > 1000 ||
@@ -662,6 +692,15 @@ PacketMetadata::CreateFragment (uint32_t start, uint32_t end) const
   return fragment;
 }
 
+PacketMetadata
+PacketMetadata::CreateFullCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  PacketMetadata copy = *this;
+  copy.ReserveCopy (0);
+  return copy;
+}
+
 void 
 PacketMetadata::AddHeader (const Header &header, uint32_t size)
 {
@@ -686,8 +725,7 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
   item.prev = 0xffff;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = __sync_fetch_and_add (&m_chunkUid, 1);
   uint16_t written = AddSmall (&item);
   UpdateHead (written);
 }
@@ -755,8 +793,7 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
   item.prev = m_tail;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = __sync_fetch_and_add (&m_chunkUid, 1);
   uint16_t written = AddSmall (&item);
   UpdateTail (written);
   NS_ASSERT (IsStateOk ());
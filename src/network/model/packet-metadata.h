@@ -127,6 +127,7 @@ private:
 
   static void Enable (void);
   static void EnableChecking (void);
+  static void DisableChecking (void);
 
   inline PacketMetadata (uint64_t uid, uint32_t size);
   inline PacketMetadata (PacketMetadata const &o);
@@ -147,6 +148,14 @@ private:
    * and then, RemoveAtEnd (end).
    */
   PacketMetadata CreateFragment (uint32_t start, uint32_t end) const;
+  /**
+   * \returns a copy of this metadata which does not share its buffer
+   *          with this metadata, and thus with any other packet.
+   *
+   * Unlike the copy constructor, the returned metadata can be handed over
+   * to another thread (see Packet::CreateFullCopy).
+   */
+  PacketMetadata CreateFullCopy (void) const;
   void AddAtEnd (PacketMetadata const&o);
   void AddPaddingAtEnd (uint32_t end);
   void RemoveAtStart (uint32_t start);
@@ -34,6 +34,75 @@ NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
 namespace ns3 {
 
+TypeId PacketTagList::m_inlineTypes[PacketTagList::INLINE_SLOTS];
+
+/**
+ * Tags stored inline are written into fixed-size slots, which would be
+ * overrun by larger tags, so the size is checked in optimized builds too.
+ */
+static void
+CheckInlineSize (const Tag &tag)
+{
+  if (tag.GetSerializedSize () > PacketTagList::INLINE_SIZE)
+    {
+      NS_FATAL_ERROR ("Tag " << tag.GetInstanceTypeId ().GetName () << " of " << tag.GetSerializedSize ()
+                      << " bytes does not fit into an inline slot of " << PacketTagList::INLINE_SIZE << " bytes");
+    }
+}
+
+bool
+PacketTagList::EnableInline (TypeId tid)
+{
+  NS_LOG_FUNCTION (tid);
+  for (uint32_t i = 0; i < INLINE_SLOTS; i++)
+    {
+      if (m_inlineTypes[i] == tid)
+        {
+          return true;
+        }
+      if (m_inlineTypes[i].GetUid () == 0)
+        {
+          NS_LOG_INFO ("storing " << tid << " in inline slot " << i);
+          m_inlineTypes[i] = tid;
+          return true;
+        }
+    }
+  NS_LOG_INFO ("no free inline slot for " << tid);
+  return false;
+}
+
+void
+PacketTagList::DisableInline (TypeId tid)
+{
+  NS_LOG_FUNCTION (tid);
+  int32_t slot = FindInline (tid);
+  if (slot >= 0)
+    {
+      NS_LOG_INFO ("releasing inline slot " << slot << " of " << tid);
+      m_inlineTypes[slot] = TypeId ();
+    }
+}
+
+TypeId
+PacketTagList::GetInlineTypeId (uint32_t slot)
+{
+  NS_ASSERT (slot < INLINE_SLOTS);
+  return m_inlineTypes[slot];
+}
+
+int32_t
+PacketTagList::FindInline (TypeId tid)
+{
+  for (uint32_t i = 0; i < INLINE_SLOTS; i++)
+    {
+      if (m_inlineTypes[i] == tid)
+        {
+          return i;
+        }
+    }
+  return -1;
+}
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -157,6 +226,14 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 bool
 PacketTagList::Remove (Tag & tag)
 {
+  int32_t slot = FindInline (tag.GetInstanceTypeId ());
+  if (slot >= 0 && (m_inlineUsed & (1 << slot)))
+    {
+      tag.Deserialize (TagBuffer (m_inlineData[slot],
+                                  m_inlineData[slot] + INLINE_SIZE));
+      m_inlineUsed &= ~(1 << slot);
+      return true;
+    }
   return COWTraverse (tag, &PacketTagList::RemoveWriter);
 }
 
@@ -196,6 +273,22 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
 bool
 PacketTagList::Replace (Tag & tag)
 {
+  int32_t slot = FindInline (tag.GetInstanceTypeId ());
+  if (slot >= 0)
+    {
+      bool found = (m_inlineUsed & (1 << slot)) != 0;
+      if (!found && COWTraverse (tag, &PacketTagList::ReplaceWriter))
+        {
+          // added to the tree before the type was stored inline
+          return true;
+        }
+      CheckInlineSize (tag);
+      tag.Serialize (TagBuffer (m_inlineData[slot],
+                                m_inlineData[slot] + tag.GetSerializedSize ()));
+      m_inlineUsed |= 1 << slot;
+      return found;
+    }
+
   bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
   if (!found)
     {
@@ -249,6 +342,17 @@ PacketTagList::Add (const Tag &tag) const
     {
       NS_ASSERT (cur->tid != tag.GetInstanceTypeId ());
     }
+  int32_t slot = FindInline (tag.GetInstanceTypeId ());
+  if (slot >= 0)
+    {
+      PacketTagList *self = const_cast<PacketTagList *> (this);
+      NS_ASSERT (!(m_inlineUsed & (1 << slot)));
+      CheckInlineSize (tag);
+      tag.Serialize (TagBuffer (self->m_inlineData[slot],
+                                self->m_inlineData[slot] + tag.GetSerializedSize ()));
+      self->m_inlineUsed |= 1 << slot;
+      return;
+    }
   struct TagData * head = new struct TagData ();
   head->count = 1;
   head->next = 0;
@@ -265,6 +369,13 @@ PacketTagList::Peek (Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
+  int32_t slot = FindInline (tid);
+  if (slot >= 0 && (m_inlineUsed & (1 << slot)))
+    {
+      tag.Deserialize (TagBuffer (const_cast<uint8_t *> (m_inlineData[slot]),
+                                  const_cast<uint8_t *> (m_inlineData[slot]) + INLINE_SIZE));
+      return true;
+    }
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
     {
       if (cur->tid == tid) 
@@ -278,6 +389,31 @@ PacketTagList::Peek (Tag &tag) const
   return false;
 }
 
+PacketTagList
+PacketTagList::CreateFullCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  PacketTagList copy;
+  copy.m_inlineUsed = m_inlineUsed;
+  if (m_inlineUsed != 0)
+    {
+      std::memcpy (copy.m_inlineData, m_inlineData, sizeof (m_inlineData));
+    }
+
+  struct TagData ** prevNext = &copy.m_next;
+  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+    {
+      struct TagData * data = new struct TagData ();
+      data->tid = cur->tid;
+      data->count = 1;
+      data->next = 0;
+      std::memcpy (data->data, cur->data, TagData::MAX_SIZE);
+      *prevNext = data;
+      prevNext = &data->next;
+    }
+  return copy;
+}
+
 const struct PacketTagList::TagData *
 PacketTagList::Head (void) const
 {
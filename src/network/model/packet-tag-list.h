@@ -26,6 +26,7 @@
 */
 
 #include <stdint.h>
+#include <cstring>
 #include <ostream>
 #include "ns3/type-id.h"
 
@@ -120,9 +121,21 @@ class Tag;
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
  *
+ * \par <b> Inline slots </b>
+ *
+ *   - A few frequently updated tag types (e.g., per-hop counters) can be
+ *     registered with #EnableInline.  Tags of these types are kept in a
+ *     small fixed array of slots stored by value in every PacketTagList
+ *     instead of the shared tree, so copying the list copies the slots and
+ *     #Add, #Remove and #Replace of these tags update the slot in place
+ *     without any allocation or copy-on-write.
+ *   - A tag of a registered type that was added to the tree before the type
+ *     was registered is still found in the tree.
+ *
  * \par <b> Memory Management: </b>
  * \n
  * Packet tags must serialize to a finite maximum size, see TagData
+ * (#INLINE_SIZE for tags stored in inline slots)
  *
  * This documentation entitles the original author to a free beer.
  */
@@ -167,6 +180,15 @@ public:
     uint32_t count;           /**< Number of incoming links */
   };  /* struct TagData */
 
+  /**
+   * \brief Inline slots
+   */
+  enum Inline_e
+  {
+    INLINE_SLOTS = 3,          /**< Number of tag types that can be stored inline */
+    INLINE_SIZE = 8            /**< Maximum serialized size of a tag stored inline */
+  };
+
   /**
    * Create a new PacketTagList.
    */
@@ -232,10 +254,55 @@ public:
    * Remove all tags from this list (up to the first merge).
    */
   inline void RemoveAll (void);
+  /**
+   * \returns a copy of the list that does not share tags with this list.
+   *
+   * Unlike the copy constructor, the returned list can be handed over to
+   * another thread.
+   */
+  PacketTagList CreateFullCopy (void) const;
   /**
    * \returns pointer to head of tag list
    */
   const struct PacketTagList::TagData *Head (void) const;
+  /**
+   * Find the tag stored in an inline slot.
+   *
+   * \param [in] slot Index of the inline slot, less than #INLINE_SLOTS.
+   * \returns Serialization buffer (#INLINE_SIZE bytes) of the tag stored in
+   *          the slot, or 0 if the slot is empty.
+   */
+  inline const uint8_t *GetInline (uint32_t slot) const;
+
+  /**
+   * Store tags of the given type in an inline slot of every PacketTagList.
+   *
+   * Should be called during the simulation setup.  Calling it again
+   * for the same type has no effect.
+   *
+   * \param [in] tid Type of the tag, which should serialize to at most
+   *          #INLINE_SIZE bytes.
+   * \returns True if the type is stored inline, false if all inline
+   *          slots are already taken by other types.
+   */
+  static bool EnableInline (TypeId tid);
+  /**
+   * Release the inline slot of the given type, so that tags of this type
+   * are stored in the shared list again and the slot can be given to
+   * another type.
+   *
+   * Must only be called when no packet holds a tag of this type in the
+   * inline slot (e.g., at the end of a test).
+   *
+   * \param [in] tid Type of the tag.
+   */
+  static void DisableInline (TypeId tid);
+  /**
+   * \param [in] slot Index of the inline slot, less than #INLINE_SLOTS.
+   * \returns Type of the tags stored in the slot (with zero uid if
+   *          the slot is not used).
+   */
+  static TypeId GetInlineTypeId (uint32_t slot);
 
 private:
   /**
@@ -286,10 +353,31 @@ private:
    */
   bool ReplaceWriter (Tag & tag, bool preMerge, struct TagData * cur, struct TagData ** prevNext);
 
+  /**
+   * Find the inline slot of the tag type.
+   *
+   * \param [in] tid Type of the tag.
+   * \returns Index of the inline slot, or -1 if the type is not stored inline.
+   */
+  static int32_t FindInline (TypeId tid);
+
   /**
    * Pointer to first #struct TagData on the list
    */
   struct TagData *m_next;
+  /**
+   * Serialization buffers of the tags stored inline
+   */
+  uint8_t m_inlineData[INLINE_SLOTS][INLINE_SIZE];
+  /**
+   * Bit mask of the used inline slots
+   */
+  uint8_t m_inlineUsed;
+
+  /**
+   * Types of the tags stored in the inline slots
+   */
+  static TypeId m_inlineTypes[INLINE_SLOTS];
 };
 
 } // namespace ns3
@@ -301,32 +389,46 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_next (),
+    m_inlineUsed (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_next (o.m_next),
+    m_inlineUsed (o.m_inlineUsed)
 {
   if (m_next != 0)
     {
       m_next->count++;
     }
+  if (m_inlineUsed != 0)
+    {
+      std::memcpy (m_inlineData, o.m_inlineData, sizeof (m_inlineData));
+    }
 }
 
 PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (this == &o)
     {
       return *this;
     }
-  RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  if (m_next != o.m_next)
     {
-      m_next->count++;
+      RemoveAll ();
+      m_next = o.m_next;
+      if (m_next != 0) 
+        {
+          m_next->count++;
+        }
+    }
+  m_inlineUsed = o.m_inlineUsed;
+  if (m_inlineUsed != 0)
+    {
+      std::memcpy (m_inlineData, o.m_inlineData, sizeof (m_inlineData));
     }
   return *this;
 }
@@ -358,6 +460,13 @@ PacketTagList::RemoveAll (void)
       delete prev;
     }
   m_next = 0;
+  m_inlineUsed = 0;
+}
+
+const uint8_t *
+PacketTagList::GetInline (uint32_t slot) const
+{
+  return (m_inlineUsed & (1 << slot)) ? m_inlineData[slot] : 0;
 }
 
 } // namespace ns3
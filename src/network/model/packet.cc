@@ -81,40 +81,61 @@ ByteTagIterator::ByteTagIterator (ByteTagList::Iterator i)
 }
 
 
-PacketTagIterator::PacketTagIterator (const struct PacketTagList::TagData *head)
-  : m_current (head)
+PacketTagIterator::PacketTagIterator (const PacketTagList &list)
+  : m_list (&list),
+    m_slot (0),
+    m_current (list.Head ())
 {
+  SkipUnusedInline ();
+}
+void
+PacketTagIterator::SkipUnusedInline (void)
+{
+  while (m_slot < PacketTagList::INLINE_SLOTS && m_list->GetInline (m_slot) == 0)
+    {
+      m_slot++;
+    }
 }
 bool
 PacketTagIterator::HasNext (void) const
 {
-  return m_current != 0;
+  return m_slot < PacketTagList::INLINE_SLOTS || m_current != 0;
 }
 PacketTagIterator::Item
 PacketTagIterator::Next (void)
 {
   NS_ASSERT (HasNext ());
+  if (m_slot < PacketTagList::INLINE_SLOTS)
+    {
+      uint32_t slot = m_slot++;
+      SkipUnusedInline ();
+      return PacketTagIterator::Item (PacketTagList::GetInlineTypeId (slot),
+                                      m_list->GetInline (slot),
+                                      PacketTagList::INLINE_SIZE);
+    }
   const struct PacketTagList::TagData *prev = m_current;
   m_current = m_current->next;
-  return PacketTagIterator::Item (prev);
+  return PacketTagIterator::Item (prev->tid, prev->data,
+                                  PacketTagList::TagData::MAX_SIZE);
 }
 
-PacketTagIterator::Item::Item (const struct PacketTagList::TagData *data)
-  : m_data (data)
+PacketTagIterator::Item::Item (TypeId tid, const uint8_t *data, uint32_t size)
+  : m_tid (tid),
+    m_data (data),
+    m_size (size)
 {
 }
 TypeId
 PacketTagIterator::Item::GetTypeId (void) const
 {
-  return m_data->tid;
+  return m_tid;
 }
 void
 PacketTagIterator::Item::GetTag (Tag &tag) const
 {
-  NS_ASSERT (tag.GetInstanceTypeId () == m_data->tid);
-  tag.Deserialize (TagBuffer ((uint8_t*)m_data->data,
-                              (uint8_t*)m_data->data
-                              + PacketTagList::TagData::MAX_SIZE));
+  NS_ASSERT (tag.GetInstanceTypeId () == m_tid);
+  tag.Deserialize (TagBuffer ((uint8_t*)m_data,
+                              (uint8_t*)m_data + m_size));
 }
 
 
@@ -127,6 +148,39 @@ Packet::Copy (void) const
   return Ptr<Packet> (new Packet (*this), false);
 }
 
+Ptr<Packet>
+Packet::CreateFullCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<Packet> copy = Copy ();
+
+  Buffer buffer;
+  if (m_buffer.GetSize () > 0)
+    {
+      buffer.AddAtStart (m_buffer.GetSize ());
+      buffer.Begin ().Write (m_buffer.Begin (), m_buffer.End ());
+    }
+  copy->m_buffer = buffer;
+
+  ByteTagList byteTagList;
+  byteTagList.Add (m_byteTagList);
+  byteTagList.AddAtStart (buffer.GetCurrentStartOffset () - m_buffer.GetCurrentStartOffset (),
+                          buffer.GetCurrentStartOffset ());
+  copy->m_byteTagList = byteTagList;
+
+  copy->m_packetTagList = m_packetTagList.CreateFullCopy ();
+  copy->m_metadata = m_metadata.CreateFullCopy ();
+  return copy;
+}
+
+uint32_t
+Packet::AllocateUid (void)
+{
+  // packets can be created by events that are executed in parallel
+  // (see MultithreadedSimulatorImpl)
+  return __sync_fetch_and_add (&m_globalUid, 1);
+}
+
 Packet::Packet ()
   : m_buffer (),
     m_byteTagList (),
@@ -137,10 +191,9 @@ Packet::Packet ()
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | AllocateUid (), 0),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 
 Packet::Packet (const Packet &o)
@@ -179,10 +232,9 @@ Packet::Packet (uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -205,10 +257,9 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
@@ -224,11 +275,10 @@ Packet::Packet (const std::string &buffer)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, buffer.size ()),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | AllocateUid (), buffer.size ()),
     m_nixVector (0)
 {
   NS_LOG_FUNCTION (this << &buffer);
-  m_globalUid++;
   m_buffer.AddAtStart (buffer.size ());
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (reinterpret_cast<const uint8_t*> (&buffer[0]), buffer.size ());
@@ -582,6 +632,27 @@ Packet::EnableChecking (void)
   PacketMetadata::EnableChecking ();
 }
 
+void
+Packet::DisableChecking (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  PacketMetadata::DisableChecking ();
+}
+
+bool
+Packet::EnableInlinePacketTag (TypeId tid)
+{
+  NS_LOG_FUNCTION (tid);
+  return PacketTagList::EnableInline (tid);
+}
+
+void
+Packet::DisableInlinePacketTag (TypeId tid)
+{
+  NS_LOG_FUNCTION (tid);
+  PacketTagList::DisableInline (tid);
+}
+
 uint32_t Packet::GetSerializedSize (void) const
 {
   uint32_t size = 0;
@@ -918,7 +989,7 @@ Packet::PrintPacketTags (std::ostream &os) const
 PacketTagIterator 
 Packet::GetPacketTagIterator (void) const
 {
-  return PacketTagIterator (m_packetTagList.Head ());
+  return PacketTagIterator (m_packetTagList);
 }
 
 std::ostream& operator<< (std::ostream& os, const Packet &packet)
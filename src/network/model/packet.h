@@ -134,8 +134,10 @@ public:
     void GetTag (Tag &tag) const;
 private:
     friend class PacketTagIterator;
-    Item (const struct PacketTagList::TagData *data);
-    const struct PacketTagList::TagData *m_data;
+    Item (TypeId tid, const uint8_t *data, uint32_t size);
+    TypeId m_tid;          //!< type of the tag
+    const uint8_t *m_data; //!< serialization buffer of the tag
+    uint32_t m_size;       //!< size of the serialization buffer
   };
   /**
    * \returns true if calling Next is safe, false otherwise.
@@ -147,8 +149,14 @@ private:
   Item Next (void);
 private:
   friend class Packet;
-  PacketTagIterator (const struct PacketTagList::TagData *head);
-  const struct PacketTagList::TagData *m_current;
+  PacketTagIterator (const PacketTagList &list);
+  /**
+   * Move to the next used inline slot (or past the last slot).
+   */
+  void SkipUnusedInline (void);
+  const PacketTagList *m_list;                    //!< list with the inline slots
+  uint32_t m_slot;                                //!< next inline slot to visit
+  const struct PacketTagList::TagData *m_current; //!< next tag in the tree
 };
 
 /**
@@ -392,6 +400,16 @@ public:
    */
   Ptr<Packet> Copy (void) const;
 
+  /**
+   * \returns a copy of the packet that does not share any datasets
+   * with the original packet.
+   *
+   * Unlike Copy, the returned packet can be handed over to another
+   * thread (see MultithreadedSimulatorImpl).  The copy keeps the uid
+   * of the original packet.
+   */
+  Ptr<Packet> CreateFullCopy (void) const;
+
   /**
    * A packet is allocated a new uid when it is created
    * empty or with zero-filled payload.
@@ -448,6 +466,32 @@ public:
    * errors will be detected and will abort the program.
    */
   static void EnableChecking (void);
+  /**
+   * Stop the sanity checks started by EnableChecking.  Packet
+   * metadata stays enabled, so checking can be enabled again later.
+   */
+  static void DisableChecking (void);
+  /**
+   * Packet tags of frequently added, updated and removed types (e.g.,
+   * per-hop counters) can be stored in a few fixed-size slots copied
+   * with the packet instead of the shared copy-on-write list of tags,
+   * so that AddPacketTag, ReplacePacketTag and RemovePacketTag of these
+   * tags never allocate memory.  You need to invoke this method during the
+   * simulation setup.
+   *
+   * \param tid type of the tag, which should serialize to at most
+   *        PacketTagList::INLINE_SIZE bytes
+   * \returns false if all slots are already taken by other types
+   */
+  static bool EnableInlinePacketTag (TypeId tid);
+  /**
+   * Store packet tags of this type in the shared list of tags again,
+   * releasing the slot taken by EnableInlinePacketTag.  No packet may
+   * hold a tag of this type when this method is invoked.
+   *
+   * \param tid type of the tag
+   */
+  static void DisableInlinePacketTag (TypeId tid);
 
   /**
    * \returns number of bytes required for packet
@@ -595,6 +639,8 @@ private:
 
   uint32_t Deserialize (uint8_t const*buffer, uint32_t size);
 
+  static uint32_t AllocateUid (void);
+
   Buffer m_buffer;
   ByteTagList m_byteTagList;
   PacketTagList m_packetTagList;
@@ -450,6 +450,53 @@ PacketTest::DoRun (void)
     CHECK (tmp, 1, E (20, 1, 1001));
 #endif
   }
+
+  {
+    // packet tags stored in inline slots
+    Packet p;
+    ATestTag<0> a (1);
+    p.AddPacketTag (a); // added before the type is stored inline
+    NS_TEST_EXPECT_MSG_EQ (Packet::EnableInlinePacketTag (ATestTag<0>::GetTypeId ()), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (p.PeekPacketTag (a), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (a.GetData (), 1, "trivial");
+    a.m_data = 2;
+    NS_TEST_EXPECT_MSG_EQ (p.ReplacePacketTag (a), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (p.RemovePacketTag (a), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (a.GetData (), 2, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (p.PeekPacketTag (a), false, "trivial");
+
+    a.m_data = 3;
+    p.AddPacketTag (a);
+    p.AddPacketTag (ATestTag<10> (4));
+    Packet copy = p;
+    a.m_data = 5;
+    NS_TEST_EXPECT_MSG_EQ (copy.ReplacePacketTag (a), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (p.PeekPacketTag (a), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (a.GetData (), 3, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (copy.PeekPacketTag (a), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (a.GetData (), 5, "trivial");
+
+    uint32_t n = 0;
+    PacketTagIterator i = copy.GetPacketTagIterator ();
+    while (i.HasNext ())
+      {
+        PacketTagIterator::Item item = i.Next ();
+        if (item.GetTypeId () == ATestTag<0>::GetTypeId ())
+          {
+            ATestTag<0> b;
+            item.GetTag (b);
+            NS_TEST_EXPECT_MSG_EQ (b.GetData (), 5, "trivial");
+          }
+        n++;
+      }
+    NS_TEST_EXPECT_MSG_EQ (n, 2, "trivial");
+
+    copy.RemoveAllPacketTags ();
+    NS_TEST_EXPECT_MSG_EQ (copy.PeekPacketTag (a), false, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (p.PeekPacketTag (a), true, "trivial");
+  }
+  // give the slot back, the slots are shared by all modules of the process
+  Packet::DisableInlinePacketTag (ATestTag<0>::GetTypeId ());
 }
 //--------------------------------------
 class PacketTagListTest : public TestCase
@@ -3,6 +3,11 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/uinteger.h"
+#include "ns3/data-rate.h"
+#include "ns3/packet-metadata.h"
 
 using namespace ns3;
 
@@ -56,6 +61,301 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 //-----------------------------------------------------------------------------
+class PointToPointMultithreadedTest : public TestCase
+{
+public:
+  PointToPointMultithreadedTest ();
+
+  virtual void DoRun (void);
+
+private:
+  void RunExchange (void);
+  void SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t size);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  Ptr<NetDevice> m_devB;
+  std::vector<Time> m_received;
+  std::vector<uint32_t> m_sizes;
+};
+
+PointToPointMultithreadedTest::PointToPointMultithreadedTest ()
+  : TestCase ("PointToPoint channel between partitions of MultithreadedSimulatorImpl")
+{
+}
+
+void
+PointToPointMultithreadedTest::SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t size)
+{
+  Ptr<Packet> p = Create<Packet> (size);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointMultithreadedTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  // each partition updates only the slot of its own node
+  uint32_t i = (device == m_devB) ? 1 : 0;
+  m_received[i] = Simulator::Now ();
+  m_sizes[i] += packet->GetSize ();
+  return true;
+}
+
+void
+PointToPointMultithreadedTest::RunExchange (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  // nodes connected with a zero-delay channel would be put into the same partition
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devA->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedTest::Receive, this));
+  devB->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedTest::Receive, this));
+
+  m_devB = devB;
+  m_received.assign (2, Seconds (0));
+  m_sizes.assign (2, 0);
+  Simulator::ScheduleWithContext (a->GetId (), Seconds (1.0), &PointToPointMultithreadedTest::SendOnePacket, this, devA, 100);
+  Simulator::ScheduleWithContext (a->GetId (), Seconds (1.0), &PointToPointMultithreadedTest::SendOnePacket, this, devA, 200);
+  Simulator::ScheduleWithContext (b->GetId (), Seconds (1.001), &PointToPointMultithreadedTest::SendOnePacket, this, devB, 300);
+  // stop requested by a node event, the later packet should not be sent
+  Simulator::ScheduleWithContext (b->GetId (), Seconds (2.0), &Simulator::Stop);
+  Simulator::ScheduleWithContext (a->GetId (), Seconds (3.0), &PointToPointMultithreadedTest::SendOnePacket, this, devA, 400);
+
+  Simulator::Run ();
+
+  Simulator::Destroy ();
+  m_devB = 0;
+}
+
+void
+PointToPointMultithreadedTest::DoRun (void)
+{
+  RunExchange ();
+  std::vector<Time> received = m_received;
+  std::vector<uint32_t> sizes = m_sizes;
+  NS_TEST_ASSERT_MSG_EQ (sizes[0], 300, "Packet from node 1 has not been received");
+  NS_TEST_ASSERT_MSG_EQ (sizes[1], 300, "Packets from node 0 have not been received");
+
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::MultithreadedSimulatorImpl");
+  factory.Set ("ThreadCount", UintegerValue (2));
+  Simulator::SetImplementation (factory.Create<SimulatorImpl> ());
+
+  RunExchange ();
+  NS_TEST_ASSERT_MSG_EQ (m_sizes[0], sizes[0], "Node 0 received different packets");
+  NS_TEST_ASSERT_MSG_EQ (m_sizes[1], sizes[1], "Node 1 received different packets");
+  NS_TEST_ASSERT_MSG_EQ (m_received[0], received[0], "Node 0 received the packet at different time");
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], received[1], "Node 1 received the packets at different time");
+}
+//-----------------------------------------------------------------------------
+class PointToPointMultithreadedMetadataTest : public TestCase
+{
+public:
+  PointToPointMultithreadedMetadataTest ();
+
+  virtual void DoRun (void);
+
+private:
+  void Send (Ptr<PointToPointNetDevice> device, uint32_t node, uint32_t count);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  Ptr<NetDevice> m_devB;
+  std::vector<uint64_t> m_sent[2];
+  std::vector<uint64_t> m_received[2];
+  uint32_t m_badMetadata[2];
+};
+
+PointToPointMultithreadedMetadataTest::PointToPointMultithreadedMetadataTest ()
+  : TestCase ("PointToPoint packets with metadata between partitions of MultithreadedSimulatorImpl")
+{
+  // metadata cannot be enabled after packets have been created
+  PacketMetadata::Enable ();
+}
+
+void
+PointToPointMultithreadedMetadataTest::Send (Ptr<PointToPointNetDevice> device, uint32_t node, uint32_t count)
+{
+  // the sender keeps its packet while the receiving partition destroys the copy
+  Ptr<Packet> p = Create<Packet> (100 + count % 100);
+  m_sent[node].push_back (p->GetUid ());
+  device->Send (p, device->GetBroadcast (), 0x800);
+  if (count > 1)
+    {
+      Simulator::Schedule (MicroSeconds (50), &PointToPointMultithreadedMetadataTest::Send, this, device, node, count - 1);
+    }
+}
+
+bool
+PointToPointMultithreadedMetadataTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  uint32_t i = (device == m_devB) ? 1 : 0;
+  m_received[i].push_back (packet->GetUid ());
+
+  // PPP header has been removed, only the payload is left
+  PacketMetadata::ItemIterator item = packet->BeginItem ();
+  if (!item.HasNext () || item.Next ().currentSize != packet->GetSize () || item.HasNext ())
+    {
+      m_badMetadata[i]++;
+    }
+  return true;
+}
+
+void
+PointToPointMultithreadedMetadataTest::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::MultithreadedSimulatorImpl");
+  factory.Set ("ThreadCount", UintegerValue (2));
+  Simulator::SetImplementation (factory.Create<SimulatorImpl> ());
+
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetAttribute ("DataRate", DataRateValue (DataRate ("100Mbps")));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+  devB->SetAttribute ("DataRate", DataRateValue (DataRate ("100Mbps")));
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devA->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedMetadataTest::Receive, this));
+  devB->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedMetadataTest::Receive, this));
+
+  m_devB = devB;
+  m_badMetadata[0] = m_badMetadata[1] = 0;
+  Simulator::ScheduleWithContext (a->GetId (), Seconds (1.0), &PointToPointMultithreadedMetadataTest::Send, this, devA, 0, 2000);
+  Simulator::ScheduleWithContext (b->GetId (), Seconds (1.0), &PointToPointMultithreadedMetadataTest::Send, this, devB, 1, 2000);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_devB = 0;
+
+  NS_TEST_ASSERT_MSG_EQ (m_received[1].size (), 2000, "Packets from node 0 have not been received");
+  NS_TEST_ASSERT_MSG_EQ (m_received[0].size (), 2000, "Packets from node 1 have not been received");
+  NS_TEST_EXPECT_MSG_EQ ((m_received[1] == m_sent[0]), true, "Node 1 received packets with different uids");
+  NS_TEST_EXPECT_MSG_EQ ((m_received[0] == m_sent[1]), true, "Node 0 received packets with different uids");
+  NS_TEST_EXPECT_MSG_EQ (m_badMetadata[0] + m_badMetadata[1], 0, "Received packets have broken metadata");
+}
+//-----------------------------------------------------------------------------
+class PointToPointMultithreadedEchoTest : public TestCase
+{
+public:
+  PointToPointMultithreadedEchoTest ();
+
+  virtual void DoRun (void);
+
+private:
+  void RunEcho (void);
+  void Send (Ptr<PointToPointNetDevice> device, uint32_t count);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  Ptr<NetDevice> m_devB;
+  std::vector<Time> m_echoed;
+};
+
+PointToPointMultithreadedEchoTest::PointToPointMultithreadedEchoTest ()
+  : TestCase ("PointToPoint echo from an idle partition of MultithreadedSimulatorImpl")
+{
+}
+
+void
+PointToPointMultithreadedEchoTest::Send (Ptr<PointToPointNetDevice> device, uint32_t count)
+{
+  device->Send (Create<Packet> (100), device->GetBroadcast (), 0x800);
+  if (count > 1)
+    {
+      Simulator::Schedule (MicroSeconds (50), &PointToPointMultithreadedEchoTest::Send, this, device, count - 1);
+    }
+}
+
+bool
+PointToPointMultithreadedEchoTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  if (device == m_devB)
+    {
+      // node B has no events of its own, it only sends the packet back
+      device->Send (packet->Copy (), device->GetBroadcast (), 0x800);
+    }
+  else
+    {
+      m_echoed.push_back (Simulator::Now ());
+    }
+  return true;
+}
+
+void
+PointToPointMultithreadedEchoTest::RunEcho (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetAttribute ("DataRate", DataRateValue (DataRate ("100Mbps")));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+  devB->SetAttribute ("DataRate", DataRateValue (DataRate ("100Mbps")));
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devA->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedEchoTest::Receive, this));
+  devB->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedEchoTest::Receive, this));
+
+  m_devB = devB;
+  m_echoed.clear ();
+  Simulator::ScheduleWithContext (a->GetId (), Seconds (1.0), &PointToPointMultithreadedEchoTest::Send, this, devA, 1000);
+  // the only event without context is far after the last echo
+  Simulator::Stop (Seconds (10.0));
+
+  Simulator::Run ();
+
+  Simulator::Destroy ();
+  m_devB = 0;
+}
+
+void
+PointToPointMultithreadedEchoTest::DoRun (void)
+{
+  RunEcho ();
+  std::vector<Time> echoed = m_echoed;
+  NS_TEST_ASSERT_MSG_EQ (echoed.size (), 1000, "Echoed packets have not been received");
+
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::MultithreadedSimulatorImpl");
+  factory.Set ("ThreadCount", UintegerValue (2));
+  Simulator::SetImplementation (factory.Create<SimulatorImpl> ());
+
+  RunEcho ();
+  NS_TEST_ASSERT_MSG_EQ (m_echoed.size (), echoed.size (), "Node 0 received different number of echoed packets");
+  NS_TEST_EXPECT_MSG_EQ ((m_echoed == echoed), true, "Node 0 received echoed packets at different times");
+}
+//-----------------------------------------------------------------------------
 class PointToPointTestSuite : public TestSuite
 {
 public:
@@ -66,6 +366,9 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointMultithreadedTest, TestCase::QUICK);
+  AddTestCase (new PointToPointMultithreadedMetadataTest, TestCase::QUICK);
+  AddTestCase (new PointToPointMultithreadedEchoTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite;